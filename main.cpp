@@ -7,6 +7,9 @@
 *
 * Dependencies: iostream, interval.h - For logging/printing purposes using std::cout
 *
+* Build with -DINTERVAL_PROFILE (and src/intervalProfile.cpp) for a report of the interval operations and the growth
+* of their widths, per INTERVAL_PROFILE_SITE(), printed to std::cerr at exit
+*
 * Copyright Daniel Marcovecchio
 * @author https://github.com/BlackHat0001
 */
@@ -16,11 +19,18 @@
 //
 // Copyright Daniel Marcovecchio
 //
-// Dependencies: iostream - For logging/printing purposes using std::cout, interval.h for use of interval methods
+// Dependencies: iostream - For logging/printing purposes using std::cout, vector, chrono - For timing the reductions,
+// cmath, interval.h for use of interval methods, intervalReductions.h for the array reductions,
+// intervalMatrix.h for the interval matrix products and linear system solver
 //----------
 
 #include <iostream>
+#include <vector>
+#include <chrono>
+#include <cmath>
 #include "interval.h"
+#include "intervalReductions.h"
+#include "intervalMatrix.h"
 
 /*
  * PROGRAM INPUT & OUTPUT TEST DATA
@@ -61,11 +71,26 @@ g=a+f result: 11 7
 
 h = f+a result:11 7
 
+sum by += result: -3912.43 4362.35
+time: 12.2522 ms
+intervalSum result: -3912.33 4362.1
+time: 10.0963 ms
+intervalDot result: 2.09715e+12 2.09716e+12
+
+intervalNorm result: 1.44815e+06 1.44816e+06
+
+system*system result[0][0]: 65535.1 65538.8
+time: 9.69797 ms
+solveIntervalSystem result x[0]: 0.00387618 0.0038957
+time: 18.015 ms
+
 */
 
 using namespace std;
 
 int main() {
+    INTERVAL_PROFILE_SITE();
+
     interval x(3.0,3.1); // Initialisation from complete data
     interval y(7); // Sensible (?) initialisation from a single float
 
@@ -108,5 +133,61 @@ int main() {
     interval h=f+a;
     cout << "h = f+a result:" << h << "\n";
 
+    // Reductions over a large array of intervals, the sequential operator+= loop against the parallel kernels
+    vector<interval> values(1 << 22);
+    for(size_t i = 0; i < values.size(); i++) {
+        float centre = (float) sin((double) i) * 1000.f;
+        values[i] = interval(centre - 0.001f, centre + 0.001f);
+    }
+
+    chrono::steady_clock::time_point begin = chrono::steady_clock::now();
+    interval total(0);
+    {
+        INTERVAL_PROFILE_SITE();
+        for(size_t i = 0; i < values.size(); i++) {
+            total += values[i];
+        }
+    }
+    double loopTime = chrono::duration<double, milli>(chrono::steady_clock::now() - begin).count();
+    cout << "sum by += result: " << total << "time: " << loopTime << " ms\n";
+
+    begin = chrono::steady_clock::now();
+    interval sum = intervalSum(values.data(), values.size());
+    double sumTime = chrono::duration<double, milli>(chrono::steady_clock::now() - begin).count();
+    cout << "intervalSum result: " << sum << "time: " << sumTime << " ms\n";
+
+    interval dot = intervalDot(values.data(), values.data(), values.size());
+    cout << "intervalDot result: " << dot << "\n";
+
+    interval norm = intervalNorm(values.data(), values.size());
+    cout << "intervalNorm result: " << norm << "\n";
+
+    // A system of interval linear equations, Ax = b, and the product of its matrix with itself
+    const size_t systemSize = 256;
+    intervalMatrix system(systemSize, systemSize);
+    vector<interval> rightHandSide;
+    for(size_t i = 0; i < systemSize; i++) {
+        for(size_t j = 0; j < systemSize; j++) {
+            float centre = i == j ? (float) systemSize : (float) sin((double) (i * systemSize + j));
+            system.set(i, j, interval(centre - 0.001f, centre + 0.001f));
+        }
+        rightHandSide.push_back(interval(1.f, 1.001f));
+    }
+
+    begin = chrono::steady_clock::now();
+    intervalMatrix squared = system * system;
+    double productTime = chrono::duration<double, milli>(chrono::steady_clock::now() - begin).count();
+    cout << "system*system result[0][0]: " << squared.get(0, 0) << "time: " << productTime << " ms\n";
+
+    vector<interval> solution;
+    begin = chrono::steady_clock::now();
+    bool solved = solveIntervalSystem(system, rightHandSide, solution);
+    double solveTime = chrono::duration<double, milli>(chrono::steady_clock::now() - begin).count();
+    if(solved) {
+        cout << "solveIntervalSystem result x[0]: " << solution[0] << "time: " << solveTime << " ms\n";
+    } else {
+        cout << "solveIntervalSystem could not verify an enclosure\n";
+    }
+
     return 0;
 }
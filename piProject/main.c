@@ -3,6 +3,11 @@
 #include <stdbool.h>
 #include <math.h>
 #include <time.h>
+#include <stdint.h>
+#include <string.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 /**
 * Function get_pi | Evaluates Pi using the Monte-Carlo method to an input accuracy
@@ -85,8 +90,558 @@ double get_pi(double accuracy) {
 }
 
 /**
-* Function main | Runs the test code in order to test the functionality of get_pi(double accuracy)
-* This code loops for an increasing step in accuracy (accuracy/=10.)
+* Function get_pi_digits | Evaluates Pi to a number of decimal places using the Chudnovsky series
+*
+* Method - The series is summed exactly by binary splitting on big integers, with Karatsuba multiplication for the
+* big products. Ranges of the series are split across threads when built with OpenMP. The final division and square
+* root use Newton's iteration, so the result is the same on every run and every machine
+*
+* Copyright Daniel Marcovecchio
+*
+* Dependencies stdio.h, stdlib.h, string.h, stdint.h, math.h (For the starting estimates), omp.h (optional)
+*
+* @author https://github.com/BlackHat0001
+*
+* @param digits value of type int. The number of decimal places to evaluate
+*
+* @returns piDigits value type char*. Pi written out as "3." and then digits decimal places, free after use
+*/
+char* get_pi_digits(int digits);
+
+/**
+* Function wallClockSeconds | Returns a wall clock time in seconds, for timing parallel code
+* Uses the OpenMP timer when built with OpenMP, as clock() sums the time of every thread
+*
+* Dependencies time.h, omp.h (optional)
+*
+* @author Daniel Marcovecchio
+*
+* @returns seconds value type double. Seconds since an arbitrary fixed point
+*/
+double wallClockSeconds();
+
+//------------- Big Number Arithmetic
+
+// Big numbers are stored in base one billion, so each 32 bit limb holds 9 decimal digits and printing needs no conversion
+#define BIG_NUMBER_BASE 1000000000u
+#define BIG_NUMBER_DIGITS_PER_LIMB 9
+
+// Products of numbers shorter than this many limbs use schoolbook multiplication, which is faster at small sizes
+#define KARATSUBA_THRESHOLD 32
+
+// Ranges of the Chudnovsky series with at least this many terms are split into tasks for other threads to take
+#define PARALLEL_SPLIT_TERMS 512
+
+// The number of decimal digits each term of the Chudnovsky series adds, log10(640320^3 / 1728)
+#define CHUDNOVSKY_DIGITS_PER_TERM 14.181647462725477
+
+/**
+* Struct BigNumber | A signed integer of any size
+*
+* @property limbs (uint32_t*) - The base one billion digits of the magnitude, least significant first
+* @property length (size_t) - The number of limbs in use, with no leading zero limbs. Zero has no limbs
+* @property negative (int) - 1 if the number is below zero
+*/
+typedef struct {
+    uint32_t* limbs;
+    size_t length;
+    int negative;
+} BigNumber;
+
+void bigNumberInit(BigNumber* number) {
+    number->limbs = NULL;
+    number->length = 0;
+    number->negative = 0;
+}
+
+void bigNumberFree(BigNumber* number) {
+    free(number->limbs);
+    bigNumberInit(number);
+}
+
+// Takes over the limbs array as the number's magnitude, dropping any leading zero limbs
+void bigNumberAdopt(BigNumber* number, uint32_t* limbs, size_t length, int negative) {
+    free(number->limbs);
+    while(length > 0 && limbs[length-1] == 0) {
+        length--;
+    }
+    number->limbs = limbs;
+    number->length = length;
+    number->negative = length > 0 ? negative : 0;
+}
+
+void bigNumberSet(BigNumber* number, uint64_t value) {
+    uint32_t* limbs = (uint32_t*) malloc(3 * sizeof(uint32_t));
+    for(int i = 0; i < 3; i++) {
+        limbs[i] = (uint32_t) (value % BIG_NUMBER_BASE);
+        value /= BIG_NUMBER_BASE;
+    }
+    bigNumberAdopt(number, limbs, 3, 0);
+}
+
+void bigNumberCopy(BigNumber* copy, const BigNumber* number) {
+    uint32_t* limbs = (uint32_t*) malloc((number->length + 1) * sizeof(uint32_t));
+    memcpy(limbs, number->limbs, number->length * sizeof(uint32_t));
+    bigNumberAdopt(copy, limbs, number->length, number->negative);
+}
+
+// Compares the magnitudes of two limb arrays with no leading zero limbs, returning -1, 0 or 1
+int compareLimbs(const uint32_t* a, size_t aLength, const uint32_t* b, size_t bLength) {
+    if(aLength != bLength) {
+        return aLength < bLength ? -1 : 1;
+    }
+    for(size_t i = aLength; i-- > 0;) {
+        if(a[i] != b[i]) {
+            return a[i] < b[i] ? -1 : 1;
+        }
+    }
+    return 0;
+}
+
+// a += b, where b has no more limbs than a and the sum fits in a's limbs
+void addLimbsInPlace(uint32_t* a, size_t aLength, const uint32_t* b, size_t bLength) {
+    uint32_t carry = 0;
+    size_t i = 0;
+    for(; i < bLength; i++) {
+        uint32_t sum = a[i] + b[i] + carry;
+        carry = sum >= BIG_NUMBER_BASE;
+        a[i] = carry ? sum - BIG_NUMBER_BASE : sum;
+    }
+    for(; carry && i < aLength; i++) {
+        uint32_t sum = a[i] + 1;
+        carry = sum >= BIG_NUMBER_BASE;
+        a[i] = carry ? 0 : sum;
+    }
+}
+
+// a -= b, where b has no more limbs than a and is no bigger than a
+void subtractLimbsInPlace(uint32_t* a, size_t aLength, const uint32_t* b, size_t bLength) {
+    uint32_t borrow = 0;
+    size_t i = 0;
+    for(; i < bLength; i++) {
+        uint32_t subtrahend = b[i] + borrow;
+        borrow = a[i] < subtrahend;
+        a[i] = borrow ? a[i] + BIG_NUMBER_BASE - subtrahend : a[i] - subtrahend;
+    }
+    for(; borrow && i < aLength; i++) {
+        borrow = a[i] == 0;
+        a[i] = borrow ? BIG_NUMBER_BASE - 1 : a[i] - 1;
+    }
+}
+
+// result = a * b, where result has aLength + bLength limbs
+void multiplyLimbsSchoolbook(uint32_t* result, const uint32_t* a, size_t aLength, const uint32_t* b, size_t bLength) {
+    memset(result, 0, (aLength + bLength) * sizeof(uint32_t));
+    for(size_t i = 0; i < aLength; i++) {
+        uint64_t carry = 0;
+        uint64_t ai = a[i];
+        for(size_t j = 0; j < bLength; j++) {
+            uint64_t current = result[i+j] + ai * b[j] + carry;
+            result[i+j] = (uint32_t) (current % BIG_NUMBER_BASE);
+            carry = current / BIG_NUMBER_BASE;
+        }
+        result[i+bLength] = (uint32_t) carry;
+    }
+}
+
+// result = a * b, where a and b both have length limbs and result has 2 * length limbs
+void multiplyLimbsKaratsuba(uint32_t* result, const uint32_t* a, const uint32_t* b, size_t length) {
+    if(length < KARATSUBA_THRESHOLD) {
+        multiplyLimbsSchoolbook(result, a, length, b, length);
+        return;
+    }
+
+    // Split each number into a low and a high half, a = a1 * B^low + a0
+    // Then a * b = a1b1 B^2low + ((a0 + a1)(b0 + b1) - a0b0 - a1b1) B^low + a0b0, three half size products instead of four
+    size_t low = length / 2, high = length - low;
+    multiplyLimbsKaratsuba(result, a, b, low);
+    multiplyLimbsKaratsuba(result + 2*low, a + low, b + low, high);
+
+    uint32_t* sumA = (uint32_t*) calloc(high + 1, sizeof(uint32_t));
+    uint32_t* sumB = (uint32_t*) calloc(high + 1, sizeof(uint32_t));
+    uint32_t* middle = (uint32_t*) malloc(2 * (high + 1) * sizeof(uint32_t));
+    memcpy(sumA, a + low, high * sizeof(uint32_t));
+    memcpy(sumB, b + low, high * sizeof(uint32_t));
+    addLimbsInPlace(sumA, high + 1, a, low);
+    addLimbsInPlace(sumB, high + 1, b, low);
+    multiplyLimbsKaratsuba(middle, sumA, sumB, high + 1);
+    subtractLimbsInPlace(middle, 2 * (high + 1), result, 2*low);
+    subtractLimbsInPlace(middle, 2 * (high + 1), result + 2*low, 2*high);
+
+    // The middle term is below B^(length+1), so its top limbs are zero past the end of the result
+    size_t middleLength = 2 * (high + 1);
+    while(middleLength > 0 && middle[middleLength-1] == 0) {
+        middleLength--;
+    }
+    addLimbsInPlace(result + low, 2*length - low, middle, middleLength);
+
+    free(sumA);
+    free(sumB);
+    free(middle);
+}
+
+// result = a * b, where result has aLength + bLength limbs. Numbers of different lengths are multiplied in pieces
+void multiplyLimbs(uint32_t* result, const uint32_t* a, size_t aLength, const uint32_t* b, size_t bLength) {
+    if(aLength < bLength) {
+        multiplyLimbs(result, b, bLength, a, aLength);
+        return;
+    }
+    if(bLength < KARATSUBA_THRESHOLD) {
+        multiplyLimbsSchoolbook(result, a, aLength, b, bLength);
+        return;
+    }
+    if(aLength == bLength) {
+        multiplyLimbsKaratsuba(result, a, b, aLength);
+        return;
+    }
+
+    // Multiply b by each bLength long piece of a, adding each product in at its place
+    memset(result, 0, (aLength + bLength) * sizeof(uint32_t));
+    uint32_t* piece = (uint32_t*) malloc(2 * bLength * sizeof(uint32_t));
+    for(size_t offset = 0; offset < aLength; offset += bLength) {
+        size_t pieceLength = aLength - offset < bLength ? aLength - offset : bLength;
+        multiplyLimbs(piece, a + offset, pieceLength, b, bLength);
+        addLimbsInPlace(result + offset, aLength + bLength - offset, piece, pieceLength + bLength);
+    }
+    free(piece);
+}
+
+// product = a * b. The product may be the same number as a or b
+void bigNumberMultiply(BigNumber* product, const BigNumber* a, const BigNumber* b) {
+    if(a->length == 0 || b->length == 0) {
+        bigNumberAdopt(product, NULL, 0, 0);
+        return;
+    }
+    uint32_t* limbs = (uint32_t*) malloc((a->length + b->length) * sizeof(uint32_t));
+    multiplyLimbs(limbs, a->limbs, a->length, b->limbs, b->length);
+    bigNumberAdopt(product, limbs, a->length + b->length, a->negative != b->negative);
+}
+
+// number *= factor, where factor is below one billion
+void bigNumberMultiplySmall(BigNumber* number, uint32_t factor) {
+    uint32_t* limbs = (uint32_t*) realloc(number->limbs, (number->length + 1) * sizeof(uint32_t));
+    uint64_t carry = 0;
+    for(size_t i = 0; i < number->length; i++) {
+        uint64_t current = (uint64_t) limbs[i] * factor + carry;
+        limbs[i] = (uint32_t) (current % BIG_NUMBER_BASE);
+        carry = current / BIG_NUMBER_BASE;
+    }
+    limbs[number->length] = (uint32_t) carry;
+    number->limbs = NULL;
+    bigNumberAdopt(number, limbs, number->length + 1, number->negative);
+}
+
+// number /= divisor, rounding the magnitude down, where divisor is below one billion
+void bigNumberDivideSmall(BigNumber* number, uint32_t divisor) {
+    uint64_t remainder = 0;
+    for(size_t i = number->length; i-- > 0;) {
+        uint64_t current = remainder * BIG_NUMBER_BASE + number->limbs[i];
+        number->limbs[i] = (uint32_t) (current / divisor);
+        remainder = current % divisor;
+    }
+    uint32_t* limbs = number->limbs;
+    number->limbs = NULL;
+    bigNumberAdopt(number, limbs, number->length, number->negative);
+}
+
+// sum = a + b. The sum may be the same number as a or b
+void bigNumberAdd(BigNumber* sum, const BigNumber* a, const BigNumber* b) {
+    size_t length = (a->length > b->length ? a->length : b->length) + 1;
+    uint32_t* limbs = (uint32_t*) calloc(length, sizeof(uint32_t));
+    int negative;
+    if(a->negative == b->negative) {
+        // Same signs add their magnitudes
+        memcpy(limbs, a->limbs, a->length * sizeof(uint32_t));
+        addLimbsInPlace(limbs, length, b->limbs, b->length);
+        negative = a->negative;
+    } else if(compareLimbs(a->limbs, a->length, b->limbs, b->length) >= 0) {
+        // Different signs take the smaller magnitude from the bigger, keeping the bigger one's sign
+        memcpy(limbs, a->limbs, a->length * sizeof(uint32_t));
+        subtractLimbsInPlace(limbs, length, b->limbs, b->length);
+        negative = a->negative;
+    } else {
+        memcpy(limbs, b->limbs, b->length * sizeof(uint32_t));
+        subtractLimbsInPlace(limbs, length, a->limbs, a->length);
+        negative = b->negative;
+    }
+    bigNumberAdopt(sum, limbs, length, negative);
+}
+
+// number *= B^places, or rounds the magnitude of number / B^-places down if places is negative
+void bigNumberShift(BigNumber* number, long places) {
+    if(places >= 0) {
+        uint32_t* limbs = (uint32_t*) calloc(number->length + places + 1, sizeof(uint32_t));
+        memcpy(limbs + places, number->limbs, number->length * sizeof(uint32_t));
+        bigNumberAdopt(number, limbs, number->length + places, number->negative);
+    } else if((size_t) -places >= number->length) {
+        bigNumberAdopt(number, NULL, 0, 0);
+    } else {
+        size_t length = number->length + places;
+        uint32_t* limbs = (uint32_t*) malloc((length + 1) * sizeof(uint32_t));
+        memcpy(limbs, number->limbs - places, length * sizeof(uint32_t));
+        bigNumberAdopt(number, limbs, length, number->negative);
+    }
+}
+
+// Sets number to its top limbs limbs, rounded down, the same as shifting it right by all but those limbs
+void bigNumberTopLimbs(BigNumber* top, const BigNumber* number, size_t limbs) {
+    bigNumberCopy(top, number);
+    if(number->length > limbs) {
+        bigNumberShift(top, -(long) (number->length - limbs));
+    }
+}
+
+// Sets number to B^places
+void bigNumberSetPower(BigNumber* number, size_t places) {
+    bigNumberSet(number, 1);
+    bigNumberShift(number, (long) places);
+}
+
+
+//------------- Chudnovsky Series
+
+/**
+* Function splitChudnovsky | Sums terms a to b-1 of the Chudnovsky series by binary splitting
+*
+* Each half of the range is summed on its own, and the two are joined with P = P1 P2, Q = Q1 Q2 and T = Q2 T1 + P1 T2,
+* so the big multiplications are of numbers of about the same size. Big ranges are split into tasks, so each half
+* and then the multiplications joining them can run on different threads
+*
+* Dependencies: stdlib.h, omp.h (optional)
+*
+* @author Daniel Marcovecchio
+*
+* @param a, b (long) - The range of terms to sum
+* @param p, q, t (BigNumber*) - Set to P, Q and T of the range
+* @param needP (int) - 0 if P is not wanted, which saves the biggest multiplication at the top of the tree
+*/
+void splitChudnovsky(long a, long b, BigNumber* p, BigNumber* q, BigNumber* t, int needP) {
+    if(b - a == 1) {
+        // A single term, P = (6a-5)(2a-1)(6a-1), Q = a^3 640320^3 / 24, T = (-1)^a P (13591409 + 545140134 a)
+        if(a == 0) {
+            bigNumberSet(p, 1);
+            bigNumberSet(q, 1);
+        } else {
+            bigNumberSet(p, (uint64_t) (6*a - 5));
+            bigNumberMultiplySmall(p, (uint32_t) (2*a - 1));
+            bigNumberMultiplySmall(p, (uint32_t) (6*a - 1));
+            bigNumberSet(q, 10939058860032000ULL);
+            bigNumberMultiplySmall(q, (uint32_t) a);
+            bigNumberMultiplySmall(q, (uint32_t) a);
+            bigNumberMultiplySmall(q, (uint32_t) a);
+        }
+        BigNumber linear;
+        bigNumberInit(&linear);
+        bigNumberSet(&linear, 13591409ULL + 545140134ULL * (uint64_t) a);
+        bigNumberMultiply(t, p, &linear);
+        t->negative = t->length > 0 && (a & 1);
+        bigNumberFree(&linear);
+        return;
+    }
+
+    long middle = (a + b) / 2;
+    BigNumber p1, q1, t1, p2, q2, t2;
+    bigNumberInit(&p1); bigNumberInit(&q1); bigNumberInit(&t1);
+    bigNumberInit(&p2); bigNumberInit(&q2); bigNumberInit(&t2);
+#ifdef _OPENMP
+    // Only read by the task pragmas, so serial builds leave it out
+    int parallel = b - a >= PARALLEL_SPLIT_TERMS;
+#endif
+
+    // The left half's P is always needed for T, the right half's only if this range's P is
+    #pragma omp task shared(p1, q1, t1) if(parallel)
+    splitChudnovsky(a, middle, &p1, &q1, &t1, 1);
+    splitChudnovsky(middle, b, &p2, &q2, &t2, needP);
+    #pragma omp taskwait
+
+    // Join the halves, each multiplication as its own task
+    BigNumber leftT, rightT;
+    bigNumberInit(&leftT);
+    bigNumberInit(&rightT);
+    #pragma omp task shared(leftT, q2, t1) if(parallel)
+    bigNumberMultiply(&leftT, &q2, &t1);
+    #pragma omp task shared(rightT, p1, t2) if(parallel)
+    bigNumberMultiply(&rightT, &p1, &t2);
+    #pragma omp task shared(q, q1, q2) if(parallel)
+    bigNumberMultiply(q, &q1, &q2);
+    if(needP) {
+        bigNumberMultiply(p, &p1, &p2);
+    }
+    #pragma omp taskwait
+    bigNumberAdd(t, &leftT, &rightT);
+
+    bigNumberFree(&p1); bigNumberFree(&q1); bigNumberFree(&t1);
+    bigNumberFree(&p2); bigNumberFree(&q2); bigNumberFree(&t2);
+    bigNumberFree(&leftT);
+    bigNumberFree(&rightT);
+}
+
+/**
+* Function newtonPrecisions | Lists the precisions, in limbs, that a Newton iteration should step through
+* Each step can at most double the precision, so the list halves back from the full precision to one the start is good to
+*
+* @author Daniel Marcovecchio
+*
+* @param fullPrecision (size_t) - The precision wanted at the end
+* @param startPrecision (size_t) - The precision of the starting estimate
+* @param precisions (size_t*) - Filled with the precisions to step through, lowest first, room for 64
+*
+* @returns count (int) - The number of precisions listed
+*/
+int newtonPrecisions(size_t fullPrecision, size_t startPrecision, size_t* precisions) {
+    int count = 0;
+    size_t precision = fullPrecision;
+    while(precision > startPrecision && count < 63) {
+        precisions[count++] = precision;
+        precision = precision / 2 + 1;
+    }
+    // Reverse into rising order, then one more step at full precision to settle the last limbs
+    for(int i = 0; i < count / 2; i++) {
+        size_t swap = precisions[i];
+        precisions[i] = precisions[count-1-i];
+        precisions[count-1-i] = swap;
+    }
+    precisions[count++] = fullPrecision;
+    return count;
+}
+
+/**
+* Function reciprocalSquareRoot | Works out B^precision / sqrt(value) by Newton's iteration
+* y' = y + y (1 - value y^2) / 2, using only multiplications, at a precision that doubles each step
+*
+* @author Daniel Marcovecchio
+*
+* @param result (BigNumber*) - Set to the reciprocal square root, scaled by B^precision
+* @param value (uint32_t) - The number to find the reciprocal square root of
+* @param precision (size_t) - The number of limbs after the point, at least 2
+*/
+void reciprocalSquareRoot(BigNumber* result, uint32_t value, size_t precision) {
+    // Start from the double estimate, good to about 15 digits, at a precision of 2 limbs
+    size_t precisions[64];
+    int steps = newtonPrecisions(precision, 2, precisions);
+    bigNumberSet(result, (uint64_t) (1e18 / sqrt((double) value)));
+    size_t current = 2;
+
+    BigNumber square, error, one, correction;
+    bigNumberInit(&square); bigNumberInit(&error); bigNumberInit(&one); bigNumberInit(&correction);
+    for(int s = 0; s < steps; s++) {
+        bigNumberShift(result, (long) (precisions[s] - current));
+        current = precisions[s];
+
+        // error = 1 - value y^2, then y += y error / 2
+        bigNumberMultiply(&square, result, result);
+        bigNumberShift(&square, -(long) current);
+        bigNumberMultiplySmall(&square, value);
+        square.negative = 1;
+        bigNumberSetPower(&one, current);
+        bigNumberAdd(&error, &one, &square);
+        bigNumberMultiply(&correction, result, &error);
+        bigNumberShift(&correction, -(long) current);
+        bigNumberDivideSmall(&correction, 2);
+        bigNumberAdd(result, result, &correction);
+    }
+    bigNumberFree(&square); bigNumberFree(&error); bigNumberFree(&one); bigNumberFree(&correction);
+}
+
+/**
+* Function reciprocal | Works out B^(2 precision) / top, where top is the first precision limbs of a number
+* Uses Newton's iteration z' = z + z (1 - top z), using only multiplications, at a precision that doubles each step
+*
+* @author Daniel Marcovecchio
+*
+* @param result (BigNumber*) - Set to the reciprocal
+* @param number (const BigNumber*) - The number to find the reciprocal of, which must be positive
+* @param precision (size_t) - The number of limbs of the number to use, at most its length
+*/
+void reciprocal(BigNumber* result, const BigNumber* number, size_t precision) {
+    // Start from the double estimate of the top two limbs, at a precision of 1 limb
+    size_t precisions[64];
+    int steps = newtonPrecisions(precision, 1, precisions);
+    double top = number->limbs[number->length-1] + (number->length > 1 ? number->limbs[number->length-2] / 1e9 : 0.0);
+    bigNumberSet(result, (uint64_t) (1e18 / top));
+    size_t current = 1;
+
+    BigNumber topLimbs, product, error, one, correction;
+    bigNumberInit(&topLimbs); bigNumberInit(&product); bigNumberInit(&error); bigNumberInit(&one); bigNumberInit(&correction);
+    for(int s = 0; s < steps; s++) {
+        bigNumberShift(result, (long) (precisions[s] - current));
+        current = precisions[s];
+
+        // error = 1 - top z, then z += z error
+        bigNumberTopLimbs(&topLimbs, number, current);
+        bigNumberMultiply(&product, &topLimbs, result);
+        product.negative = product.length > 0;
+        bigNumberSetPower(&one, 2 * current);
+        bigNumberAdd(&error, &one, &product);
+        bigNumberMultiply(&correction, result, &error);
+        bigNumberShift(&correction, -(long) (2 * current));
+        bigNumberAdd(result, result, &correction);
+    }
+    bigNumberFree(&topLimbs); bigNumberFree(&product); bigNumberFree(&error); bigNumberFree(&one); bigNumberFree(&correction);
+}
+
+char* get_pi_digits(int digits) {
+    // Function evaluates Pi to a number of decimal places with the Chudnovsky series
+    // pi = 426880 sqrt(10005) Q / T, where Q and T sum the series by binary splitting
+
+    if(digits < 1) {
+        digits = 1;
+    }
+    long terms = (long) (digits / CHUDNOVSKY_DIGITS_PER_TERM) + 2;
+    // Three guard limbs hold the rounding of the Newton iterations and the truncated products well clear of the digits
+    size_t precision = (size_t) digits / BIG_NUMBER_DIGITS_PER_LIMB + 3;
+
+    BigNumber p, q, t;
+    bigNumberInit(&p); bigNumberInit(&q); bigNumberInit(&t);
+    #pragma omp parallel
+    #pragma omp single
+    splitChudnovsky(0, terms, &p, &q, &t, 0);
+
+    // Only the first precision limbs of Q and T matter. Keep those, and how many limbs were dropped from each
+    size_t qLength = q.length < precision + 1 ? q.length : precision + 1;
+    size_t tLength = t.length < precision + 1 ? t.length : precision + 1;
+    long droppedFromQ = (long) (q.length - qLength), droppedFromT = (long) (t.length - tLength);
+    BigNumber inverseT, sqrtScaled, pi;
+    bigNumberInit(&inverseT); bigNumberInit(&sqrtScaled); bigNumberInit(&pi);
+    bigNumberShift(&q, -droppedFromQ);
+    reciprocal(&inverseT, &t, tLength);
+
+    // Q / T scaled by B^precision: Q' B^droppedFromQ * inverseT / (B^(2 tLength) B^droppedFromT)
+    bigNumberMultiply(&pi, &q, &inverseT);
+    bigNumberShift(&pi, (long) precision + droppedFromQ - 2 * (long) tLength - droppedFromT);
+
+    // sqrt(10005) = 10005 / sqrt(10005), then pi = 426880 sqrt(10005) Q / T
+    reciprocalSquareRoot(&sqrtScaled, 10005, precision);
+    bigNumberMultiplySmall(&sqrtScaled, 10005);
+    bigNumberMultiply(&pi, &pi, &sqrtScaled);
+    bigNumberShift(&pi, -(long) precision);
+    bigNumberMultiplySmall(&pi, 426880);
+
+    // Write the digits, the whole part then each limb after the point as 9 digits, and cut to the digits asked for
+    char* text = (char*) malloc(precision * BIG_NUMBER_DIGITS_PER_LIMB + 32);
+    int written = sprintf(text, "%u.", pi.length > precision ? pi.limbs[precision] : 0);
+    for(size_t i = precision; i-- > 0;) {
+        written += sprintf(text + written, "%09u", i < pi.length ? pi.limbs[i] : 0);
+    }
+    text[strchr(text, '.') - text + 1 + digits] = '\0';
+
+    bigNumberFree(&p); bigNumberFree(&q); bigNumberFree(&t);
+    bigNumberFree(&inverseT); bigNumberFree(&sqrtScaled); bigNumberFree(&pi);
+    return text;
+}
+
+double wallClockSeconds() {
+#ifdef _OPENMP
+    return omp_get_wtime();
+#else
+    return (double) clock()/CLOCKS_PER_SEC;
+#endif
+}
+
+/**
+* Function main | Runs the test code in order to test the functionality of get_pi(double accuracy) and get_pi_digits(int digits)
+* This code times get_pi_digits up to 100000 digits, then loops for an increasing step in accuracy (accuracy/=10.),
+* timing both methods side by side at each step
 *
 * CREDITS: Phil Sewell, Program: thePiProjectTaskASuggestedSolution.c - For the computation time calculation and formatting of the output data
 *
@@ -100,9 +655,21 @@ int main()
     // Function main to test the program
 
     printf(" --- The Pi Project --- \n");
-    printf("Monte-Carlo Implementation\n");
+    printf("Monte-Carlo and Chudnovsky Implementations\n");
     printf("-> Starting Program");
 
+    // The Chudnovsky series first on its own into thousands of digits, far past what the Monte-Carlo method can reach
+    // Only the start and end of each result are printed
+    for(int digits = 100; digits <= 100000; digits *= 10) {
+        double beginTime = wallClockSeconds();
+        char* piDigits = get_pi_digits(digits);
+        double computationTime = wallClockSeconds() - beginTime;
+
+        printf("\nThe Chudnovsky pi= %.32s...%s to %d places: Computation time=%3.4f seconds",
+               piDigits, piDigits + strlen(piDigits) - 10, digits, computationTime);
+        free(piDigits);
+    }
+
     // A for loop that steps the accuracy down by dividing by 10 each time
     // until we reach a desired accuracy of 1e-10. This allows us to test a range of accuracy values in get_pi
     for(double accuracy = 1; accuracy > 1e-10; accuracy /= 10.) {
@@ -123,6 +690,14 @@ int main()
         // Print the results with correct formatting
         printf("\nThe estimate of pi= %4.12f when the accuracy demand=%4.10f: Computation time=%3.4f seconds", pi, accuracy, computationTime);
         // --
+
+        // The Chudnovsky series to the same accuracy, the decimal places the accuracy demand asks for, side by side
+        int digits = (int) ceil(-log10(accuracy) - 1e-9);
+        double beginWallTime = wallClockSeconds();
+        char* piDigits = get_pi_digits(digits > 1 ? digits : 1);
+        computationTime = wallClockSeconds() - beginWallTime;
+        printf("\nThe Chudnovsky pi= %s when the accuracy demand=%4.10f: Computation time=%3.4f seconds", piDigits, accuracy, computationTime);
+        free(piDigits);
     }
 
     printf("-> Program Finished, Bye!");
@@ -6,6 +6,18 @@
 * Code is INCITS PL22.16 C++ compliant and is to be run under CodeBlocks / CLion
 *
 * Dependencies: iostream - For logging/printing purposes using std::cout
+*               cstdio, cstdarg - For formatting log messages into fixed size records
+*               vector, unordered_map - For the RadarDisplay icon registry
+*               algorithm, cmath, fstream, chrono, cstring - For rendering, writing frames and timing them
+*               queue - For the k-nearest search of the spatial index
+*               atomic, thread, memory - For the lock-free track update feed and the threads replaying into it,
+*                                        and the icon templates shared between Icons
+*               string, sstream - For reading icon template files
+*               new, sys/resource.h (unix only) - For counting heap allocations (with RADAR_COUNT_ALLOCATIONS) and
+*                                                 reading peak memory in the benchmark
+*               sys/mman.h, sys/stat.h, fcntl.h, unistd.h (unix only) - For memory mapping scene files. Elsewhere
+*                                                                       scene files are read into memory instead
+*               omp.h (optional) - Rendering is tiled across threads when built with OpenMP
 *
 * Copyright Daniel Marcovecchio
 * @author https://github.com/BlackHat0001
@@ -19,19 +31,111 @@
  All test data is pre-written in the main implementation of this program
 
  It would be worthwhile to test if the RadarDisplay can accept more than 100 Icons or not
+ It can, the registry grows as needed, and main adds 1000 icons to show this
+
+ Icon templates are loaded from iconTemplates.txt when it is in the working directory, adding to the built-in
+ plane, helicopter and spaceship templates
+
+ Messages are logged from a background thread. Build with -DRADAR_LOG_LEVEL=3 to compile out all but errors, or
+ with -DRADAR_LOG_LEVEL=0 to also trace skipped track updates
+
+ Run with --scene-test [icons] to save a scene to radarScene.bin, map it back in and restore it to a new display,
+ checking the restored display renders the same frame, default 1000000 icons
+
+ Rendering writes the test frame to radarDisplay.pgm, which any image viewer can open
+ Run with --render-test [icons] [frames] to time rendering of many moving icons, default 50000 icons for 600 frames
+ Run with --query-test [icons] to time range, rectangle and nearest icon queries, default 100000 icons
+ Run with --ingest-test [icons] [updates] [producers] to record a track feed to radarTracks.bin, then replay it into
+ a display from several threads at once, default 100000 icons, 10000000 updates and 4 producer threads
+ Run with --snapshot-test [icons] [readers] [frames] to publish frames while reader threads render and query them,
+ checking every frame a reader sees is whole, default 50000 icons, 3 readers and 300 frames
+ Run with --dirty-test [icons] [moving] [frames] to compare full renders against redrawing only the tiles changed by
+ a few moving icons, default 50000 icons with 100 moving for 300 frames
+ Run with --polar-test [returns] [bearing bits] to time converting sweeps of range and bearing radar returns into
+ display coordinates through bearing tables, checked against a sine and cosine per return and plotted to
+ radarReturns.pgm, default 4000000 returns with 16 bit bearings
+ Run with --collision-test [contacts] [frames] to time closest point of approach alerts between every pair of
+ contacts moving across a display, checked against a scan of every pair, default 100000 contacts for 60 frames
+ Run with --sweep-test [icons] [frames] to time the radar sweep and phosphor fade over a 1024x1024 scope, saving the
+ last frame to radarSweep.pgm, default 2000 moving icons for 600 frames
+ Run with --benchmark [max icons] to stress adding, removing and finding icons, track updates, spatial queries and
+ rendering at 1000 icons and every ten times more up to the maximum, default 1000000. It reports throughput, latency
+ percentiles and peak memory. Build with -DRADAR_COUNT_ALLOCATIONS for it to also report heap allocations per frame
 
  -------------------
 */
 
 //------ Includes
 #include <iostream>
+#include <cstdio>
+#include <cstdarg>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <chrono>
+#include <cstring>
+#include <cstdlib>
+#include <queue>
+#include <atomic>
+#include <thread>
+#include <memory>
+#include <string>
+#include <sstream>
+#include <new>
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 //------ Program Configs
-const unsigned int radarDisplayMaxIcons = 100;
 const unsigned int iconPixelsNumber = 16;
+// The highest brightness a pixel can have, which is also the maxval of the PGM frames written
+const unsigned int maxPixelBrightness = 20;
+// The width and height in pixels of the square tiles a frame is split into. Each tile is drawn by one thread
+const int renderTileSize = 64;
+// The smaller tiles used when only redrawing changed tiles, so a moving Icon only marks the area right around it
+const int dirtyTileSize = 16;
+// The lowest level of log message compiled in, 0 for trace up to 3 for errors only and 4 for none. Messages below
+// it are removed by the compiler along with the work of their arguments. Set with -DRADAR_LOG_LEVEL=n
+#ifndef RADAR_LOG_LEVEL
+#define RADAR_LOG_LEVEL 1
+#endif
+// Define RADAR_COUNT_ALLOCATIONS (-DRADAR_COUNT_ALLOCATIONS) to count every heap allocation for the benchmark. It
+// replaces the global operator new with one that updates shared counters, so it is left out of normal builds
 
 //------ Declarations
 
+/** Enum LogLevel
+ * LogLevel is how important a log message is, from tracing of hot paths up to errors
+ *
+ * @author Daniel Marcovecchio
+ */
+enum LogLevel { logTrace = 0, logInfo = 1, logWarning = 2, logError = 3 };
+
+/** Methods writeLogMessage, flushLog, getLogMessageCount and getDroppedLogMessages
+ * The logging layer. writeLogMessage formats a printf style message into a fixed size record and pushes it onto a
+ * lock-free queue, from which a background thread writes it to std::cout, so logging never waits on the stream
+ * If the queue is full the message is dropped and counted rather than blocking. Every message is counted by level
+ * flushLog waits until every message logged so far has been written, so console output that follows it is in order
+ * Log through the RADAR_LOG macro so messages below RADAR_LOG_LEVEL cost nothing
+ *
+ * @author Daniel Marcovecchio
+ */
+void writeLogMessage(LogLevel level, const char* format, ...);
+void flushLog();
+size_t getLogMessageCount(LogLevel level);
+size_t getDroppedLogMessages();
+
+#define RADAR_LOG(level, ...) do { if((level) >= RADAR_LOG_LEVEL) writeLogMessage((level), __VA_ARGS__); } while (0)
+
 /** Class Pixel
  * Pixel is a class to encapsulate data for each pixel used during rendering
  * @property xCoord and yCoord which are floats to store pixel x and y position
@@ -41,27 +145,256 @@ const unsigned int iconPixelsNumber = 16;
  */
 class Pixel;
 
+/** Struct IconTemplate
+ * IconTemplate is the shape of an Icon, its 16 pixels, stored once and shared by every Icon with that shape
+ * @property templateId the index of this template in its IconTemplateLibrary, or customTemplateId for a shape
+ * belonging to a single Icon
+ * @property name the name the template is found by in its library
+ * @property pixelXCoords, pixelYCoords and pixelBrightness which store the 16 pixels, one array per pixel field
+ *
+ * @author Daniel Marcovecchio
+ */
+struct IconTemplate;
+
+/** Class IconTemplateLibrary
+ * IconTemplateLibrary is a catalogue of named icon templates, built in code or loaded from a file
+ * Icons made from a library template share its pixels, so each contact on the display only stores its own ID,
+ * position and brightness, plus a pointer to the shape
+ *
+ * @property templates every template, indexed by templateId
+ * @property templateIdOfName the hash index from name to templateId
+ *
+ * @author Daniel Marcovecchio
+ */
+class IconTemplateLibrary;
+
+/** Method defaultIconTemplates
+ * defaultIconTemplates returns the library used by the init{Vehicle} methods, which starts with the built-in plane,
+ * helicopter and spaceship templates
+ *
+ * @return the default IconTemplateLibrary
+ *
+ * @author Daniel Marcovecchio
+ */
+IconTemplateLibrary& defaultIconTemplates();
+
 /** Class Icon
  * Icon is a class to represent each Icon on the display. Each icon is comprised of 16 Pixels (making up a 4x4 grid)
- * @property iconPixels which is a pointer to an array of Pixel objects
+ * @property shape which is the IconTemplate holding the 16 pixels, shared with other Icons of the same shape.
+ * Setting a pixel gives the Icon its own copy of the shape first, so other Icons never change with it
  * @property id unique integer identifier for this Icon
+ * @property xPosition and yPosition which place the Icon on the display. Pixel coords are relative to this position
+ * @property brightness which scales every pixel of the Icon, from 0 (not drawn) to 20 (drawn as set)
+ * @property lastUpdateTime which is the timestamp of the last track update applied to this Icon
  *
  * @author Daniel Marcovecchio
  */
 class Icon;
 
+/** Struct IconHandle
+ * IconHandle is a stable reference to an Icon added to a RadarDisplay, returned by addIcon
+ * It stays valid until that Icon is removed. After that its generation no longer matches, so it can never find
+ * a different Icon that has since been given the same slot
+ *
+ * @property slot the index of the slot in the RadarDisplay registry
+ * @property generation the number of times the slot had been reused when this handle was given out
+ *
+ * @author Daniel Marcovecchio
+ */
+struct IconHandle;
+
+/** Class SpatialGrid
+ * SpatialGrid is a uniform grid index over a set of points, for finding the points in a rectangle, within a range of
+ * a point, or nearest to a point without checking every one. Points are numbered by their index in the arrays it is
+ * built from, and the grid is rebuilt from scratch whenever they change, which takes linear time
+ *
+ * @property originX, originY, cellSize, columns and rows which place the grid cells over the points
+ * @property cellStart, entryPoint, entryX and entryY which list the points of every cell, one cell after another
+ *
+ * @author Daniel Marcovecchio
+ */
+class SpatialGrid;
+
+/** Struct TrackUpdate
+ * TrackUpdate is one report from the radar feed, giving the latest position and brightness of a contact
+ * It is also the record layout of track recording files, so it must stay 24 bytes with no padding changes
+ *
+ * @property id the ID of the Icon the update is for
+ * @property x and y the new position of the Icon
+ * @property brightness the new brightness of the Icon, 0 to 20
+ * @property timestamp the time the update was measured, in seconds. Older updates than one already applied are ignored
+ *
+ * @author Daniel Marcovecchio
+ */
+struct TrackUpdate;
+
+/** Class MpscRingBuffer
+ * MpscRingBuffer is a fixed size lock-free queue, which any number of threads can push to while one thread pops
+ * Each cell has a sequence number that says whether it is free to write or ready to read for the current lap of the
+ * ring, so producers only compete on one atomic counter and never wait on each other or the consumer
+ *
+ * @property cells the ring of cells, a power of two long
+ * @property enqueuePosition and dequeuePosition the total number of items pushed and popped, kept on separate cache lines
+ *
+ * @author Daniel Marcovecchio
+ */
+template <typename T>
+class MpscRingBuffer;
+
 /** Class RadarDisplay
  * RadarDisplay is a class for managing the display of many Icons
- * It has a pointer to an array of Icons currently used on the display
+ * Active Icons are kept in a dense array with no gaps for fast iteration, with a slot table giving stable handles
+ * and a hash index from Icon ID to slot, so adding, removing and finding an Icon are all constant time
  * Also has multiple functions for the adding and removing of Icons on the Display
  *
- * @property radarIcons which is a pointer to an array of Icon objects
- * @property numberOfActiveIcons the number of active icons on the display right now
+ * @property radarIcons which is the dense array of pointers to the active Icon objects
+ * @property iconSlots, freeSlots and slotOfIconId which make up the registry for handles and ID lookup
+ * @property spatialIndex which is a SpatialGrid over the Icon positions, for finding Icons by where they are
+ * @property changedSlots which lists the slots whose Icon was added, removed, moved or changed since the last render,
+ * so the renderer only redraws the tiles those Icons were and are on
  *
  * @author Daniel Marcovecchio
  */
 class RadarDisplay;
 
+/** Structs RadarSceneHeader, SceneTemplateRecord and SceneIconRecord
+ * The layout of a scene file, which saves every Icon of a display and the shapes they use
+ * A scene file is a RadarSceneHeader, then the templates, then the Icons, each table starting on an 8 byte boundary
+ * Every record is a fixed size with no pointers, so a mapped file is used as it is, with nothing to parse
+ * Numbers are in the byte order of the machine, which is little endian on our targets
+ *
+ * @property RadarSceneHeader the 4 bytes RSCN, a format version, and the count and file offset of each table
+ * @property SceneTemplateRecord one shape, its template ID, name and 16 pixels
+ * @property SceneIconRecord one Icon, its ID, position, brightness, last update time and the index of its shape
+ *
+ * @author Daniel Marcovecchio
+ */
+struct RadarSceneHeader;
+struct SceneTemplateRecord;
+struct SceneIconRecord;
+
+/** Class MappedRadarScene
+ * MappedRadarScene opens a scene file by mapping it into memory, so it is ready as soon as the header is checked
+ * however many Icons it holds. The records are read straight from the mapping, and restore builds a RadarDisplay
+ * from them for a warm start
+ *
+ * @property data and size the mapped file
+ * @property header, templateRecords and iconRecords which point into the mapping
+ *
+ * @author Daniel Marcovecchio
+ */
+class MappedRadarScene;
+
+/** Class RadarSnapshot
+ * RadarSnapshot is an immutable copy of a RadarDisplay at one frame, with its own spatial index, for threads that
+ * render or query the display while the display thread carries on applying updates
+ *
+ * @property icons the copies of every active Icon, in the display's dense array order
+ * @property spatialIndex the SpatialGrid over the Icon positions
+ * @property frameNumber the number of the frame this snapshot is, counting up from 1 with each publish
+ *
+ * @author Daniel Marcovecchio
+ */
+class RadarSnapshot;
+
+/** Class RadarSnapshotBuffer
+ * RadarSnapshotBuffer publishes snapshots from the display thread to any number of reader threads without locks
+ * It holds a few snapshot buffers (three by default), each with a count of the readers using it. Readers take the
+ * current one, and the display thread only writes to buffers no reader holds, then makes it current with one atomic store
+ *
+ * @property slots the snapshot buffers and their reader counts
+ * @property currentSlot the index of the buffer readers should take
+ *
+ * @author Daniel Marcovecchio
+ */
+class RadarSnapshotBuffer;
+
+/** Class RadarFramebuffer
+ * RadarFramebuffer is an image of the display, holding one brightness value in range 0 to 20 per screen pixel
+ * @property width and height which are the size of the frame in pixels
+ * @property brightness which stores every pixel row by row, width * height bytes
+ *
+ * @author Daniel Marcovecchio
+ */
+class RadarFramebuffer;
+
+/** Class RadarScope
+ * RadarScope turns rendered frames into what a radar operator sees. A beam sweeps round the centre of the scope, and
+ * only shows the contacts under it as it passes. What it shows then fades like the phosphor of a real radar screen,
+ * so moving contacts leave fading trails behind them
+ *
+ * @property persistence the glow of every screen pixel, 0 to 255, row by row
+ * @property pixelAngles the bearing of every screen pixel from the centre, as a fraction of a turn in 16 bits
+ * @property sweepAngle the bearing the beam has reached, in the same units
+ * @property sweepPeriod and persistenceHalfLife the seconds per turn of the beam, and for a glow to fade to half
+ *
+ * @author Daniel Marcovecchio
+ */
+class RadarScope;
+
+/** Class RadarReturnConverter
+ * RadarReturnConverter turns radar returns, each a range and a bearing from the radar, into display coordinates with
+ * the radar at the centre of the display. Radars report bearings at a fixed angular resolution, so the sine and
+ * cosine of every bearing are worked out once into tables, and converting a return is two table reads and two
+ * multiply-adds. Whole sweeps are converted at once, split between threads and vectorised within each
+ *
+ * @property bearingBits the angular resolution of the tables, 2^bearingBits bearings per turn
+ * @property centreX, centreY and pixelsPerMetre which place and scale returns on the display
+ * @property eastTable and southTable the screen x and y offsets of a return one metre away at every bearing
+ *
+ * @author Daniel Marcovecchio
+ */
+class RadarReturnConverter;
+
+/** Class RadarRenderer
+ * RadarRenderer draws every active Icon of a RadarDisplay or RadarSnapshot into a RadarFramebuffer
+ * Icons are first sorted into the tiles they overlap, then the tiles are cleared and drawn in parallel,
+ * so no two threads ever write the same screen pixel. Where pixels of Icons overlap the brightest one is kept
+ * It can also keep a frame of a RadarDisplay up to date by redrawing only the tiles its changed Icons touch
+ *
+ * @property iconTileBounds, tileIconStart, tileIcons and tileFill which are the per-frame tile lists, kept to reuse their memory
+ * @property slotScreenIcons, slotTileBounds and tileDirty which remember the last frame drawn by renderChangedTiles
+ *
+ * @author Daniel Marcovecchio
+ */
+class RadarRenderer;
+
+/** Struct CollisionAlert
+ * CollisionAlert is a warning that two contacts will pass closer than the alert distance within the look-ahead time
+ * @property firstId and secondId the IDs of the two Icons, firstId the lower
+ * @property closestDistance the distance between them at their closest point of approach (CPA)
+ * @property timeToClosest the seconds until the CPA (TCPA), 0 if they are already getting further apart
+ * @property isNew which is true on the first frame the pair is alerted, so alerts can be raised once as events
+ *
+ * @author Daniel Marcovecchio
+ */
+struct CollisionAlert;
+
+/** Class CollisionMonitor
+ * CollisionMonitor checks every pair of contacts on a RadarDisplay for a close approach, once per frame
+ * The velocity of each contact is worked out from how far it moved between frames. Each contact stays within half
+ * its travel in the look-ahead time of the middle of its path, so another contact can only come within the alert
+ * distance of it if the middle of its path is within the alert distance plus that half travel of the other's path.
+ * Contacts are split into speed classes, each reaching twice as far as the one before, with a SpatialGrid over the
+ * middles of their paths whose cells are as wide as two contacts of the class can be apart and still alert. Pairs in
+ * one class are then found by checking each cell against itself and its neighbours to the right and below, which are
+ * runs of contacts stored in cell order. A pair of different speeds is found by the faster one, searching each slower
+ * class along its own path only as wide as the furthest reach in that class, so a few fast contacts do not widen the
+ * search of every slow one. Alerts are radix sorted, by pair to tell the new ones and then soonest first. On one core
+ * a frame of 100000 contacts still takes a few tens of milliseconds, not a few; rows of cells and fast contacts are
+ * split between threads where OpenMP is available
+ *
+ * @property alertDistance and lookAhead which set how close and how soon a pair must pass to be alerted
+ * @property coastTime the seconds a contact that has stopped reporting new positions keeps its last velocity for
+ * @property slotTracks the last position, velocity and time each display slot was seen to move
+ * @property speedClasses the contacts of each speed class, with the SpatialGrid over the middles of their paths and
+ * copies of them in cell order
+ * @property alertedPairs the pairs alerted last frame, to tell which alerts are new
+ *
+ * @author Daniel Marcovecchio
+ */
+class CollisionMonitor;
+
 /** Method initialiseAsDefaultDiagonalLine
  * initialiseAsDefaultDiagonalLine is a method to populate an Icon with the pixel data for a diagonal line
  *
@@ -108,10 +441,10 @@ class Pixel {
 
             // Display respective error/warning messages if supplied values were out of range
             if(xCoord < 0 || yCoord < 0) {
-                std::cout << "Error in Pixel Constructor: X or Y coord was less than zero, value defaulted to zero\n";
+                RADAR_LOG(logError, "Error in Pixel Constructor: X or Y coord was less than zero, value defaulted to zero");
             } 
             if(brightness < 0 || brightness > 20) {
-                std::cout << "Error in Pixel Constructor: brightness param was out of range 0<=brightness<=20, value was defaulted to zero\n";
+                RADAR_LOG(logError, "Error in Pixel Constructor: brightness param was out of range 0<=brightness<=20, value was defaulted to zero");
             }
         }
         // Here we define the constructor to default behaviour operation as we don't have any memory we need to free up
@@ -129,26 +462,222 @@ class Pixel {
 void Pixel::showPixelDetail() const {
     // Here is the implementation of the showPixelDetail function, to display current pixel data
 
-    // Simply we output the xCoord, yCoord and brightness in a reasonable format
+    // Simply we output the xCoord, yCoord and brightness in a reasonable format, after any messages logged before
+    flushLog();
     std::cout << "Pixel Detail: (x: " << xCoord << ", y: " << yCoord << ", brightness: " << brightness << ")\n";
 }
 
+struct IconTemplate {
+    // Template struct holding the pixels of one icon shape. Public, as Icons and the renderer read the lanes directly
+
+    // The templateId of shapes that belong to a single Icon rather than a library
+    static const unsigned int customTemplateId = 0xFFFFFFFFu;
+
+    unsigned int templateId;
+    std::string name;
+    float pixelXCoords[iconPixelsNumber];
+    float pixelYCoords[iconPixelsNumber];
+    // Brightness is in range 0 to 20, so a byte per pixel is plenty
+    unsigned char pixelBrightness[iconPixelsNumber];
+
+    // Constructor, making an empty shape of 16 dark pixels at (0, 0)
+    IconTemplate(unsigned int templateId, const std::string& name) : templateId(templateId), name(name), pixelXCoords(),
+                                                                     pixelYCoords(), pixelBrightness() {}
+};
+
+class IconTemplateLibrary {
+    // Template library class, owning every template it has made. Templates are never changed once added
+
+    private:
+        std::vector<std::shared_ptr<const IconTemplate>> templates;
+        std::unordered_map<std::string, unsigned int> templateIdOfName;
+
+    public:
+        IconTemplateLibrary() = default;
+        ~IconTemplateLibrary() = default;
+
+        /** Method addTemplate
+         * Method to add a template made of up to 16 pixels, any not given being dark
+         * A template with the same name is replaced, keeping its templateId. Icons already using the old one keep it
+         *
+         * @param name the name to find the template by
+         * @param pixels the pixels of the shape, already checked by the Pixel constructor
+         *
+         * @return the new template, or nullptr if there are more than 16 pixels
+         *
+         * @author Daniel Marcovecchio
+         */
+        std::shared_ptr<const IconTemplate> addTemplate(const std::string& name, const std::vector<Pixel>& pixels);
+
+        /** Methods findTemplate and getTemplate
+         * Methods to look up a template by its name, or its templateId
+         *
+         * @return the template, or nullptr if there is no such template
+         *
+         * @author Daniel Marcovecchio
+         */
+        std::shared_ptr<const IconTemplate> findTemplate(const std::string& name) const;
+        std::shared_ptr<const IconTemplate> getTemplate(unsigned int templateId) const;
+
+        size_t getNumberOfTemplates() const { return templates.size(); }
+
+        /** Method loadFromFile
+         * Method to add every template in a text file. A line "template <name>" starts a template, and each
+         * "x y brightness" line after it adds a pixel to it. Blank lines and lines starting with # are skipped
+         *
+         * @param path the file to read
+         *
+         * @return true if the whole file was read, false if it is missing or a line is malformed. Templates before
+         * a malformed line are still added
+         *
+         * @author Daniel Marcovecchio
+         */
+        bool loadFromFile(const char* path);
+};
+
+std::shared_ptr<const IconTemplate> IconTemplateLibrary::addTemplate(const std::string& name, const std::vector<Pixel>& pixels) {
+    // Implementation of addTemplate
+
+    if(pixels.size() > iconPixelsNumber) {
+        RADAR_LOG(logError, "Error in addTemplate in IconTemplateLibrary: template %s has more than %u pixels", name.c_str(), iconPixelsNumber);
+        return nullptr;
+    }
+    auto found = templateIdOfName.find(name);
+    unsigned int templateId = found != templateIdOfName.end() ? found->second : (unsigned int) templates.size();
+
+    // Made as a non-const IconTemplate, which is what allows an Icon left as its only owner to edit it in place
+    std::shared_ptr<IconTemplate> shape = std::make_shared<IconTemplate>(templateId, name);
+    for (size_t i = 0; i < pixels.size(); i++) {
+        shape->pixelXCoords[i] = pixels[i].xCoord;
+        shape->pixelYCoords[i] = pixels[i].yCoord;
+        shape->pixelBrightness[i] = (unsigned char) pixels[i].brightness;
+    }
+    if(templateId == templates.size()) {
+        templates.push_back(shape);
+        templateIdOfName[name] = templateId;
+    } else {
+        templates[templateId] = shape;
+    }
+    return shape;
+}
+
+std::shared_ptr<const IconTemplate> IconTemplateLibrary::findTemplate(const std::string& name) const {
+    auto found = templateIdOfName.find(name);
+    return found != templateIdOfName.end() ? templates[found->second] : nullptr;
+}
+
+std::shared_ptr<const IconTemplate> IconTemplateLibrary::getTemplate(unsigned int templateId) const {
+    return templateId < templates.size() ? templates[templateId] : nullptr;
+}
+
+bool IconTemplateLibrary::loadFromFile(const char* path) {
+    // Implementation of loadFromFile, collecting the pixels of each template then adding it when the next one starts
+
+    std::ifstream file(path);
+    if(!file) {
+        RADAR_LOG(logError, "Error in loadFromFile in IconTemplateLibrary: could not open %s", path);
+        return false;
+    }
+    std::string line, name;
+    std::vector<Pixel> pixels;
+    int lineNumber = 0;
+    while (std::getline(file, line)) {
+        lineNumber++;
+        std::istringstream fields(line);
+        std::string first;
+        if(!(fields >> first) || first[0] == '#') {
+            continue;
+        }
+        if(first == "template") {
+            if(!name.empty()) {
+                addTemplate(name, pixels);
+            }
+            pixels.clear();
+            if(!(fields >> name)) {
+                RADAR_LOG(logError, "Error in loadFromFile in IconTemplateLibrary: template with no name at line %d", lineNumber);
+                return false;
+            }
+            continue;
+        }
+        float x, y;
+        int brightness;
+        std::istringstream pixelFields(line);
+        if(name.empty() || !(pixelFields >> x >> y >> brightness)) {
+            RADAR_LOG(logError, "Error in loadFromFile in IconTemplateLibrary: expected \"x y brightness\" of a template at line %d", lineNumber);
+            return false;
+        }
+        // The Pixel constructor checks the values, the same as for pixels set in code
+        pixels.push_back(Pixel(x, y, brightness));
+    }
+    if(!name.empty()) {
+        addTemplate(name, pixels);
+    }
+    return true;
+}
+
+IconTemplateLibrary& defaultIconTemplates() {
+    // The library is made on first use, with the built-in templates each as rows of "x, y, brightness"
+    static IconTemplateLibrary library;
+    static bool builtInTemplatesAdded = false;
+    if(!builtInTemplatesAdded) {
+        builtInTemplatesAdded = true;
+        const float plane[iconPixelsNumber][3] = {
+            {3, 0, 20}, {3, 1, 20}, {3, 2, 20}, {3, 3, 20}, {3, 4, 20}, {3, 5, 20}, {3, 6, 20}, {3, 7, 10},
+            {0, 3, 15}, {1, 3, 15}, {2, 3, 15}, {4, 3, 15}, {5, 3, 15}, {6, 3, 15}, {2, 6, 12}, {4, 6, 12}};
+        const float helicopter[iconPixelsNumber][3] = {
+            {0, 0, 10}, {1, 0, 10}, {2, 0, 10}, {3, 0, 10}, {4, 0, 10}, {5, 0, 10}, {6, 0, 10}, {3, 1, 15},
+            {2, 2, 20}, {3, 2, 20}, {4, 2, 20}, {2, 3, 20}, {3, 3, 20}, {4, 3, 20}, {5, 3, 15}, {6, 3, 15}};
+        const float spaceship[iconPixelsNumber][3] = {
+            {2, 0, 20}, {3, 0, 20}, {1, 1, 15}, {2, 1, 15}, {3, 1, 15}, {4, 1, 15}, {0, 2, 20}, {1, 2, 20},
+            {2, 2, 20}, {3, 2, 20}, {4, 2, 20}, {5, 2, 20}, {1, 3, 10}, {2, 3, 5}, {3, 3, 5}, {4, 3, 10}};
+        const char* names[3] = {"plane", "helicopter", "spaceship"};
+        const float (*shapes[3])[3] = {plane, helicopter, spaceship};
+        for (int t = 0; t < 3; t++) {
+            std::vector<Pixel> pixels;
+            for (unsigned int i = 0; i < iconPixelsNumber; i++) {
+                pixels.push_back(Pixel(shapes[t][i][0], shapes[t][i][1], (int) shapes[t][i][2]));
+            }
+            library.addTemplate(names[t], pixels);
+        }
+    }
+    return library;
+}
+
+/** Method emptyIconTemplate
+ * emptyIconTemplate returns the shape of 16 dark pixels every new Icon starts with, shared by all of them
+ *
+ * @author Daniel Marcovecchio
+ */
+const std::shared_ptr<const IconTemplate>& emptyIconTemplate() {
+    static const std::shared_ptr<const IconTemplate> empty = std::make_shared<const IconTemplate>(IconTemplate(IconTemplate::customTemplateId, "empty"));
+    return empty;
+}
+
 class Icon {
     //Class Icon to contain pixel data about an icon/image to be used on the display
 
     // Here is the private data
     private:
-        // Here I define iconPixels as a pointer to a Pixel Array
-        // This is specified as private as it is not necessary to have other parts of the program access this variable,
-        // as I have instead used various setter and getter methods to directly control this.
-        // This private implementation is future proofed and robust
-        Pixel* iconPixels[iconPixelsNumber];
+        // Here I define the pixel data of this icon, as a shared IconTemplate rather than pixels stored in every Icon.
+        // Contacts of the same type share one shape, so each Icon is only its ID, position, brightness and this pointer,
+        // and code that walks every pixel (e.g. rendering) reads the same few shapes over and over from cache
+        // This is specified as private as the setter and getter methods validate and control access to it
+        std::shared_ptr<const IconTemplate> shape;
 
     // Here is the public data for this class
     public:
         // Definition of id, the integer identifier for each Icon object instance.
         // This is public so can be easily edited and accessed by other areas of the program, as intended
         int id;
+        // The position of this Icon on the display, which every pixel coord is offset by when rendering
+        // Public for the same reason as id, moving an Icon is just writing these. They may be negative or off-screen
+        float xPosition;
+        float yPosition;
+        // The brightness of the whole Icon, which each pixel's brightness is scaled by when rendering
+        // A full brightness of 20 draws the pixels as they are set
+        unsigned char brightness;
+        // The timestamp of the newest track update applied, so updates that arrive out of order are not applied
+        double lastUpdateTime;
 
         /** Constructor Icon
          * Define for the Constructor of this class
@@ -160,18 +689,28 @@ class Icon {
          */
         explicit Icon(int id);
 
+        /** Constructor Icon
+         * Define for the Constructor of an Icon with the shape of a template, e.g. one from defaultIconTemplates()
+         *
+         * @param id the unique integer identifier of this Icon
+         * @param shape the template to share the pixels of
+         *
+         * @author Daniel Marcovecchio
+         */
+        Icon(int id, std::shared_ptr<const IconTemplate> shape);
+
         /** Destructor Icon
          * Define for the Destructor of this class
-         * This is called once this object is no longer in use, and is to be deleted
+         * The shape is freed by the shared pointer once no Icon or library uses it, so the default is used
          *
          * @author Daniel Marcovecchio
          */
-        ~Icon();
+        ~Icon() = default;
 
         /** Method setPixel
          * Method to set one of the member pixels of this Icon, given by the index of said pixel
          *
-         * @param index of the pixel in the iconPixels array
+         * @param index of the pixel in the pixel arrays
          * @param px the new pixel to replace the old one
          *
          * @author Daniel Marcovecchio
@@ -179,31 +718,95 @@ class Icon {
         void setPixel(int index, Pixel px) {
             // Check if the parameter index is within the correct range, else through an error and return
             if(index < 0 || index > iconPixelsNumber-1) {
-                std::cout << "Error in setPixel in Icon class: index out of array range\n";
+                RADAR_LOG(logError, "Error in setPixel in Icon class: index out of array range");
                 return;
             }
-            // Create a new reference to the given Pixel
-            // else, the value will lose its scope and will risk pointing to the wrong address
-            // As the Pixel parameter is a copy of the pixel, WE CAN ASSUME THAT THIS IS DEFINED AND IT IS NOT NULLPTR
-            iconPixels[index] = new Pixel(px);
+            // If the shape is shared, with other Icons, a library or a snapshot, copy it first so only this Icon changes.
+            // A shape this Icon is the only owner of can be edited in place. Every such shape was made non-const by
+            // make_shared<IconTemplate> here or in IconTemplateLibrary, so casting away the const to edit it is safe
+            if(shape.use_count() != 1) {
+                std::shared_ptr<IconTemplate> ownShape = std::make_shared<IconTemplate>(*shape);
+                ownShape->templateId = IconTemplate::customTemplateId;
+                ownShape->name = "custom";
+                shape = ownShape;
+            }
+            IconTemplate* editableShape = const_cast<IconTemplate*>(shape.get());
+            // Copy the pixel fields into the shape. The pixel was already validated by its constructor
+            editableShape->pixelXCoords[index] = px.xCoord;
+            editableShape->pixelYCoords[index] = px.yCoord;
+            editableShape->pixelBrightness[index] = (unsigned char) px.brightness;
         }
 
         /** Method getPixel
-         * Method to return a pixel from the member pixel array iconPixels
+         * Method to return a copy of a pixel from the member pixel arrays
          * Currently not used in code, however exists for future expansion if required
          *
-         * @param index of the pixel in the iconPixels array to return
+         * @param index of the pixel in the pixel arrays to return
+         *
+         * @return the Pixel at index, or an empty Pixel if index is out of range
          *
          * @author Daniel Marcovecchio
          */
-        Pixel* getPixel(int index) {
-            // Check if the parameter index is within the correct range, else through an error and return nullptr
+        Pixel getPixel(int index) const {
+            // Check if the parameter index is within the correct range, else through an error and return an empty pixel
             if(index < 0 || index > iconPixelsNumber-1) {
-                std::cout << "Error in setPixel in Icon class: index out of array range\n";
-                return nullptr;
+                RADAR_LOG(logError, "Error in getPixel in Icon class: index out of array range");
+                return Pixel(0.0f, 0.0f, 0);
+            }
+            // Build a Pixel from the fields stored at the index parameter
+            return Pixel(shape->pixelXCoords[index], shape->pixelYCoords[index], shape->pixelBrightness[index]);
+        }
+
+        /** Methods getPixelXCoords, getPixelYCoords and getPixelBrightness
+         * Methods to read a whole lane of pixel data at once, all iconPixelsNumber entries long
+         * These are for code that processes every pixel of an icon in one go, such as rendering
+         *
+         * @author Daniel Marcovecchio
+         */
+        const float* getPixelXCoords() const { return shape->pixelXCoords; }
+        const float* getPixelYCoords() const { return shape->pixelYCoords; }
+        const unsigned char* getPixelBrightness() const { return shape->pixelBrightness; }
+
+        /** Methods getShape, getTemplateId and setShape
+         * Methods to read the template this Icon is drawn with, or change it to another, e.g. from a template library
+         *
+         * @author Daniel Marcovecchio
+         */
+        const std::shared_ptr<const IconTemplate>& getShape() const { return shape; }
+        unsigned int getTemplateId() const { return shape->templateId; }
+        void setShape(std::shared_ptr<const IconTemplate> newShape) { shape = std::move(newShape); }
+
+        /** Method copyFrom
+         * Method to make this Icon a copy of another, the same as assigning it except the shared shape is only
+         * reassigned if it differs. Keeping the same shape then costs no atomic updates of its use count, which is
+         * what makes refreshing a snapshot of many Icons that share a few templates cheap
+         *
+         * @param other the Icon to copy
+         *
+         * @author Daniel Marcovecchio
+         */
+        void copyFrom(const Icon& other) {
+            if(shape != other.shape) {
+                shape = other.shape;
             }
-            // Return the reference to the pixel at the index parameter
-            return iconPixels[index];
+            id = other.id;
+            xPosition = other.xPosition;
+            yPosition = other.yPosition;
+            brightness = other.brightness;
+            lastUpdateTime = other.lastUpdateTime;
+        }
+
+        /** Method setPosition
+         * Method to move this Icon to a new position on the display
+         *
+         * @param x the new xPosition
+         * @param y the new yPosition
+         *
+         * @author Daniel Marcovecchio
+         */
+        void setPosition(float x, float y) {
+            xPosition = x;
+            yPosition = y;
         }
 
         /** showIconDetail
@@ -215,148 +818,2521 @@ class Icon {
         void showIconDetail() const;
 };
 
-Icon::Icon(int id) : id(id), iconPixels() {
+Icon::Icon(int id) : Icon(id, emptyIconTemplate()) {
     // Implementation of the Icon constructor
-    // This constructor makes use of Constructor Initializers to automatically assign variables
-
-    // Loop to populate member pixel array iconPixels with empty pixels, this avoids future nullptr errors
-    for (int i = 0; i < iconPixelsNumber; ++i) {
-        iconPixels[i] = new Pixel(0.0f, 0.0f, 0);
-    }
+    // A new Icon shares the empty shape, so it starts as 16 empty pixels without any allocation
 }
 
-Icon::~Icon(){
-    // Implementation of Icon destructor
-
-    // Dynamically delete (clear) memory allocated to iconPixels array
-    delete[] &iconPixels;
+Icon::Icon(int id, std::shared_ptr<const IconTemplate> shape) : shape(std::move(shape)), id(id), xPosition(0.0f), yPosition(0.0f),
+                                                                brightness(maxPixelBrightness), lastUpdateTime(-1.0) {
+    // Implementation of the Icon constructor with a template
+    // This constructor makes use of Constructor Initializers to automatically assign variables
+    // It starts at full brightness at the top left corner of the display, before any track update
 }
 
 void Icon::showIconDetail() const {
     // Implementation of showIconDetail
 
-    // First display the current ID of this icon, for logging purposes
+    // First display the current ID of this icon, for logging purposes, after any messages logged before
+    flushLog();
     std::cout << "Details of Icon ID: " << id << "\n";
-    // Now loop for all member pixels (iconPixels) and invoke the iconPixelsNumber method for each one to display the respective pixel data
+    // Now loop for all member pixels and invoke the showPixelDetail method for each one to display the respective pixel data
     for (int i = 0; i < iconPixelsNumber; i++) {
         std::cout << "| Pixel " << i+1 << "/" << iconPixelsNumber << " | ";
-        // Check this pixel object is not empty before attempting to access its data
-        if(iconPixels[i] != nullptr)
-            iconPixels[i]->showPixelDetail();
+        getPixel(i).showPixelDetail();
     }
 }
 
-class RadarDisplay {
-    // Radar display class managing child icons for a display instance
+struct IconHandle {
+    // Handle struct to refer to an Icon in a RadarDisplay, kept public as it is plain data passed around by value
+    unsigned int slot;
+    unsigned int generation;
+
+    // The handle returned when an Icon could not be added, which never refers to any Icon
+    static const unsigned int invalidSlot = 0xFFFFFFFFu;
+    bool isValid() const { return slot != invalidSlot; }
+};
+
+class SpatialGrid {
+    // Spatial grid class, indexing points by the grid cell they fall in
 
-    // Private variables define
     private:
-        // radarIcons is a pointer to an array of Icons, of length radarDisplayMaxIcons, default max length 100
-        // This is kept private as add and remove type methods have been created to control the functionality
-        Icon* radarIcons[radarDisplayMaxIcons];
-        // The number of active icons in use, also kept private for the same reason
-        int numberOfActiveIcons;
+        float originX;
+        float originY;
+        float cellSize;
+        int columns;
+        int rows;
+        // The points of cell c are entries cellStart[c] up to cellStart[c+1]. Each entry keeps a copy of its point's
+        // position, so a query reads one contiguous run per cell and never goes back to the original arrays
+        std::vector<unsigned int> cellStart;
+        std::vector<unsigned int> entryPoint;
+        std::vector<float> entryX;
+        std::vector<float> entryY;
+
+        // The column and row of the cell a position falls in, clamped to the grid
+        int cellColumn(float x) const { return std::min(std::max((int) ((x - originX) / cellSize), 0), columns - 1); }
+        int cellRow(float y) const { return std::min(std::max((int) ((y - originY) / cellSize), 0), rows - 1); }
 
-    // Public variables define
     public:
-        // Define of the constructor and destructor for RadarDisplay
-        RadarDisplay();
-        ~RadarDisplay();
+        SpatialGrid() : originX(0.0f), originY(0.0f), cellSize(1.0f), columns(1), rows(1), cellStart(2, 0) {}
+        ~SpatialGrid() = default;
 
-        /** Method addIcon
-         * Method to add an Icon reference to the current list of active icons
-         * Finds a free space in the array and inserts into that element
+        /** Method build
+         * Method to index a set of points, replacing whatever was indexed before
+         * The grid covers the bounding box of the points, with cells sized so there are about two points per cell
          *
-         * @param iconToSet the icon to add to the radarIcons list
+         * @param xs and ys the positions of the points
+         * @param numberOfPoints the number of points
+         * @param minimumCellSize the smallest the cells may be, e.g. so that points within that distance of each other
+         * are always in the same or neighbouring cells
          *
          * @author Daniel Marcovecchio
          */
-        void addIcon(Icon* iconToSet) {
-            // First check if there is space in the array to add another Icon element, by comparing numberOfActiveIcons
-            // return if not
-            if(numberOfActiveIcons >= radarDisplayMaxIcons) {
-                std::cout << "Error in addIcon in RadarDisplay: Max number of icons reached";
-                return;
-            }
-            // Loop for all child Icons
-            for (int i = 0; i < radarDisplayMaxIcons; ++i) {
-                // If a nullptr is found, then the element is empty, so instert into here
-                if(radarIcons[i] == nullptr) {
-                    // Insert into current element
-                    radarIcons[i] = iconToSet;
-                    // Increment the number of active icons, as we have added one
-                    numberOfActiveIcons++;
-                    std::cout << "Added icon in RadarDisplay ID: " << iconToSet->id << "\n";
-                    return;
-                }
-            }
-        }
+        void build(const float* xs, const float* ys, size_t numberOfPoints, float minimumCellSize = 0.0f);
 
-        /** Method removeIcon
-         * Method to remove an Icon from the current list of active icons
-         * Searches whole array, comparing Icon ID's, and removes matching one
+        /** Method findInRectangle
+         * Method to find every point with minX <= x <= maxX and minY <= y <= maxY
          *
-         * @param iconToRemove the icon to remove from the radarIcons list
+         * @param found the list the indices of the points are appended to, in no particular order
          *
          * @author Daniel Marcovecchio
          */
-        void removeIcon(Icon* iconToRemove) {
-            // First check if the array is already empty or not before attempting, if it is, return
-            if(numberOfActiveIcons < 1) {
-                std::cout << "Error in addIcon in RadarDisplay: Array already empty";
-                return;
-            }
-            // Loop for all child Icons
-            for (int i = 0; i < radarDisplayMaxIcons; ++i) {
-                // Check that the current Icon is not empty before attempting to read its ID
-                // Then check if the ID matches the search case ID
-                if(radarIcons[i] != nullptr && radarIcons[i]->id == iconToRemove->id) {
-                    std::cout << "Deleted icon in RadarDisplay ID: " << radarIcons[i]->id << "\n";
-                    // If a match is found, set the array element back to nullptr, therefore its deleted
-                    radarIcons[i] = nullptr;
-                    // Reduce the number of active icons by one
-                    numberOfActiveIcons--;
-                    return;
-                }
-            }
-            std::cout << "Error in removeIcon in RadarDisplay: Icon not found\n";
-        }
-        /** Method showRadarDetail
-         * Method to display all current radar child Icons
+        void findInRectangle(float minX, float minY, float maxX, float maxY, std::vector<unsigned int>& found) const;
+
+        /** Method findInRange
+         * Method to find every point within a distance of range from (x, y)
+         *
+         * @param found the list the indices of the points are appended to, in no particular order
          *
          * @author Daniel Marcovecchio
          */
-        void showRadarDetail() const;
-};
+        void findInRange(float x, float y, float range, std::vector<unsigned int>& found) const;
 
-RadarDisplay::RadarDisplay() : numberOfActiveIcons(0), radarIcons() {}
-
-RadarDisplay::~RadarDisplay() {
-    // The destructor for RadarDisplay
+        /** Method findNearSegment
+         * Method to find every point within a distance of range from the line segment (x0, y0) to (x1, y1)
+         * Each row of cells is only checked over the columns the part of the segment near that row can reach, so a long
+         * segment checks a strip around itself rather than its whole bounding box
+         *
+         * @param found the list the indices of the points are appended to, in no particular order
+         *
+         * @author Daniel Marcovecchio
+         */
+        void findNearSegment(float x0, float y0, float x1, float y1, float range, std::vector<unsigned int>& found) const;
 
-    //When the current display is destroyed, free up the momory allocated to the radarIcons array
-    delete[] &radarIcons;
-}
+        /** Method findNearest
+         * Method to find the k points nearest to (x, y)
+         * Cells are searched in rings spreading out from the cell of (x, y), stopping once no cell further out can hold
+         * a point nearer than the k-th nearest found so far
+         *
+         * @param found the list the indices of the points are appended to, nearest first. Fewer than k if there are fewer points
+         *
+         * @author Daniel Marcovecchio
+         */
+        void findNearest(float x, float y, size_t k, std::vector<unsigned int>& found) const;
 
-void RadarDisplay::showRadarDetail() const {
-    // showRadarDetail to display all current radar child Icons
+        /** Method getPointsInCellOrder
+         * Method to read every point index sorted by the grid cell it is in, cells row by row, so work split into
+         * runs of this order is split by area
+         *
+         * @author Daniel Marcovecchio
+         */
+        const std::vector<unsigned int>& getPointsInCellOrder() const { return entryPoint; }
 
-    // Loop for the whole Icon array, even empty ones
-    for (int i = 0; i < radarDisplayMaxIcons; ++i) {
-        // If an element is not empty, then print its iconID and array element index
-        if (radarIcons[i] != nullptr) {
-            std::cout << "Icon ID: " << radarIcons[i]->id << " at Element: " << i << "\n";
+        /** Methods getColumns, getRows and getCellRun
+         * Methods to walk the grid cell by cell. getCellRun gives the positions in getPointsInCellOrder of the points
+         * in the cells column0 to column1 of a row, which are consecutive. Columns outside the grid are left out
+         *
+         * @param first and last set to the first position and one past the last, equal if the cells are empty
+         *
+         * @author Daniel Marcovecchio
+         */
+        int getColumns() const { return columns; }
+        int getRows() const { return rows; }
+        void getCellRun(int row, int column0, int column1, unsigned int& first, unsigned int& last) const {
+            column0 = std::max(column0, 0);
+            column1 = std::min(column1, columns - 1);
+            if(row < 0 || row >= rows || column1 < column0) {
+                first = last = 0;
+                return;
+            }
+            first = cellStart[row * columns + column0];
+            last = cellStart[row * columns + column1 + 1];
         }
-    }
-}
+};
 
+void SpatialGrid::build(const float* xs, const float* ys, size_t numberOfPoints, float minimumCellSize) {
+    // Implementation of build, a counting sort of the points by cell
 
+    // Cover the bounding box of the points
+    float minX = 0.0f, maxX = 0.0f, minY = 0.0f, maxY = 0.0f;
+    if(numberOfPoints > 0) {
+        minX = maxX = xs[0];
+        minY = maxY = ys[0];
+    }
+    for (size_t i = 1; i < numberOfPoints; i++) {
+        minX = std::min(minX, xs[i]);
+        maxX = std::max(maxX, xs[i]);
+        minY = std::min(minY, ys[i]);
+        maxY = std::max(maxY, ys[i]);
+    }
+    float width = maxX - minX, height = maxY - minY;
 
-void initialiseAsDefaultDiagonalLine(Icon* icon) {
-    // initialiseAsDefaultDiagonalLine Function takes a icon pointer and populates it with pixel data of a diagonal line, of brightness 15
+    // Size the cells for about two points each, limiting the grid to 2048 cells a side so scattered outliers can not
+    // make it huge. A grid with no width or height still gets cells of size 1
+    float area = std::max(width, 1.0f) * std::max(height, 1.0f);
+    cellSize = std::sqrt(area * 2.0f / (float) std::max(numberOfPoints, (size_t) 1));
+    cellSize = std::max(cellSize, std::max(width, height) / 2047.0f);
+    cellSize = std::max(cellSize, std::max(minimumCellSize, 1e-3f));
+    originX = minX;
+    originY = minY;
+    columns = (int) (width / cellSize) + 1;
+    rows = (int) (height / cellSize) + 1;
 
-    // Loop for all pixel slots, iconPixelsNumber, default 16
-    for (int i = 0; i < iconPixelsNumber; i++) {
+    // Count the points in each cell, turn the counts into start offsets, then place every point
+    std::vector<unsigned int> pointCell(numberOfPoints);
+    cellStart.assign((size_t) columns * rows + 1, 0);
+    for (size_t i = 0; i < numberOfPoints; i++) {
+        pointCell[i] = (unsigned int) (cellRow(ys[i]) * columns + cellColumn(xs[i]));
+        cellStart[pointCell[i] + 1]++;
+    }
+    for (size_t c = 0; c + 1 < cellStart.size(); c++) {
+        cellStart[c + 1] += cellStart[c];
+    }
+    entryPoint.resize(numberOfPoints);
+    entryX.resize(numberOfPoints);
+    entryY.resize(numberOfPoints);
+    std::vector<unsigned int> cellFill(cellStart.begin(), cellStart.end() - 1);
+    for (size_t i = 0; i < numberOfPoints; i++) {
+        unsigned int entry = cellFill[pointCell[i]]++;
+        entryPoint[entry] = (unsigned int) i;
+        entryX[entry] = xs[i];
+        entryY[entry] = ys[i];
+    }
+}
+
+void SpatialGrid::findInRectangle(float minX, float minY, float maxX, float maxY, std::vector<unsigned int>& found) const {
+    // Implementation of findInRectangle, checking every point of the cells the rectangle overlaps
+
+    if(maxX < minX || maxY < minY) {
+        return;
+    }
+    int column0 = cellColumn(minX), column1 = cellColumn(maxX);
+    int row0 = cellRow(minY), row1 = cellRow(maxY);
+    for (int row = row0; row <= row1; row++) {
+        // The cells of one row are consecutive, so their entries are one run
+        unsigned int first = cellStart[row * columns + column0], last = cellStart[row * columns + column1 + 1];
+        for (unsigned int e = first; e < last; e++) {
+            if(entryX[e] >= minX && entryX[e] <= maxX && entryY[e] >= minY && entryY[e] <= maxY) {
+                found.push_back(entryPoint[e]);
+            }
+        }
+    }
+}
+
+void SpatialGrid::findInRange(float x, float y, float range, std::vector<unsigned int>& found) const {
+    // Implementation of findInRange, checking every point of the cells the range's bounding square overlaps
+
+    if(range < 0.0f) {
+        return;
+    }
+    float rangeSquared = range * range;
+    int column0 = cellColumn(x - range), column1 = cellColumn(x + range);
+    int row0 = cellRow(y - range), row1 = cellRow(y + range);
+    for (int row = row0; row <= row1; row++) {
+        unsigned int first = cellStart[row * columns + column0], last = cellStart[row * columns + column1 + 1];
+        for (unsigned int e = first; e < last; e++) {
+            float dx = entryX[e] - x, dy = entryY[e] - y;
+            if(dx * dx + dy * dy <= rangeSquared) {
+                found.push_back(entryPoint[e]);
+            }
+        }
+    }
+}
+
+void SpatialGrid::findNearSegment(float x0, float y0, float x1, float y1, float range, std::vector<unsigned int>& found) const {
+    // Implementation of findNearSegment, checking in each row the cells near the part of the segment within range of it
+
+    if(range < 0.0f) {
+        return;
+    }
+    float rangeSquared = range * range;
+    float segmentX = x1 - x0, segmentY = y1 - y0;
+    float lengthSquared = segmentX * segmentX + segmentY * segmentY;
+    int row0 = cellRow(std::min(y0, y1) - range), row1 = cellRow(std::max(y0, y1) + range);
+    for (int row = row0; row <= row1; row++) {
+        // A point in this row can only be within range of the part of the segment whose y is within range of the row
+        float minX = std::min(x0, x1), maxX = std::max(x0, x1);
+        if(segmentY != 0.0f) {
+            float rowTop = originY + (float) row * cellSize - range, rowBottom = originY + (float) (row + 1) * cellSize + range;
+            float t0 = std::min(std::max((rowTop - y0) / segmentY, 0.0f), 1.0f);
+            float t1 = std::min(std::max((rowBottom - y0) / segmentY, 0.0f), 1.0f);
+            minX = std::min(x0 + segmentX * t0, x0 + segmentX * t1);
+            maxX = std::max(x0 + segmentX * t0, x0 + segmentX * t1);
+        }
+        unsigned int first = cellStart[row * columns + cellColumn(minX - range)];
+        unsigned int last = cellStart[row * columns + cellColumn(maxX + range) + 1];
+        for (unsigned int e = first; e < last; e++) {
+            // The distance to the nearest point of the segment
+            float t = lengthSquared > 0.0f ? ((entryX[e] - x0) * segmentX + (entryY[e] - y0) * segmentY) / lengthSquared : 0.0f;
+            t = std::min(std::max(t, 0.0f), 1.0f);
+            float dx = entryX[e] - (x0 + segmentX * t), dy = entryY[e] - (y0 + segmentY * t);
+            if(dx * dx + dy * dy <= rangeSquared) {
+                found.push_back(entryPoint[e]);
+            }
+        }
+    }
+}
+
+void SpatialGrid::findNearest(float x, float y, size_t k, std::vector<unsigned int>& found) const {
+    // Implementation of findNearest, keeping the k nearest points so far in a max heap on distance
+
+    if(k == 0) {
+        return;
+    }
+    std::priority_queue<std::pair<float, unsigned int>> nearest;
+    int centreColumn = cellColumn(x), centreRow = cellRow(y);
+    int maxRing = std::max(std::max(centreColumn, columns - 1 - centreColumn), std::max(centreRow, rows - 1 - centreRow));
+
+    for (int ring = 0; ring <= maxRing; ring++) {
+        // Every cell of this ring is at least ring-1 whole cells away, so once that is further than the k-th nearest
+        // point found, no cell from here out can improve on it
+        if(nearest.size() == k) {
+            float ringDistance = (float) (ring - 1) * cellSize;
+            if(ringDistance > 0.0f && ringDistance * ringDistance > nearest.top().first) {
+                break;
+            }
+        }
+        int row0 = std::max(centreRow - ring, 0), row1 = std::min(centreRow + ring, rows - 1);
+        for (int row = row0; row <= row1; row++) {
+            // Rows at the top and bottom of the ring are whole, the rows between only have the two cells at the ends
+            bool wholeRow = row == centreRow - ring || row == centreRow + ring;
+            int step = wholeRow ? 1 : 2 * ring;
+            for (int column = centreColumn - ring; column <= centreColumn + ring; column += std::max(step, 1)) {
+                if(column < 0 || column >= columns) {
+                    continue;
+                }
+                int cell = row * columns + column;
+                for (unsigned int e = cellStart[cell]; e < cellStart[cell + 1]; e++) {
+                    float dx = entryX[e] - x, dy = entryY[e] - y;
+                    float distanceSquared = dx * dx + dy * dy;
+                    if(nearest.size() < k) {
+                        nearest.push(std::make_pair(distanceSquared, entryPoint[e]));
+                    } else if(distanceSquared < nearest.top().first) {
+                        nearest.pop();
+                        nearest.push(std::make_pair(distanceSquared, entryPoint[e]));
+                    }
+                }
+            }
+        }
+    }
+
+    // The heap gives the furthest first, so fill the results from the back
+    size_t firstResult = found.size();
+    found.resize(firstResult + nearest.size());
+    for (size_t i = found.size(); i > firstResult; i--) {
+        found[i - 1] = nearest.top().second;
+        nearest.pop();
+    }
+}
+
+struct TrackUpdate {
+    // Plain data struct for one track update, public as it is only passed around and stored
+    int id;
+    float x;
+    float y;
+    unsigned int brightness;
+    double timestamp;
+};
+static_assert(sizeof(TrackUpdate) == 24, "TrackUpdate is the record layout of track recordings and must be 24 bytes");
+
+template <typename T>
+class MpscRingBuffer {
+    // Ring buffer class, a bounded queue for many producer threads and one consumer thread
+
+    private:
+        // A cell holds one item. Its sequence equals the push position when free to write in this lap of the ring,
+        // and the push position + 1 when written and ready to pop
+        struct Cell {
+            std::atomic<size_t> sequence;
+            T value;
+        };
+
+        std::unique_ptr<Cell[]> cells;
+        size_t mask;
+        // The counters are kept a cache line apart so producers and the consumer do not slow each other down
+        alignas(64) std::atomic<size_t> enqueuePosition;
+        alignas(64) size_t dequeuePosition;
+
+    public:
+        // Constructor, making a ring of at least the given capacity, rounded up to a power of two
+        explicit MpscRingBuffer(size_t capacity) : mask(0), enqueuePosition(0), dequeuePosition(0) {
+            size_t size = 2;
+            while (size < capacity) {
+                size *= 2;
+            }
+            cells.reset(new Cell[size]);
+            mask = size - 1;
+            for (size_t i = 0; i < size; i++) {
+                cells[i].sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+        ~MpscRingBuffer() = default;
+
+        /** Method tryPush
+         * Method to push an item, safe to call from any number of threads at once
+         *
+         * @param value the item to push
+         *
+         * @return true if it was pushed, false if the ring is full
+         *
+         * @author Daniel Marcovecchio
+         */
+        bool tryPush(const T& value) {
+            size_t position = enqueuePosition.load(std::memory_order_relaxed);
+            Cell* cell;
+            for (;;) {
+                cell = &cells[position & mask];
+                size_t sequence = cell->sequence.load(std::memory_order_acquire);
+                long difference = (long) sequence - (long) position;
+                if(difference == 0) {
+                    // The cell is free for this position, claim the position. If another producer got it first, try again
+                    if(enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                        break;
+                    }
+                } else if(difference < 0) {
+                    // The cell still holds an item from the last lap that has not been popped, so the ring is full
+                    return false;
+                } else {
+                    position = enqueuePosition.load(std::memory_order_relaxed);
+                }
+            }
+            cell->value = value;
+            cell->sequence.store(position + 1, std::memory_order_release);
+            return true;
+        }
+
+        /** Method tryPop
+         * Method to pop the oldest item. Must only ever be called from one thread
+         *
+         * @param value where the item is written
+         *
+         * @return true if an item was popped, false if the ring is empty
+         *
+         * @author Daniel Marcovecchio
+         */
+        bool tryPop(T& value) {
+            Cell* cell = &cells[dequeuePosition & mask];
+            if(cell->sequence.load(std::memory_order_acquire) != dequeuePosition + 1) {
+                return false;
+            }
+            value = cell->value;
+            // Free the cell for the push one lap of the ring later
+            cell->sequence.store(dequeuePosition + mask + 1, std::memory_order_release);
+            dequeuePosition++;
+            return true;
+        }
+
+        /** Method popBatch
+         * Method to pop up to maxItems items at once. Must only ever be called from the same thread as tryPop
+         *
+         * @param items where the items are written, in the order they were pushed
+         *
+         * @return the number of items popped
+         *
+         * @author Daniel Marcovecchio
+         */
+        size_t popBatch(T* items, size_t maxItems) {
+            size_t popped = 0;
+            while (popped < maxItems && tryPop(items[popped])) {
+                popped++;
+            }
+            return popped;
+        }
+};
+
+/** Class RadarLog
+ * RadarLog is the backend of the logging layer, a queue of formatted messages and the thread that writes them out
+ * There is one, made the first time a message is logged, and it writes any messages left when the program exits
+ *
+ * @property records the queue of messages waiting to be written
+ * @property messagesQueued and messagesWritten which flushLog compares to know every message is out
+ * @property messageCounts and droppedMessages the number of messages logged at each level, and dropped when full
+ *
+ * @author Daniel Marcovecchio
+ */
+class RadarLog {
+    // Logging backend class, writing queued messages on its own thread
+
+    public:
+        // One message, formatted when it is logged so the writer thread only has to copy it out
+        struct LogRecord {
+            LogLevel level;
+            char text[124];
+        };
+
+        MpscRingBuffer<LogRecord> records;
+        std::atomic<size_t> messagesQueued;
+        std::atomic<size_t> messagesWritten;
+        std::atomic<size_t> messageCounts[4];
+        std::atomic<size_t> droppedMessages;
+        std::atomic<bool> stopping;
+        std::thread writer;
+
+        RadarLog() : records(4096), messagesQueued(0), messagesWritten(0), droppedMessages(0), stopping(false) {
+            for (std::atomic<size_t>& count : messageCounts) {
+                count.store(0);
+            }
+            writer = std::thread([this]() { writeMessages(); });
+        }
+        ~RadarLog() {
+            stopping.store(true);
+            writer.join();
+        }
+
+        // The writer thread's loop, writing messages until the log is stopped and the queue is empty
+        void writeMessages() {
+            LogRecord record;
+            for (;;) {
+                bool stop = stopping.load();
+                size_t written = 0;
+                while (records.tryPop(record)) {
+                    std::cout << record.text << '\n';
+                    written++;
+                }
+                if(written > 0) {
+                    std::cout.flush();
+                    messagesWritten.fetch_add(written);
+                } else if(stop) {
+                    return;
+                } else {
+                    std::this_thread::sleep_for(std::chrono::microseconds(200));
+                }
+            }
+        }
+};
+
+RadarLog& radarLog() {
+    static RadarLog log;
+    return log;
+}
+
+void writeLogMessage(LogLevel level, const char* format, ...) {
+    RadarLog& log = radarLog();
+    log.messageCounts[level].fetch_add(1, std::memory_order_relaxed);
+    RadarLog::LogRecord record;
+    record.level = level;
+    va_list arguments;
+    va_start(arguments, format);
+    std::vsnprintf(record.text, sizeof(record.text), format, arguments);
+    va_end(arguments);
+    // Never wait for the writer thread. If it has fallen this far behind, the message is dropped and counted
+    if(log.records.tryPush(record)) {
+        log.messagesQueued.fetch_add(1);
+    } else {
+        log.droppedMessages.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void flushLog() {
+    RadarLog& log = radarLog();
+    size_t queued = log.messagesQueued.load();
+    while (log.messagesWritten.load() < queued) {
+        std::this_thread::yield();
+    }
+}
+
+size_t getLogMessageCount(LogLevel level) {
+    return radarLog().messageCounts[level].load(std::memory_order_relaxed);
+}
+
+size_t getDroppedLogMessages() {
+    return radarLog().droppedMessages.load(std::memory_order_relaxed);
+}
+
+class RadarDisplay {
+    // Radar display class managing child icons for a display instance
+
+    // Private variables define
+    private:
+        // Each slot of the registry records where its Icon is in radarIcons, and how many times the slot has been reused
+        struct IconSlot {
+            unsigned int denseIndex;
+            unsigned int generation;
+        };
+
+        // radarIcons is the dense array of active Icons, with no gaps, so rendering can simply walk it from start to end
+        // slotOfDenseIcon records which slot owns each entry, so a removal can fix up the slot of the entry moved into its place
+        // These are kept private as add and remove type methods have been created to control the functionality
+        std::vector<Icon*> radarIcons;
+        std::vector<unsigned int> slotOfDenseIcon;
+        // The slot table behind the handles, and the list of slots free to reuse
+        std::vector<IconSlot> iconSlots;
+        std::vector<unsigned int> freeSlots;
+        // The hash index from Icon ID to slot, for finding and removing Icons by ID
+        std::unordered_map<int, unsigned int> slotOfIconId;
+
+        // The spatial index over Icon positions, which indexes Icons by their place in radarIcons
+        // It is marked stale by adding and removing Icons, as that changes those places, and is then rebuilt by the next query
+        SpatialGrid spatialIndex;
+        bool spatialIndexStale;
+        // The largest pixel coord of any Icon, plus one, so a search around a point can reach every Icon covering it
+        float maxIconExtentX;
+        float maxIconExtentY;
+        // Working memory for the queries, kept to reuse its space
+        std::vector<unsigned int> queryPoints;
+
+        // The slots changed since the renderer last took them, and a flag per slot so each is listed only once
+        std::vector<unsigned int> changedSlots;
+        std::vector<unsigned char> slotChanged;
+
+        // Method to note that the Icon in a slot was added, removed, moved or otherwise changed
+        void markSlotChanged(unsigned int slot) {
+            if(!slotChanged[slot]) {
+                slotChanged[slot] = 1;
+                changedSlots.push_back(slot);
+            }
+        }
+
+        // The batch of track updates being applied, and counts of the updates that were not applied
+        std::vector<TrackUpdate> updateBatch;
+        size_t unknownTrackUpdates;
+        size_t staleTrackUpdates;
+
+    // Public variables define
+    public:
+        // Whether adding and removing Icons is logged. Public so it can be turned off when loading many Icons at once
+        bool logIconChanges;
+
+        // Define of the constructor and destructor for RadarDisplay
+        RadarDisplay();
+        ~RadarDisplay();
+
+        /** Method reserveIcons
+         * Method to allocate space for a number of Icons up front, so adding that many never needs to grow the registry
+         *
+         * @param numberOfIcons the number of Icons to make space for
+         *
+         * @author Daniel Marcovecchio
+         */
+        void reserveIcons(size_t numberOfIcons);
+
+        /** Method addIcon
+         * Method to add an Icon reference to the current list of active icons
+         * Appends it to the end of the dense array and gives it a slot, reusing a free one if there is one
+         * The display does not take ownership, the Icon must stay alive until it is removed
+         *
+         * @param iconToSet the icon to add to the radarIcons list
+         *
+         * @return a handle to the added Icon, or an invalid handle if an Icon with the same ID is already active
+         *
+         * @author Daniel Marcovecchio
+         */
+        IconHandle addIcon(Icon* iconToSet);
+
+        /** Method removeIcon
+         * Method to remove an Icon from the current list of active icons
+         * Looks the Icon up by its ID, and removes it
+         *
+         * @param iconToRemove the icon to remove from the radarIcons list
+         *
+         * @author Daniel Marcovecchio
+         */
+        void removeIcon(Icon* iconToRemove);
+
+        /** Method removeIcon
+         * Method to remove the Icon a handle refers to
+         * The last Icon in the dense array is moved into the gap, so the array stays packed
+         *
+         * @param handle the handle returned by addIcon
+         *
+         * @return true if the Icon was removed, false if the handle was invalid or already removed
+         *
+         * @author Daniel Marcovecchio
+         */
+        bool removeIcon(IconHandle handle);
+
+        /** Methods findIcon and getIcon
+         * Methods to look up an active Icon by its ID, or by a handle
+         *
+         * @return the Icon, or nullptr if there is no such active Icon
+         *
+         * @author Daniel Marcovecchio
+         */
+        Icon* findIcon(int id) const;
+        Icon* getIcon(IconHandle handle) const;
+
+        /** Methods getNumberOfActiveIcons and getActiveIcon
+         * Methods to walk every active Icon, in dense array order, from index 0 to getNumberOfActiveIcons()-1
+         * The order changes when Icons are removed
+         *
+         * @author Daniel Marcovecchio
+         */
+        size_t getNumberOfActiveIcons() const { return radarIcons.size(); }
+        Icon* getActiveIcon(size_t index) const { return radarIcons[index]; }
+
+        /** Methods moveIcon
+         * Methods to move an Icon, found by handle or by ID, marking it changed so the renderer redraws where it was
+         * and where it now is, and the spatial index is rebuilt before the next query
+         *
+         * @return true if the Icon was found and moved
+         *
+         * @author Daniel Marcovecchio
+         */
+        bool moveIcon(IconHandle handle, float x, float y);
+        bool moveIcon(int id, float x, float y);
+
+        /** Method markIconChanged
+         * Method to mark an Icon changed after editing it directly, e.g. writing its position, brightness or shape
+         *
+         * @param icon the Icon that changed, which must be on this display
+         *
+         * @author Daniel Marcovecchio
+         */
+        void markIconChanged(const Icon* icon);
+
+        /** Methods getNumberOfSlots, getIconInSlot and takeChangedSlots
+         * Methods for the renderer to follow the display by slot, which unlike the dense array order stays the same
+         * for an Icon while it is on the display. takeChangedSlots hands over the changed slots and starts a new list
+         *
+         * @author Daniel Marcovecchio
+         */
+        size_t getNumberOfSlots() const { return iconSlots.size(); }
+        Icon* getIconInSlot(unsigned int slot) const;
+        void takeChangedSlots(std::vector<unsigned int>& slots);
+
+        /** Method updateSpatialIndex
+         * Method to rebuild the spatial index from the current Icon positions
+         * Adding, removing and moving Icons with moveIcon rebuilds it automatically on the next query, but writing
+         * positions directly does not. Call this once per frame after moving Icons that way, before querying
+         *
+         * @author Daniel Marcovecchio
+         */
+        void updateSpatialIndex();
+
+        /** Method findIconsInRange
+         * Method to find every Icon whose position is within a distance of range from (x, y)
+         *
+         * @param found the list the Icons are written to, replacing what it held
+         *
+         * @author Daniel Marcovecchio
+         */
+        void findIconsInRange(float x, float y, float range, std::vector<Icon*>& found);
+
+        /** Method findIconsInRectangle
+         * Method to find every Icon whose position is inside the rectangle from (minX, minY) to (maxX, maxY)
+         *
+         * @param found the list the Icons are written to, replacing what it held
+         *
+         * @author Daniel Marcovecchio
+         */
+        void findIconsInRectangle(float minX, float minY, float maxX, float maxY, std::vector<Icon*>& found);
+
+        /** Method findNearestIcons
+         * Method to find the k Icons whose positions are nearest to (x, y)
+         *
+         * @param found the list the Icons are written to nearest first, replacing what it held
+         *
+         * @author Daniel Marcovecchio
+         */
+        void findNearestIcons(float x, float y, size_t k, std::vector<Icon*>& found);
+
+        /** Method findIconsAtPoint
+         * Method to find every Icon with a lit pixel drawn on the screen pixel containing (x, y), e.g. under the cursor
+         *
+         * @param found the list the Icons are written to, replacing what it held
+         *
+         * @author Daniel Marcovecchio
+         */
+        void findIconsAtPoint(float x, float y, std::vector<Icon*>& found);
+
+        /** Method applyTrackUpdates
+         * Method for the display thread to apply the track updates waiting in a feed, once per frame
+         * Each update moves its Icon and sets its brightness. Updates for IDs not on the display, or older than the
+         * last update applied to their Icon, are counted and skipped. Updated Icons are marked changed, the same as moveIcon
+         *
+         * @param feed the feed the producer threads push updates into
+         * @param maxUpdates the most updates to apply this frame, so a burst can not stall the frame
+         *
+         * @return the number of updates applied
+         *
+         * @author Daniel Marcovecchio
+         */
+        size_t applyTrackUpdates(MpscRingBuffer<TrackUpdate>& feed, size_t maxUpdates);
+
+        /** Methods getUnknownTrackUpdates and getStaleTrackUpdates
+         * Methods to read the number of track updates skipped since the display was made
+         *
+         * @author Daniel Marcovecchio
+         */
+        size_t getUnknownTrackUpdates() const { return unknownTrackUpdates; }
+        size_t getStaleTrackUpdates() const { return staleTrackUpdates; }
+
+        /** Method showRadarDetail
+         * Method to display all current radar child Icons
+         *
+         * @author Daniel Marcovecchio
+         */
+        void showRadarDetail() const;
+};
+
+RadarDisplay::RadarDisplay() : spatialIndexStale(true), maxIconExtentX(0.0f), maxIconExtentY(0.0f), unknownTrackUpdates(0),
+                               staleTrackUpdates(0), logIconChanges(true) {
+    // Implementation of the RadarDisplay constructor, which starts with an empty registry
+}
+
+// The display never owns its Icons, so there is nothing to free and the vectors clean up after themselves
+RadarDisplay::~RadarDisplay() = default;
+
+void RadarDisplay::reserveIcons(size_t numberOfIcons) {
+    // Reserve space in every part of the registry
+    radarIcons.reserve(numberOfIcons);
+    slotOfDenseIcon.reserve(numberOfIcons);
+    iconSlots.reserve(numberOfIcons);
+    slotOfIconId.reserve(numberOfIcons);
+}
+
+IconHandle RadarDisplay::addIcon(Icon* iconToSet) {
+    // Implementation of addIcon, to register a new Icon in constant time
+
+    // Icons are found by their ID, so two active Icons can not share one
+    if(slotOfIconId.count(iconToSet->id) != 0) {
+        RADAR_LOG(logError, "Error in addIcon in RadarDisplay: Icon ID %d is already active", iconToSet->id);
+        return IconHandle{IconHandle::invalidSlot, 0};
+    }
+
+    // Take a free slot if there is one, else grow the slot table by one
+    unsigned int slot;
+    if(!freeSlots.empty()) {
+        slot = freeSlots.back();
+        freeSlots.pop_back();
+    } else {
+        slot = (unsigned int) iconSlots.size();
+        iconSlots.push_back(IconSlot{0, 0});
+        slotChanged.push_back(0);
+    }
+
+    // Append the Icon to the dense array, and point the slot and ID index at it
+    iconSlots[slot].denseIndex = (unsigned int) radarIcons.size();
+    radarIcons.push_back(iconToSet);
+    slotOfDenseIcon.push_back(slot);
+    slotOfIconId[iconToSet->id] = slot;
+    spatialIndexStale = true;
+    markSlotChanged(slot);
+
+    if(logIconChanges) {
+        RADAR_LOG(logInfo, "Added icon in RadarDisplay ID: %d", iconToSet->id);
+    }
+    return IconHandle{slot, iconSlots[slot].generation};
+}
+
+void RadarDisplay::removeIcon(Icon* iconToRemove) {
+    // Implementation of removeIcon by ID, which finds the slot then removes by handle
+
+    auto found = slotOfIconId.find(iconToRemove->id);
+    if(found == slotOfIconId.end()) {
+        RADAR_LOG(logError, "Error in removeIcon in RadarDisplay: Icon not found");
+        return;
+    }
+    removeIcon(IconHandle{found->second, iconSlots[found->second].generation});
+}
+
+bool RadarDisplay::removeIcon(IconHandle handle) {
+    // Implementation of removeIcon by handle, to unregister an Icon in constant time
+
+    // The handle must refer to a slot in use, from the same generation
+    Icon* icon = getIcon(handle);
+    if(icon == nullptr) {
+        RADAR_LOG(logError, "Error in removeIcon in RadarDisplay: Icon not found");
+        return false;
+    }
+    if(logIconChanges) {
+        RADAR_LOG(logInfo, "Deleted icon in RadarDisplay ID: %d", icon->id);
+    }
+
+    // Move the last Icon of the dense array into the gap, and update the slot that owns it
+    unsigned int denseIndex = iconSlots[handle.slot].denseIndex;
+    unsigned int lastIndex = (unsigned int) radarIcons.size() - 1;
+    radarIcons[denseIndex] = radarIcons[lastIndex];
+    slotOfDenseIcon[denseIndex] = slotOfDenseIcon[lastIndex];
+    iconSlots[slotOfDenseIcon[denseIndex]].denseIndex = denseIndex;
+    radarIcons.pop_back();
+    slotOfDenseIcon.pop_back();
+
+    // Retire the slot, moving its generation on so old handles to it no longer match, then free it for reuse
+    iconSlots[handle.slot].generation++;
+    freeSlots.push_back(handle.slot);
+    markSlotChanged(handle.slot);
+    slotOfIconId.erase(icon->id);
+    spatialIndexStale = true;
+    return true;
+}
+
+Icon* RadarDisplay::findIcon(int id) const {
+    // Look up the slot of this ID in the hash index, then the Icon in the dense array
+    auto found = slotOfIconId.find(id);
+    if(found == slotOfIconId.end()) {
+        return nullptr;
+    }
+    return radarIcons[iconSlots[found->second].denseIndex];
+}
+
+Icon* RadarDisplay::getIcon(IconHandle handle) const {
+    // A handle only finds its Icon if its slot exists and has not been reused since the handle was given out
+    if(handle.slot >= iconSlots.size() || iconSlots[handle.slot].generation != handle.generation) {
+        return nullptr;
+    }
+    return radarIcons[iconSlots[handle.slot].denseIndex];
+}
+
+bool RadarDisplay::moveIcon(IconHandle handle, float x, float y) {
+    Icon* icon = getIcon(handle);
+    if(icon == nullptr) {
+        return false;
+    }
+    icon->setPosition(x, y);
+    spatialIndexStale = true;
+    markSlotChanged(handle.slot);
+    return true;
+}
+
+bool RadarDisplay::moveIcon(int id, float x, float y) {
+    auto found = slotOfIconId.find(id);
+    if(found == slotOfIconId.end()) {
+        return false;
+    }
+    return moveIcon(IconHandle{found->second, iconSlots[found->second].generation}, x, y);
+}
+
+void RadarDisplay::markIconChanged(const Icon* icon) {
+    auto found = slotOfIconId.find(icon->id);
+    if(found == slotOfIconId.end()) {
+        RADAR_LOG(logError, "Error in markIconChanged in RadarDisplay: Icon not found");
+        return;
+    }
+    spatialIndexStale = true;
+    markSlotChanged(found->second);
+}
+
+Icon* RadarDisplay::getIconInSlot(unsigned int slot) const {
+    // A slot is free when the dense entry it points at is owned by another slot, or is past the end of the array
+    unsigned int denseIndex = iconSlots[slot].denseIndex;
+    if(denseIndex >= radarIcons.size() || slotOfDenseIcon[denseIndex] != slot) {
+        return nullptr;
+    }
+    return radarIcons[denseIndex];
+}
+
+void RadarDisplay::takeChangedSlots(std::vector<unsigned int>& slots) {
+    slots.clear();
+    slots.swap(changedSlots);
+    for (unsigned int slot : slots) {
+        slotChanged[slot] = 0;
+    }
+}
+
+void RadarDisplay::updateSpatialIndex() {
+    // Implementation of updateSpatialIndex, gathering the Icon positions and extents then building the grid over them
+
+    std::vector<float> xs(radarIcons.size()), ys(radarIcons.size());
+    maxIconExtentX = 0.0f;
+    maxIconExtentY = 0.0f;
+    for (size_t i = 0; i < radarIcons.size(); i++) {
+        const Icon* icon = radarIcons[i];
+        xs[i] = icon->xPosition;
+        ys[i] = icon->yPosition;
+        const float* pixelXs = icon->getPixelXCoords();
+        const float* pixelYs = icon->getPixelYCoords();
+        for (unsigned int p = 0; p < iconPixelsNumber; p++) {
+            maxIconExtentX = std::max(maxIconExtentX, pixelXs[p] + 1.0f);
+            maxIconExtentY = std::max(maxIconExtentY, pixelYs[p] + 1.0f);
+        }
+    }
+    spatialIndex.build(xs.data(), ys.data(), radarIcons.size());
+    spatialIndexStale = false;
+}
+
+void RadarDisplay::findIconsInRange(float x, float y, float range, std::vector<Icon*>& found) {
+    // Query the grid, then turn the indices it found into Icons
+    if(spatialIndexStale) {
+        updateSpatialIndex();
+    }
+    queryPoints.clear();
+    spatialIndex.findInRange(x, y, range, queryPoints);
+    found.clear();
+    for (unsigned int index : queryPoints) {
+        found.push_back(radarIcons[index]);
+    }
+}
+
+void RadarDisplay::findIconsInRectangle(float minX, float minY, float maxX, float maxY, std::vector<Icon*>& found) {
+    // Query the grid, then turn the indices it found into Icons
+    if(spatialIndexStale) {
+        updateSpatialIndex();
+    }
+    queryPoints.clear();
+    spatialIndex.findInRectangle(minX, minY, maxX, maxY, queryPoints);
+    found.clear();
+    for (unsigned int index : queryPoints) {
+        found.push_back(radarIcons[index]);
+    }
+}
+
+void RadarDisplay::findNearestIcons(float x, float y, size_t k, std::vector<Icon*>& found) {
+    // Query the grid, then turn the indices it found into Icons, keeping the nearest first order
+    if(spatialIndexStale) {
+        updateSpatialIndex();
+    }
+    queryPoints.clear();
+    spatialIndex.findNearest(x, y, k, queryPoints);
+    found.clear();
+    for (unsigned int index : queryPoints) {
+        found.push_back(radarIcons[index]);
+    }
+}
+
+void RadarDisplay::findIconsAtPoint(float x, float y, std::vector<Icon*>& found) {
+    // Implementation of findIconsAtPoint
+
+    // Pixel coords are never negative, so an Icon covering (x, y) has its position at most one pixel right of or below
+    // it, and at most the largest Icon extent left of or above it. Find those, then check their pixels exactly
+    // The extents are only worked out when the index is rebuilt, so rebuild it before reading them
+    if(spatialIndexStale) {
+        updateSpatialIndex();
+    }
+    std::vector<Icon*> candidates;
+    findIconsInRectangle(x - maxIconExtentX, y - maxIconExtentY, x + 1.0f, y + 1.0f, candidates);
+    float screenX = std::floor(x), screenY = std::floor(y);
+    found.clear();
+    for (Icon* icon : candidates) {
+        const float* pixelXs = icon->getPixelXCoords();
+        const float* pixelYs = icon->getPixelYCoords();
+        const unsigned char* values = icon->getPixelBrightness();
+        for (unsigned int p = 0; p < iconPixelsNumber; p++) {
+            // The same rounding as the renderer, so this finds exactly the Icons drawn on that screen pixel
+            if(values[p] != 0 && std::floor(pixelXs[p] + icon->xPosition) == screenX
+               && std::floor(pixelYs[p] + icon->yPosition) == screenY) {
+                found.push_back(icon);
+                break;
+            }
+        }
+    }
+}
+
+size_t RadarDisplay::applyTrackUpdates(MpscRingBuffer<TrackUpdate>& feed, size_t maxUpdates) {
+    // Implementation of applyTrackUpdates, popping updates in batches and applying each to its Icon
+
+    const size_t batchSize = 4096;
+    updateBatch.resize(batchSize);
+    size_t applied = 0, taken = 0;
+    while (taken < maxUpdates) {
+        size_t popped = feed.popBatch(updateBatch.data(), std::min(batchSize, maxUpdates - taken));
+        if(popped == 0) {
+            break;
+        }
+        taken += popped;
+        for (size_t i = 0; i < popped; i++) {
+            const TrackUpdate& update = updateBatch[i];
+            auto found = slotOfIconId.find(update.id);
+            if(found == slotOfIconId.end()) {
+                RADAR_LOG(logTrace, "Track update for unknown Icon ID %d skipped", update.id);
+                unknownTrackUpdates++;
+                continue;
+            }
+            Icon* icon = radarIcons[iconSlots[found->second].denseIndex];
+            // Producers push concurrently, so updates for one Icon can arrive out of order. Keep the newest
+            if(update.timestamp < icon->lastUpdateTime) {
+                staleTrackUpdates++;
+                continue;
+            }
+            icon->setPosition(update.x, update.y);
+            icon->brightness = (unsigned char) std::min(update.brightness, maxPixelBrightness);
+            icon->lastUpdateTime = update.timestamp;
+            markSlotChanged(found->second);
+            applied++;
+        }
+    }
+    if(applied > 0) {
+        spatialIndexStale = true;
+    }
+    return applied;
+}
+
+void RadarDisplay::showRadarDetail() const {
+    // showRadarDetail to display all current radar child Icons
+
+    // Loop for the dense Icon array, which only holds active Icons, and print each iconID and array element index
+    // Messages logged before are written first
+    flushLog();
+    for (size_t i = 0; i < radarIcons.size(); ++i) {
+        std::cout << "Icon ID: " << radarIcons[i]->id << " at Element: " << i << "\n";
+    }
+}
+
+
+
+/** Functions writeTrackRecording and readTrackRecording
+ * Functions to save and load a recorded track feed, used to replay the feed without the radar
+ * A recording is the 4 bytes RTRK, a uint32 format version of 1, a uint64 count of updates, then the updates as
+ * 24 byte TrackUpdate records. Numbers are in the byte order of the machine, which is little endian on our targets
+ *
+ * @param path the file to write or read
+ * @param updates the updates to write, or the list to read them into, replacing what it held
+ *
+ * @return true if the whole file was written or read
+ *
+ * @author Daniel Marcovecchio
+ */
+bool writeTrackRecording(const char* path, const std::vector<TrackUpdate>& updates) {
+    std::ofstream file(path, std::ios::binary);
+    if(!file) {
+        RADAR_LOG(logError, "Error in writeTrackRecording: could not open %s", path);
+        return false;
+    }
+    const unsigned int version = 1;
+    const unsigned long long count = updates.size();
+    file.write("RTRK", 4);
+    file.write((const char*) &version, sizeof(version));
+    file.write((const char*) &count, sizeof(count));
+    file.write((const char*) updates.data(), (std::streamsize) (updates.size() * sizeof(TrackUpdate)));
+    return (bool) file;
+}
+
+bool readTrackRecording(const char* path, std::vector<TrackUpdate>& updates) {
+    std::ifstream file(path, std::ios::binary);
+    char magic[4] = {0, 0, 0, 0};
+    unsigned int version = 0;
+    unsigned long long count = 0;
+    file.read(magic, 4);
+    file.read((char*) &version, sizeof(version));
+    file.read((char*) &count, sizeof(count));
+    if(!file || std::memcmp(magic, "RTRK", 4) != 0 || version != 1) {
+        RADAR_LOG(logError, "Error in readTrackRecording: %s is missing or not a version 1 track recording", path);
+        return false;
+    }
+
+    // Check the count against what is left of the file before allocating, so a corrupt header can not ask for more
+    // memory than the file could ever fill
+    std::streamoff headerEnd = file.tellg();
+    file.seekg(0, std::ios::end);
+    std::streamoff fileEnd = file.tellg();
+    file.seekg(headerEnd);
+    if(!file || headerEnd < 0 || fileEnd < headerEnd
+       || count > (unsigned long long) (fileEnd - headerEnd) / sizeof(TrackUpdate)) {
+        RADAR_LOG(logError, "Error in readTrackRecording: %s is shorter than its header says", path);
+        return false;
+    }
+    updates.resize(count);
+    file.read((char*) updates.data(), (std::streamsize) (count * sizeof(TrackUpdate)));
+    if(!file) {
+        RADAR_LOG(logError, "Error in readTrackRecording: %s is shorter than its header says", path);
+        updates.clear();
+        return false;
+    }
+    return true;
+}
+
+/** Function replayTrackUpdates
+ * Function for one producer thread to push its share of a recording into a feed, as fast as the feed takes them
+ * The recording is split into numberOfProducers interleaved shares, producer p pushing updates p, p+n, p+2n and so on,
+ * so every producer carries a mix of Icons and timestamps like separate radar sites would
+ *
+ * @param updates the whole recording
+ * @param feed the feed to push into
+ * @param producer the number of this producer, 0 to numberOfProducers-1
+ * @param numberOfProducers the number of producers sharing the recording
+ *
+ * @author Daniel Marcovecchio
+ */
+void replayTrackUpdates(const std::vector<TrackUpdate>& updates, MpscRingBuffer<TrackUpdate>& feed, int producer, int numberOfProducers) {
+    for (size_t i = producer; i < updates.size(); i += numberOfProducers) {
+        // When the feed is full, let the display thread run to empty it
+        while (!feed.tryPush(updates[i])) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+/** Struct RadarSceneHeader
+ * The start of a scene file. Version 1 is the layout below
+ */
+struct RadarSceneHeader {
+    char magic[4];
+    unsigned int version;
+    unsigned long long numberOfTemplates;
+    unsigned long long numberOfIcons;
+    unsigned long long templatesOffset;
+    unsigned long long iconsOffset;
+};
+
+struct SceneTemplateRecord {
+    unsigned int templateId;
+    // The template name, cut short to fit if it is longer, and always ending in a zero byte
+    char name[28];
+    float pixelXCoords[iconPixelsNumber];
+    float pixelYCoords[iconPixelsNumber];
+    unsigned char pixelBrightness[iconPixelsNumber];
+};
+
+struct SceneIconRecord {
+    double lastUpdateTime;
+    int id;
+    unsigned int templateIndex;
+    float xPosition;
+    float yPosition;
+    unsigned char brightness;
+    unsigned char padding[7];
+};
+
+static_assert(sizeof(RadarSceneHeader) == 40, "RadarSceneHeader is the layout of scene files and must be 40 bytes");
+static_assert(sizeof(SceneTemplateRecord) == 176, "SceneTemplateRecord is the layout of scene files and must be 176 bytes");
+static_assert(sizeof(SceneIconRecord) == 32, "SceneIconRecord is the layout of scene files and must be 32 bytes");
+
+/** Function writeRadarScene
+ * Function to save every active Icon of a display and the shapes they use to a scene file
+ * Icons sharing a template share one template record, and an Icon with its own edited shape gets a record of its own
+ *
+ * @param path the file to write
+ * @param radar the display to save
+ *
+ * @return true if the whole file was written
+ *
+ * @author Daniel Marcovecchio
+ */
+bool writeRadarScene(const char* path, const RadarDisplay& radar) {
+    // Give each different shape a record, in the order the Icons first use them
+    const size_t numberOfIcons = radar.getNumberOfActiveIcons();
+    std::unordered_map<const IconTemplate*, unsigned int> indexOfShape;
+    std::vector<SceneTemplateRecord> templateRecords;
+    std::vector<SceneIconRecord> iconRecords(numberOfIcons);
+    for (size_t i = 0; i < numberOfIcons; i++) {
+        const Icon* icon = radar.getActiveIcon(i);
+        const IconTemplate* shape = icon->getShape().get();
+        auto found = indexOfShape.find(shape);
+        if(found == indexOfShape.end()) {
+            SceneTemplateRecord record;
+            std::memset(&record, 0, sizeof(record));
+            record.templateId = shape->templateId;
+            std::strncpy(record.name, shape->name.c_str(), sizeof(record.name) - 1);
+            std::memcpy(record.pixelXCoords, shape->pixelXCoords, sizeof(record.pixelXCoords));
+            std::memcpy(record.pixelYCoords, shape->pixelYCoords, sizeof(record.pixelYCoords));
+            std::memcpy(record.pixelBrightness, shape->pixelBrightness, sizeof(record.pixelBrightness));
+            found = indexOfShape.emplace(shape, (unsigned int) templateRecords.size()).first;
+            templateRecords.push_back(record);
+        }
+        SceneIconRecord& record = iconRecords[i];
+        std::memset(&record, 0, sizeof(record));
+        record.lastUpdateTime = icon->lastUpdateTime;
+        record.id = icon->id;
+        record.templateIndex = found->second;
+        record.xPosition = icon->xPosition;
+        record.yPosition = icon->yPosition;
+        record.brightness = icon->brightness;
+    }
+
+    RadarSceneHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, "RSCN", 4);
+    header.version = 1;
+    header.numberOfTemplates = templateRecords.size();
+    header.numberOfIcons = iconRecords.size();
+    header.templatesOffset = sizeof(RadarSceneHeader);
+    header.iconsOffset = header.templatesOffset + templateRecords.size() * sizeof(SceneTemplateRecord);
+
+    std::ofstream file(path, std::ios::binary);
+    if(!file) {
+        RADAR_LOG(logError, "Error in writeRadarScene: could not open %s", path);
+        return false;
+    }
+    file.write((const char*) &header, sizeof(header));
+    file.write((const char*) templateRecords.data(), (std::streamsize) (templateRecords.size() * sizeof(SceneTemplateRecord)));
+    file.write((const char*) iconRecords.data(), (std::streamsize) (iconRecords.size() * sizeof(SceneIconRecord)));
+    return (bool) file;
+}
+
+class MappedRadarScene {
+    // Mapped scene class, giving read-only access to the records of a scene file in place
+
+    private:
+        const unsigned char* data;
+        size_t size;
+        // Where memory mapping is not available the file is read into this buffer instead
+        std::vector<unsigned long long> readBuffer;
+        const RadarSceneHeader* header;
+        const SceneTemplateRecord* templateRecords;
+        const SceneIconRecord* iconRecords;
+
+    public:
+        MappedRadarScene() : data(nullptr), size(0), header(nullptr), templateRecords(nullptr), iconRecords(nullptr) {}
+        ~MappedRadarScene() { close(); }
+        MappedRadarScene(const MappedRadarScene&) = delete;
+        MappedRadarScene& operator=(const MappedRadarScene&) = delete;
+
+        /** Methods open and close
+         * Methods to map a scene file in, checking its header and that its tables fit in the file, and to unmap it
+         *
+         * @param path the scene file to open
+         *
+         * @return true if the file is a version 1 scene and is now open
+         *
+         * @author Daniel Marcovecchio
+         */
+        bool open(const char* path);
+        void close();
+
+        bool isOpen() const { return header != nullptr; }
+        size_t getNumberOfTemplates() const { return header != nullptr ? (size_t) header->numberOfTemplates : 0; }
+        size_t getNumberOfIcons() const { return header != nullptr ? (size_t) header->numberOfIcons : 0; }
+        const SceneTemplateRecord& getTemplateRecord(size_t index) const { return templateRecords[index]; }
+        const SceneIconRecord& getIconRecord(size_t index) const { return iconRecords[index]; }
+
+        /** Method restore
+         * Method to rebuild the scene on a display. Each template record becomes one shared shape, and each Icon
+         * record an Icon in icons, which is cleared first and must then outlive its Icons' time on the display
+         *
+         * @param radar the display to add the Icons to
+         * @param icons where the Icons are made
+         *
+         * @return the number of Icons added. Icons with an ID already on the display or a bad template are skipped
+         *
+         * @author Daniel Marcovecchio
+         */
+        size_t restore(RadarDisplay& radar, std::vector<Icon>& icons) const;
+};
+
+bool MappedRadarScene::open(const char* path) {
+    // Implementation of open
+
+    close();
+#if defined(__unix__) || defined(__APPLE__)
+    int fileDescriptor = ::open(path, O_RDONLY);
+    if(fileDescriptor < 0) {
+        RADAR_LOG(logError, "Error in open in MappedRadarScene: could not open %s", path);
+        return false;
+    }
+    struct stat fileStatus;
+    if(fstat(fileDescriptor, &fileStatus) != 0 || fileStatus.st_size < (off_t) sizeof(RadarSceneHeader)) {
+        RADAR_LOG(logError, "Error in open in MappedRadarScene: %s is too short to be a scene", path);
+        ::close(fileDescriptor);
+        return false;
+    }
+    size = (size_t) fileStatus.st_size;
+    void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+    // The mapping keeps the file open on its own
+    ::close(fileDescriptor);
+    if(mapping == MAP_FAILED) {
+        RADAR_LOG(logError, "Error in open in MappedRadarScene: could not map %s", path);
+        size = 0;
+        return false;
+    }
+    data = (const unsigned char*) mapping;
+#else
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if(!file) {
+        RADAR_LOG(logError, "Error in open in MappedRadarScene: could not open %s", path);
+        return false;
+    }
+    size = (size_t) file.tellg();
+    // Read into 8 byte words so the records are aligned the same as in a mapping
+    readBuffer.resize((size + 7) / 8);
+    file.seekg(0);
+    file.read((char*) readBuffer.data(), (std::streamsize) size);
+    if(!file || size < sizeof(RadarSceneHeader)) {
+        RADAR_LOG(logError, "Error in open in MappedRadarScene: could not read %s", path);
+        close();
+        return false;
+    }
+    data = (const unsigned char*) readBuffer.data();
+#endif
+
+    // Check the header, and that both tables lie inside the file and are aligned for their records. Each count is
+    // checked against the room left after its offset, as offset + count * record size could wrap past zero
+    const RadarSceneHeader* candidate = (const RadarSceneHeader*) data;
+    if(std::memcmp(candidate->magic, "RSCN", 4) != 0 || candidate->version != 1) {
+        RADAR_LOG(logError, "Error in open in MappedRadarScene: %s is not a version 1 scene", path);
+        close();
+        return false;
+    }
+    if(candidate->templatesOffset > size || candidate->iconsOffset > size
+       || candidate->templatesOffset % 8 != 0 || candidate->iconsOffset % 8 != 0
+       || candidate->numberOfTemplates > (size - candidate->templatesOffset) / sizeof(SceneTemplateRecord)
+       || candidate->numberOfIcons > (size - candidate->iconsOffset) / sizeof(SceneIconRecord)) {
+        RADAR_LOG(logError, "Error in open in MappedRadarScene: %s is shorter than its header says", path);
+        close();
+        return false;
+    }
+    header = candidate;
+    templateRecords = (const SceneTemplateRecord*) (data + header->templatesOffset);
+    iconRecords = (const SceneIconRecord*) (data + header->iconsOffset);
+    return true;
+}
+
+void MappedRadarScene::close() {
+#if defined(__unix__) || defined(__APPLE__)
+    if(data != nullptr) {
+        munmap((void*) data, size);
+    }
+#else
+    readBuffer.clear();
+    readBuffer.shrink_to_fit();
+#endif
+    data = nullptr;
+    size = 0;
+    header = nullptr;
+    templateRecords = nullptr;
+    iconRecords = nullptr;
+}
+
+size_t MappedRadarScene::restore(RadarDisplay& radar, std::vector<Icon>& icons) const {
+    // Implementation of restore
+
+    const size_t numberOfTemplates = getNumberOfTemplates();
+    const size_t numberOfIcons = getNumberOfIcons();
+    std::vector<std::shared_ptr<const IconTemplate>> shapes(numberOfTemplates);
+    for (size_t t = 0; t < numberOfTemplates; t++) {
+        const SceneTemplateRecord& record = templateRecords[t];
+        std::shared_ptr<IconTemplate> shape = std::make_shared<IconTemplate>(record.templateId,
+                std::string(record.name, strnlen(record.name, sizeof(record.name))));
+        std::memcpy(shape->pixelXCoords, record.pixelXCoords, sizeof(record.pixelXCoords));
+        std::memcpy(shape->pixelYCoords, record.pixelYCoords, sizeof(record.pixelYCoords));
+        std::memcpy(shape->pixelBrightness, record.pixelBrightness, sizeof(record.pixelBrightness));
+        shapes[t] = shape;
+    }
+
+    // Make every Icon before adding any, so the vector does not move them once the display holds them
+    icons.clear();
+    icons.reserve(numberOfIcons);
+    for (size_t i = 0; i < numberOfIcons; i++) {
+        const SceneIconRecord& record = iconRecords[i];
+        if(record.templateIndex >= numberOfTemplates) {
+            RADAR_LOG(logError, "Error in restore in MappedRadarScene: Icon ID %d has no template %u", record.id, record.templateIndex);
+            continue;
+        }
+        icons.emplace_back(record.id, shapes[record.templateIndex]);
+        Icon& icon = icons.back();
+        icon.setPosition(record.xPosition, record.yPosition);
+        icon.brightness = record.brightness;
+        icon.lastUpdateTime = record.lastUpdateTime;
+    }
+    radar.reserveIcons(radar.getNumberOfActiveIcons() + icons.size());
+    size_t added = 0;
+    for (Icon& icon : icons) {
+        added += radar.addIcon(&icon).isValid();
+    }
+    return added;
+}
+
+class RadarSnapshot {
+    // Snapshot class, a frozen frame of the display. Readers only ever get a const one
+
+    public:
+        std::vector<Icon> icons;
+        SpatialGrid spatialIndex;
+        unsigned long long frameNumber;
+
+        RadarSnapshot() : frameNumber(0) {}
+        ~RadarSnapshot() = default;
+
+        /** Methods getNumberOfActiveIcons and getActiveIcon
+         * Methods to walk every Icon of the snapshot, the same as on RadarDisplay so the renderer can draw either
+         *
+         * @author Daniel Marcovecchio
+         */
+        size_t getNumberOfActiveIcons() const { return icons.size(); }
+        const Icon* getActiveIcon(size_t index) const { return &icons[index]; }
+
+        /** Methods findIconsInRange and findNearestIcons
+         * Methods to query the snapshot's spatial index, safe for any number of readers at once
+         *
+         * @param found the list the Icons are written to, replacing what it held
+         *
+         * @author Daniel Marcovecchio
+         */
+        void findIconsInRange(float x, float y, float range, std::vector<const Icon*>& found) const;
+        void findNearestIcons(float x, float y, size_t k, std::vector<const Icon*>& found) const;
+};
+
+void RadarSnapshot::findIconsInRange(float x, float y, float range, std::vector<const Icon*>& found) const {
+    std::vector<unsigned int> points;
+    spatialIndex.findInRange(x, y, range, points);
+    found.clear();
+    for (unsigned int index : points) {
+        found.push_back(&icons[index]);
+    }
+}
+
+void RadarSnapshot::findNearestIcons(float x, float y, size_t k, std::vector<const Icon*>& found) const {
+    std::vector<unsigned int> points;
+    spatialIndex.findNearest(x, y, k, points);
+    found.clear();
+    for (unsigned int index : points) {
+        found.push_back(&icons[index]);
+    }
+}
+
+class RadarSnapshotBuffer {
+    // Snapshot buffer class, handing the latest snapshot from the display thread to reader threads
+
+    private:
+        // Readers of different buffers update the counts at the same time, so each count is padded onto its own cache line
+        struct SnapshotSlot {
+            std::atomic<int> readers;
+            char padding[64];
+            RadarSnapshot snapshot;
+        };
+
+        std::unique_ptr<SnapshotSlot[]> slots;
+        size_t numberOfSlots;
+        std::atomic<size_t> currentSlot;
+        unsigned long long framesPublished;
+
+    public:
+        /** Constructor RadarSnapshotBuffer
+         * Makes the buffers, the first starting as an empty current snapshot so readers always get one
+         *
+         * @param numberOfSlots the number of snapshot buffers, at least 3 so the display thread always has one to write
+         * while readers hold the current and previous snapshots
+         *
+         * @author Daniel Marcovecchio
+         */
+        explicit RadarSnapshotBuffer(size_t numberOfSlots = 3);
+        ~RadarSnapshotBuffer() = default;
+
+        /** Method publish
+         * Method for the display thread to copy the display into a free buffer, then make it the current snapshot
+         * Only one thread may publish. If readers hold every other buffer, this waits for one of them to be released
+         * Icons are copied over the buffer's previous copies, so those still drawn with the same template are copied
+         * without touching the template's shared use count
+         *
+         * @param radar the display to copy
+         *
+         * @return the frameNumber of the new snapshot
+         *
+         * @author Daniel Marcovecchio
+         */
+        unsigned long long publish(const RadarDisplay& radar);
+
+        /** Methods acquire and release
+         * Methods for reader threads to take the current snapshot and give it back once done
+         * The snapshot is not changed while it is held, so readers should release it promptly to keep buffers free
+         *
+         * @author Daniel Marcovecchio
+         */
+        const RadarSnapshot* acquire();
+        void release(const RadarSnapshot* snapshot);
+};
+
+RadarSnapshotBuffer::RadarSnapshotBuffer(size_t numberOfSlots) : numberOfSlots(std::max(numberOfSlots, (size_t) 3)), currentSlot(0),
+                                                                framesPublished(0) {
+    slots.reset(new SnapshotSlot[this->numberOfSlots]);
+    for (size_t i = 0; i < this->numberOfSlots; i++) {
+        slots[i].readers.store(0);
+    }
+}
+
+unsigned long long RadarSnapshotBuffer::publish(const RadarDisplay& radar) {
+    // Implementation of publish
+
+    // Find a buffer that is not current and that no reader holds. A reader that took the current index just before
+    // it changes, and has not yet counted itself, will see the index change and let go again, so a count of zero
+    // here means nobody will read this buffer
+    size_t current = currentSlot.load();
+    size_t slot = numberOfSlots;
+    while (slot == numberOfSlots) {
+        for (size_t i = 0; i < numberOfSlots; i++) {
+            if(i != current && slots[i].readers.load() == 0) {
+                slot = i;
+                break;
+            }
+        }
+        if(slot == numberOfSlots) {
+            std::this_thread::yield();
+        }
+    }
+
+    // Copy the Icons over the ones this buffer held last time, so an Icon still drawn with the same template keeps
+    // the shared pointer it already has and its use count is not touched. Only Icons past the old end are constructed
+    RadarSnapshot& snapshot = slots[slot].snapshot;
+    size_t numberOfIcons = radar.getNumberOfActiveIcons();
+    if(snapshot.icons.size() > numberOfIcons) {
+        snapshot.icons.erase(snapshot.icons.begin() + numberOfIcons, snapshot.icons.end());
+    }
+    snapshot.icons.reserve(numberOfIcons);
+    std::vector<float> xs(numberOfIcons), ys(numberOfIcons);
+    for (size_t i = 0; i < numberOfIcons; i++) {
+        const Icon* icon = radar.getActiveIcon(i);
+        if(i < snapshot.icons.size()) {
+            snapshot.icons[i].copyFrom(*icon);
+        } else {
+            snapshot.icons.push_back(*icon);
+        }
+        xs[i] = icon->xPosition;
+        ys[i] = icon->yPosition;
+    }
+    snapshot.spatialIndex.build(xs.data(), ys.data(), numberOfIcons);
+    snapshot.frameNumber = ++framesPublished;
+
+    // Make it current. The sequentially consistent store pairs with the loads in acquire
+    currentSlot.store(slot);
+    return snapshot.frameNumber;
+}
+
+const RadarSnapshot* RadarSnapshotBuffer::acquire() {
+    // Implementation of acquire
+
+    // Count ourselves as a reader of the current buffer, then check it is still current. If it changed in between,
+    // the display thread may already be writing to it, so let go and try the new one
+    for (;;) {
+        size_t slot = currentSlot.load();
+        slots[slot].readers.fetch_add(1);
+        if(currentSlot.load() == slot) {
+            return &slots[slot].snapshot;
+        }
+        slots[slot].readers.fetch_sub(1);
+    }
+}
+
+void RadarSnapshotBuffer::release(const RadarSnapshot* snapshot) {
+    // Find the buffer holding this snapshot and count one less reader
+    for (size_t i = 0; i < numberOfSlots; i++) {
+        if(&slots[i].snapshot == snapshot) {
+            slots[i].readers.fetch_sub(1);
+            return;
+        }
+    }
+}
+
+class RadarFramebuffer {
+    // Framebuffer class holding one rendered frame of the display
+
+    // Public, as the frame is plain image data that other parts of the program should be free to read
+    public:
+        int width;
+        int height;
+        std::vector<unsigned char> brightness;
+
+        // Constructor, making a frame of the given size with every pixel dark
+        RadarFramebuffer(int width, int height) : width(width), height(height), brightness((size_t) width * height, 0) {}
+        ~RadarFramebuffer() = default;
+
+        /** Method writePGM
+         * Method to save the frame as a binary PGM image, with a maxval of 20 so brightness values are written as they are
+         *
+         * @param path the file to write
+         *
+         * @return true if the file was written
+         *
+         * @author Daniel Marcovecchio
+         */
+        bool writePGM(const char* path) const;
+};
+
+bool RadarFramebuffer::writePGM(const char* path) const {
+    // Implementation of writePGM, a text header followed by the pixel bytes row by row
+
+    std::ofstream file(path, std::ios::binary);
+    if(!file) {
+        RADAR_LOG(logError, "Error in writePGM in RadarFramebuffer: could not open %s", path);
+        return false;
+    }
+    file << "P5\n" << width << " " << height << "\n" << maxPixelBrightness << "\n";
+    file.write((const char*) brightness.data(), (std::streamsize) brightness.size());
+    return (bool) file;
+}
+
+class RadarScope {
+    // Scope class, keeping the glow of every pixel between frames
+
+    private:
+        int width;
+        int height;
+        double sweepPeriod;
+        double persistenceHalfLife;
+        // The beam bearing is kept as a double so many small steps do not add up rounding errors
+        double sweepAngle;
+        std::vector<unsigned short> pixelAngles;
+        std::vector<unsigned char> persistence;
+
+    public:
+        // The glow the beam itself leaves on empty pixels as it passes, out of 255
+        unsigned char beamBrightness;
+
+        /** Constructor RadarScope
+         * Makes a dark scope with the beam pointing up, working out the bearing of every pixel once
+         *
+         * @param width and height the size of the scope, which should match the frames it is given
+         * @param sweepPeriod the seconds the beam takes to go round once
+         * @param persistenceHalfLife the seconds for a glow to fade to half its brightness
+         *
+         * @author Daniel Marcovecchio
+         */
+        RadarScope(int width, int height, double sweepPeriod, double persistenceHalfLife);
+        ~RadarScope() = default;
+
+        /** Method advance
+         * Method to move the scope on by a time step. Every pixel fades, then the pixels in the wedge the beam swept
+         * during the step glow with the contacts of the frame, or faintly with the beam where there is no contact
+         * It is one pass over the scope of byte and 16 bit integer operations with no branches, so the compiler
+         * vectorises it, and the rows are split between threads
+         *
+         * @param contacts the frame of contacts at this time, the same size as the scope
+         * @param seconds the length of the time step
+         *
+         * @author Daniel Marcovecchio
+         */
+        void advance(const RadarFramebuffer& contacts, double seconds);
+
+        const std::vector<unsigned char>& getPersistence() const { return persistence; }
+
+        /** Method writePGM
+         * Method to save the scope as a binary PGM image, with a maxval of 255
+         *
+         * @param path the file to write
+         *
+         * @return true if the file was written
+         *
+         * @author Daniel Marcovecchio
+         */
+        bool writePGM(const char* path) const;
+};
+
+RadarScope::RadarScope(int width, int height, double sweepPeriod, double persistenceHalfLife) : width(width), height(height),
+        sweepPeriod(sweepPeriod), persistenceHalfLife(persistenceHalfLife), sweepAngle(0.0),
+        pixelAngles((size_t) width * height), persistence((size_t) width * height, 0), beamBrightness(24) {
+    // Work out each pixel's bearing clockwise from straight up, which is how radar bearings are measured
+    const double pi = 3.14159265358979323846;
+    double centreX = width / 2.0, centreY = height / 2.0;
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            double bearing = std::atan2(x + 0.5 - centreX, centreY - (y + 0.5));
+            if(bearing < 0.0) {
+                bearing += 2.0 * pi;
+            }
+            pixelAngles[(size_t) y * width + x] = (unsigned short) ((long) (bearing / (2.0 * pi) * 65536.0) & 0xFFFF);
+        }
+    }
+}
+
+void RadarScope::advance(const RadarFramebuffer& contacts, double seconds) {
+    // Implementation of advance
+
+    if(contacts.width != width || contacts.height != height) {
+        RADAR_LOG(logError, "Error in advance in RadarScope: frame is %dx%d but the scope is %dx%d", contacts.width,
+                  contacts.height, width, height);
+        return;
+    }
+
+    // The fade is a multiply by a fraction out of 256, chosen so glows halve every persistenceHalfLife seconds
+    const unsigned short fade = (unsigned short) std::min(std::lround(256.0 * std::pow(0.5, seconds / persistenceHalfLife)), 255L);
+
+    // The wedge swept this step runs from the bearing the beam was on up to, but not including, the bearing it is on
+    // now. Both ends are rounded down the same way, so each step starts exactly where the last one stopped and no
+    // bearing is skipped. A step of a whole turn or more sweeps everything
+    double turn = seconds / sweepPeriod;
+    long startBearing = (long) std::floor(sweepAngle * 65536.0);
+    long endBearing = (long) std::floor((sweepAngle + turn) * 65536.0);
+    unsigned short sweepStart = (unsigned short) (startBearing & 0xFFFF);
+    unsigned int sweepWidth = turn >= 1.0 ? 65536u : (unsigned int) std::min(endBearing - startBearing, 65536L);
+    sweepAngle = std::fmod(sweepAngle + turn, 1.0);
+    // The wedge test below is on 16 bit lanes, so it uses the last bearing in the wedge rather than its width. A step
+    // too short for the beam to reach the next bearing lights nothing, which litMask takes care of
+    const unsigned short sweepLast = (unsigned short) (sweepWidth == 0 ? 0 : sweepWidth - 1);
+    const unsigned short litMask = sweepWidth == 0 ? 0 : 0xFFFF;
+
+    const unsigned char* contactBrightness = contacts.brightness.data();
+    const unsigned short* angles = pixelAngles.data();
+    unsigned char* glow = persistence.data();
+    const unsigned short beam = beamBrightness;
+    // Copied to locals so the compiler knows the writes to glow can not change the loop bounds
+    const int rows = height;
+    const int rowLength = width;
+
+    // Every value fits in 16 bits, glow times fade is at most 255 * 255 and contact brightness times 51 at most
+    // 20 * 51, so the loop works on 16 bit lanes, twice as many per vector as 32 bit ones
+    #pragma omp parallel for schedule(static)
+    for (int y = 0; y < rows; y++) {
+        const size_t rowStart = (size_t) y * rowLength;
+        #pragma omp simd
+        for (int x = 0; x < rowLength; x++) {
+            size_t i = rowStart + x;
+            // Fade, then light the pixel if the beam passed it. Contact brightness 0 to 20 is scaled up to 0 to 255
+            unsigned short faded = (unsigned short) ((unsigned short) (glow[i] * fade) >> 8);
+            unsigned short contact = (unsigned short) ((unsigned short) (contactBrightness[i] * 51) >> 2);
+            unsigned short lit = (unsigned short) ((contact > beam ? contact : beam) & litMask);
+            lit = (unsigned short) (angles[i] - sweepStart) <= sweepLast ? lit : 0;
+            glow[i] = (unsigned char) (faded > lit ? faded : lit);
+        }
+    }
+}
+
+bool RadarScope::writePGM(const char* path) const {
+    std::ofstream file(path, std::ios::binary);
+    if(!file) {
+        RADAR_LOG(logError, "Error in writePGM in RadarScope: could not open %s", path);
+        return false;
+    }
+    file << "P5\n" << width << " " << height << "\n255\n";
+    file.write((const char*) persistence.data(), (std::streamsize) persistence.size());
+    return (bool) file;
+}
+
+class RadarReturnConverter {
+    // Converter class, turning radar returns into display coordinates
+
+    private:
+        int bearingBits;
+        float centreX;
+        float centreY;
+        float pixelsPerMetre;
+        std::vector<float> eastTable;
+        std::vector<float> southTable;
+
+    public:
+        /** Constructor RadarReturnConverter
+         * Makes a converter for a display of the given size, working out the tables once. Bearings are clockwise from
+         * straight up, and the range maxRange reaches the nearest edge of the display
+         *
+         * @param width and height the size of the display in pixels
+         * @param maxRange the range in metres shown at the edge of the display
+         * @param bearingBits the angular resolution of the tables, from 1 to 16. Bearings are rounded to the nearest
+         * table entry, so 16 converts every 16 bit bearing exactly and fewer bits trade accuracy for smaller tables
+         *
+         * @author Daniel Marcovecchio
+         */
+        RadarReturnConverter(int width, int height, float maxRange, int bearingBits = 16);
+        ~RadarReturnConverter() = default;
+
+        /** Method convert
+         * Method to convert a batch of returns, such as a whole sweep, into display coordinates
+         * Returns beyond maxRange are converted too, landing outside the display
+         *
+         * @param ranges the range of every return in metres
+         * @param bearings the bearing of every return clockwise from straight up, as a fraction of a turn in 16 bits
+         * @param count the number of returns
+         * @param xs and ys which are set to the display position of every return, and may not overlap the inputs
+         *
+         * @author Daniel Marcovecchio
+         */
+        void convert(const float* ranges, const unsigned short* bearings, size_t count, float* xs, float* ys) const;
+
+        int getBearingBits() const { return bearingBits; }
+};
+
+RadarReturnConverter::RadarReturnConverter(int width, int height, float maxRange, int bearingBits) : bearingBits(bearingBits),
+        centreX(width / 2.0f), centreY(height / 2.0f), pixelsPerMetre(1.0f) {
+    if(bearingBits < 1 || bearingBits > 16) {
+        RADAR_LOG(logError, "Error in RadarReturnConverter Constructor: bearingBits was %d, not 1 to 16, value defaulted to 16", bearingBits);
+        this->bearingBits = 16;
+    }
+    if(maxRange > 0.0f) {
+        pixelsPerMetre = std::min(width, height) / 2.0f / maxRange;
+    } else {
+        RADAR_LOG(logError, "Error in RadarReturnConverter Constructor: maxRange was not above zero, value defaulted to one pixel per metre");
+    }
+
+    // The tables hold the screen offsets already scaled to pixels. Screen y grows downwards, so north is minus y
+    const double pi = 3.14159265358979323846;
+    size_t tableSize = (size_t) 1 << this->bearingBits;
+    eastTable.resize(tableSize);
+    southTable.resize(tableSize);
+    for (size_t b = 0; b < tableSize; b++) {
+        double bearing = 2.0 * pi * (double) b / (double) tableSize;
+        eastTable[b] = (float) (std::sin(bearing) * pixelsPerMetre);
+        southTable[b] = (float) (-std::cos(bearing) * pixelsPerMetre);
+    }
+}
+
+void RadarReturnConverter::convert(const float* ranges, const unsigned short* bearings, size_t count, float* xs, float* ys) const {
+    // Implementation of convert
+
+    // Blocks of returns are shared between threads, big enough that starting the threads costs far less than the work
+    const size_t blockSize = 16384;
+    const long long numberOfBlocks = (long long) ((count + blockSize - 1) / blockSize);
+    // A bearing is rounded to its table entry by adding half an entry and dropping the bits below the resolution
+    const unsigned int shift = 16u - (unsigned int) bearingBits;
+    const unsigned int half = shift > 0 ? 1u << (shift - 1) : 0u;
+    const unsigned int mask = (1u << bearingBits) - 1u;
+    const float* east = eastTable.data();
+    const float* south = southTable.data();
+    const float x0 = centreX, y0 = centreY;
+
+    #pragma omp parallel for schedule(static) if(numberOfBlocks > 1)
+    for (long long block = 0; block < numberOfBlocks; block++) {
+        const size_t begin = (size_t) block * blockSize;
+        const size_t end = std::min(begin + blockSize, count);
+        #pragma omp simd
+        for (size_t i = begin; i < end; i++) {
+            unsigned int entry = ((bearings[i] + half) >> shift) & mask;
+            xs[i] = x0 + ranges[i] * east[entry];
+            ys[i] = y0 + ranges[i] * south[entry];
+        }
+    }
+}
+
+/** Struct RenderStats
+ * RenderStats reports the work done drawing one frame
+ * @property tilesRedrawn the number of tiles cleared and drawn
+ * @property iconsTransformed the number of Icons whose screen pixels were worked out
+ *
+ * @author Daniel Marcovecchio
+ */
+struct RenderStats {
+    size_t tilesRedrawn;
+    size_t iconsTransformed;
+};
+
+class RadarRenderer {
+    // Renderer class, drawing a RadarDisplay into a RadarFramebuffer
+
+    // The working memory is private, it is only used while rendering
+    private:
+        // The screen pixels of one Icon for the frame being drawn, worked out once per Icon before any tile is drawn
+        // Pixels that are off-screen or dark have an x of -1 so they are never drawn. This is 80 bytes per Icon, so
+        // drawing a tile reads each of its Icons in one or two cache lines instead of the whole Icon
+        struct ScreenIcon {
+            short x[iconPixelsNumber];
+            short y[iconPixelsNumber];
+            unsigned char brightness[iconPixelsNumber];
+        };
+
+        // The screen pixels of every Icon, in dense array order, and the first and last tile column and row each overlaps
+        std::vector<ScreenIcon> screenIcons;
+        std::vector<int> iconTileBounds;
+        // The Icons overlapping each tile, stored one tile after another. Tile t has the entries from
+        // tileIconStart[t] up to tileIconStart[t+1]
+        std::vector<unsigned int> tileIconStart;
+        std::vector<unsigned int> tileIcons;
+        // The next free entry of each tile while the lists are filled
+        std::vector<unsigned int> tileFill;
+
+        // The state renderChangedTiles keeps between frames: the display and frame it last drew, the screen pixels and
+        // tiles of each display slot as last drawn (empty tiles for free slots), and the tiles to redraw this frame
+        const RadarDisplay* trackedDisplay;
+        const RadarFramebuffer* trackedFrame;
+        int trackedWidth;
+        int trackedHeight;
+        std::vector<ScreenIcon> slotScreenIcons;
+        std::vector<int> slotTileBounds;
+        std::vector<unsigned char> tileDirty;
+        std::vector<unsigned int> changedSlots;
+
+        /** Method transformIcon
+         * Method to work out the screen pixels of one Icon, and which tiles they overlap
+         * The loop has no branches, so the compiler can vectorise it across the pixels of the Icon
+         *
+         * @author Daniel Marcovecchio
+         */
+        static void transformIcon(const Icon* icon, int width, int height, int tileSize, ScreenIcon& screen, int* tileBounds);
+
+        /** Method drawIconInTile
+         * Method to draw the pixels of one Icon that fall inside one tile
+         * The clip test is done for every pixel first, again without branches, then the pixels that survived are
+         * blended into the frame keeping the brightest where they overlap
+         *
+         * @author Daniel Marcovecchio
+         */
+        static void drawIconInTile(const ScreenIcon& screen, RadarFramebuffer& frame, int tileX0, int tileY0, int tileX1, int tileY1);
+
+        /** Method drawTiles
+         * Method to sort Icons into the tiles they overlap, then clear and draw those tiles in parallel
+         *
+         * @param icons and tileBounds the screen pixels and tile bounds of each Icon, four ints per Icon
+         * @param numberOfIcons the number of Icons
+         * @param dirty one flag per tile saying whether to draw it, or nullptr to draw every tile
+         * @param tileSize the width and height of the tiles, which the tile bounds must have been worked out for
+         *
+         * @return the number of tiles drawn
+         *
+         * @author Daniel Marcovecchio
+         */
+        size_t drawTiles(const ScreenIcon* icons, const int* tileBounds, size_t numberOfIcons, const unsigned char* dirty,
+                         int tileSize, RadarFramebuffer& frame);
+
+    public:
+        RadarRenderer() : trackedDisplay(nullptr), trackedFrame(nullptr), trackedWidth(0), trackedHeight(0) {}
+        ~RadarRenderer() = default;
+
+        /** Method renderFrame
+         * Method to render every active Icon of a display into a frame, replacing what the frame held before
+         * The display must not be changed while this runs, so threads other than the display thread should render
+         * a RadarSnapshot instead
+         *
+         * @param radar the RadarDisplay or RadarSnapshot to render
+         * @param frame the frame to draw into, at most 32767 pixels wide and high
+         *
+         * @return the tiles drawn, which is every tile, and the Icons transformed
+         *
+         * @author Daniel Marcovecchio
+         */
+        template <typename IconSource>
+        RenderStats renderFrame(const IconSource& radar, RadarFramebuffer& frame);
+
+        /** Method renderChangedTiles
+         * Method to bring a frame up to date with a display by redrawing only the tiles where Icons were added,
+         * removed, moved or changed since the last call, using the smaller dirtyTileSize tiles
+         * The first call for a display or frame draws every tile
+         * Changes are only seen if made through the display, with moveIcon, markIconChanged or applyTrackUpdates,
+         * and the frame must not be drawn into by anything else between calls
+         *
+         * @param radar the display to render, whose changed slots are taken
+         * @param frame the frame to draw into, at most 32767 pixels wide and high
+         *
+         * @return the tiles redrawn and the Icons transformed
+         *
+         * @author Daniel Marcovecchio
+         */
+        RenderStats renderChangedTiles(RadarDisplay& radar, RadarFramebuffer& frame);
+};
+
+void RadarRenderer::transformIcon(const Icon* icon, int width, int height, int tileSize, ScreenIcon& screen, int* tileBounds) {
+    // Implementation of transformIcon
+
+    const float* xs = icon->getPixelXCoords();
+    const float* ys = icon->getPixelYCoords();
+    const unsigned char* values = icon->getPixelBrightness();
+    const unsigned int iconBrightness = icon->brightness;
+    int minX = width, maxX = -1, minY = height, maxY = -1;
+
+    // Offset every pixel by the Icon position, clamping to just outside the frame so it fits in a short,
+    // and scale its brightness by the Icon brightness
+    for (unsigned int i = 0; i < iconPixelsNumber; i++) {
+        float x = std::floor(xs[i] + icon->xPosition);
+        float y = std::floor(ys[i] + icon->yPosition);
+        unsigned char value = (unsigned char) (values[i] * iconBrightness / maxPixelBrightness);
+        bool visible = value != 0 && x >= 0.0f && x < (float) width && y >= 0.0f && y < (float) height;
+        int screenX = visible ? (int) x : -1;
+        int screenY = visible ? (int) y : -1;
+        screen.x[i] = (short) screenX;
+        screen.y[i] = (short) screenY;
+        screen.brightness[i] = value;
+        minX = std::min(minX, visible ? screenX : width);
+        maxX = std::max(maxX, screenX);
+        minY = std::min(minY, visible ? screenY : height);
+        maxY = std::max(maxY, screenY);
+    }
+
+    // An Icon with nothing visible gets an empty range of tiles
+    if(maxX < 0) {
+        tileBounds[0] = 0; tileBounds[1] = -1; tileBounds[2] = 0; tileBounds[3] = -1;
+        return;
+    }
+    tileBounds[0] = minX / tileSize;
+    tileBounds[1] = maxX / tileSize;
+    tileBounds[2] = minY / tileSize;
+    tileBounds[3] = maxY / tileSize;
+}
+
+void RadarRenderer::drawIconInTile(const ScreenIcon& screen, RadarFramebuffer& frame, int tileX0, int tileY0, int tileX1, int tileY1) {
+    // Implementation of drawIconInTile
+
+    int pixelIndex[iconPixelsNumber];
+
+    // Find the pixels inside this tile, marking the rest with -1
+    for (unsigned int i = 0; i < iconPixelsNumber; i++) {
+        int x = screen.x[i], y = screen.y[i];
+        bool inside = x >= tileX0 && x < tileX1 && y >= tileY0 && y < tileY1;
+        pixelIndex[i] = inside ? y * frame.width + x : -1;
+    }
+    // Blend the pixels that are inside, keeping the brightest where they overlap
+    unsigned char* pixels = frame.brightness.data();
+    for (unsigned int i = 0; i < iconPixelsNumber; i++) {
+        if(pixelIndex[i] >= 0) {
+            pixels[pixelIndex[i]] = std::max(pixels[pixelIndex[i]], screen.brightness[i]);
+        }
+    }
+}
+
+size_t RadarRenderer::drawTiles(const ScreenIcon* icons, const int* tileBounds, size_t numberOfIcons, const unsigned char* dirty,
+                                int tileSize, RadarFramebuffer& frame) {
+    // Implementation of drawTiles
+
+    const int tilesX = (frame.width + tileSize - 1) / tileSize;
+    const int tilesY = (frame.height + tileSize - 1) / tileSize;
+    const int numberOfTiles = tilesX * tilesY;
+
+    // Count the Icons in each tile to be drawn, turn the counts into start offsets, then fill in the lists
+    tileIconStart.assign(numberOfTiles + 1, 0);
+    for (size_t i = 0; i < numberOfIcons; i++) {
+        const int* bounds = &tileBounds[i * 4];
+        for (int ty = bounds[2]; ty <= bounds[3]; ty++) {
+            for (int tx = bounds[0]; tx <= bounds[1]; tx++) {
+                if(dirty == nullptr || dirty[ty * tilesX + tx]) {
+                    tileIconStart[ty * tilesX + tx + 1]++;
+                }
+            }
+        }
+    }
+    for (int t = 0; t < numberOfTiles; t++) {
+        tileIconStart[t + 1] += tileIconStart[t];
+    }
+    tileIcons.resize(tileIconStart[numberOfTiles]);
+    tileFill.assign(tileIconStart.begin(), tileIconStart.end() - 1);
+    for (size_t i = 0; i < numberOfIcons; i++) {
+        const int* bounds = &tileBounds[i * 4];
+        for (int ty = bounds[2]; ty <= bounds[3]; ty++) {
+            for (int tx = bounds[0]; tx <= bounds[1]; tx++) {
+                if(dirty == nullptr || dirty[ty * tilesX + tx]) {
+                    tileIcons[tileFill[ty * tilesX + tx]++] = (unsigned int) i;
+                }
+            }
+        }
+    }
+
+    // Clear and draw every tile to be drawn. Tiles with many Icons take longer, so threads take tiles as they become free
+    size_t tilesDrawn = 0;
+    #pragma omp parallel for schedule(dynamic) reduction(+:tilesDrawn)
+    for (int t = 0; t < numberOfTiles; t++) {
+        if(dirty != nullptr && !dirty[t]) {
+            continue;
+        }
+        int tileX0 = (t % tilesX) * tileSize, tileY0 = (t / tilesX) * tileSize;
+        int tileX1 = std::min(tileX0 + tileSize, frame.width), tileY1 = std::min(tileY0 + tileSize, frame.height);
+        for (int y = tileY0; y < tileY1; y++) {
+            std::memset(&frame.brightness[(size_t) y * frame.width + tileX0], 0, tileX1 - tileX0);
+        }
+        for (unsigned int e = tileIconStart[t]; e < tileIconStart[t + 1]; e++) {
+            drawIconInTile(icons[tileIcons[e]], frame, tileX0, tileY0, tileX1, tileY1);
+        }
+        tilesDrawn++;
+    }
+    return tilesDrawn;
+}
+
+template <typename IconSource>
+RenderStats RadarRenderer::renderFrame(const IconSource& radar, RadarFramebuffer& frame) {
+    // Implementation of renderFrame, which works out every Icon's screen pixels then draws every tile
+
+    const int numberOfIcons = (int) radar.getNumberOfActiveIcons();
+    screenIcons.resize(numberOfIcons);
+    iconTileBounds.resize((size_t) numberOfIcons * 4);
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < numberOfIcons; i++) {
+        transformIcon(radar.getActiveIcon(i), frame.width, frame.height, renderTileSize, screenIcons[i], &iconTileBounds[(size_t) i * 4]);
+    }
+    size_t tilesRedrawn = drawTiles(screenIcons.data(), iconTileBounds.data(), numberOfIcons, nullptr, renderTileSize, frame);
+    return RenderStats{tilesRedrawn, (size_t) numberOfIcons};
+}
+
+RenderStats RadarRenderer::renderChangedTiles(RadarDisplay& radar, RadarFramebuffer& frame) {
+    // Implementation of renderChangedTiles
+
+    const int tilesX = (frame.width + dirtyTileSize - 1) / dirtyTileSize;
+    const int tilesY = (frame.height + dirtyTileSize - 1) / dirtyTileSize;
+    const size_t numberOfSlots = radar.getNumberOfSlots();
+    size_t iconsTransformed = 0;
+    radar.takeChangedSlots(changedSlots);
+
+    // Slots added since the last frame start with no tiles, and will be in the changed list if they hold an Icon
+    size_t trackedSlots = slotScreenIcons.size();
+    slotScreenIcons.resize(numberOfSlots);
+    slotTileBounds.resize(numberOfSlots * 4);
+    for (size_t slot = trackedSlots; slot < numberOfSlots; slot++) {
+        int* bounds = &slotTileBounds[slot * 4];
+        bounds[0] = 0; bounds[1] = -1; bounds[2] = 0; bounds[3] = -1;
+    }
+
+    bool redrawAll = trackedDisplay != &radar || trackedFrame != &frame || trackedWidth != frame.width || trackedHeight != frame.height;
+    if(redrawAll) {
+        // Nothing is known about what the frame holds, so work out every slot and draw every tile
+        trackedDisplay = &radar;
+        trackedFrame = &frame;
+        trackedWidth = frame.width;
+        trackedHeight = frame.height;
+        tileDirty.assign((size_t) tilesX * tilesY, 1);
+        #pragma omp parallel for schedule(static)
+        for (long slot = 0; slot < (long) numberOfSlots; slot++) {
+            int* bounds = &slotTileBounds[slot * 4];
+            const Icon* icon = radar.getIconInSlot((unsigned int) slot);
+            if(icon != nullptr) {
+                transformIcon(icon, frame.width, frame.height, dirtyTileSize, slotScreenIcons[slot], bounds);
+            } else {
+                bounds[0] = 0; bounds[1] = -1; bounds[2] = 0; bounds[3] = -1;
+            }
+        }
+        iconsTransformed = radar.getNumberOfActiveIcons();
+    } else {
+        // Mark the tiles each changed slot was drawn on last frame, work it out again, then mark the tiles it is on now
+        tileDirty.assign((size_t) tilesX * tilesY, 0);
+        for (unsigned int slot : changedSlots) {
+            int* bounds = &slotTileBounds[(size_t) slot * 4];
+            for (int pass = 0; pass < 2; pass++) {
+                for (int ty = bounds[2]; ty <= bounds[3]; ty++) {
+                    for (int tx = bounds[0]; tx <= bounds[1]; tx++) {
+                        tileDirty[ty * tilesX + tx] = 1;
+                    }
+                }
+                if(pass == 0) {
+                    const Icon* icon = radar.getIconInSlot(slot);
+                    if(icon != nullptr) {
+                        transformIcon(icon, frame.width, frame.height, dirtyTileSize, slotScreenIcons[slot], bounds);
+                        iconsTransformed++;
+                    } else {
+                        bounds[0] = 0; bounds[1] = -1; bounds[2] = 0; bounds[3] = -1;
+                    }
+                }
+            }
+        }
+    }
+
+    // Redraw the marked tiles from every slot overlapping them, which reads only the small per-slot tile bounds of
+    // slots that did not change
+    size_t tilesRedrawn = drawTiles(slotScreenIcons.data(), slotTileBounds.data(), numberOfSlots, tileDirty.data(), dirtyTileSize, frame);
+    return RenderStats{tilesRedrawn, iconsTransformed};
+}
+
+struct CollisionAlert {
+    int firstId;
+    int secondId;
+    float closestDistance;
+    float timeToClosest;
+    bool isNew;
+};
+
+class CollisionMonitor {
+    // Collision monitor class, keeping the contact tracks and working memory between frames
+
+    private:
+        // What is known of the Icon in a display slot, the ID telling whether the slot has since been given another Icon
+        struct ContactTrack {
+            int id;
+            float x;
+            float y;
+            float velocityX;
+            float velocityY;
+            double lastMoveTime;
+        };
+        std::vector<ContactTrack> slotTracks;
+        std::vector<unsigned char> slotTracked;
+
+        // A contact this frame, with the middle of its path over the look-ahead time and its reach, half of how far it
+        // travels in that time, which is how far it can get from the middle of its path
+        struct ContactPath {
+            float x;
+            float y;
+            float velocityX;
+            float velocityY;
+            float middleX;
+            float middleY;
+            float reach;
+            int id;
+        };
+
+        // The contacts reaching up to four times alertDistance are in class 0, as reaches that short widen a search
+        // less than searching another grid costs. Each class after reaches up to twice as far as the one before, and
+        // the last holds all the rest. Points in a class's grid are its entries in paths. The InCellOrder lists hold the
+        // same contacts in the grid's cell order, so the contacts of a run of cells are read one after another, with the
+        // middles and reaches also kept on their own for the first check of every pair
+        static const int numberOfSpeedClasses = 12;
+        struct SpeedClass {
+            std::vector<ContactPath> paths;
+            std::vector<float> pathMiddleX;
+            std::vector<float> pathMiddleY;
+            float furthestReach;
+            SpatialGrid pathGrid;
+            std::vector<ContactPath> pathsInCellOrder;
+            std::vector<float> middleXInCellOrder;
+            std::vector<float> middleYInCellOrder;
+            std::vector<float> reachInCellOrder;
+        };
+        SpeedClass speedClasses[numberOfSpeedClasses];
+
+        // The pairs alerted last frame as (lower ID, higher ID) keys, sorted, and each thread's alerts for this frame
+        std::vector<unsigned long long> alertedPairs;
+        std::vector<unsigned long long> framePairs;
+        std::vector<std::vector<CollisionAlert>> threadAlerts;
+        std::vector<CollisionAlert> sortScratch;
+
+        // The key of a pair of IDs, the same whichever way round they are given
+        static unsigned long long pairKey(int firstId, int secondId) {
+            return ((unsigned long long) (unsigned int) std::min(firstId, secondId) << 32) | (unsigned int) std::max(firstId, secondId);
+        }
+
+        // Sorts alerts by key(alert), an unsigned integer of keyBytes bytes, one byte at a time from the lowest. Each pass
+        // is a counting sort that keeps alerts with the same byte in order, so the whole sort is stable, and a byte every
+        // alert shares is skipped. Frames can have tens of thousands of alerts, which this sorts in a few passes
+        template <typename Key>
+        void sortAlertsByKey(std::vector<CollisionAlert>& alerts, int keyBytes, Key key) {
+            sortScratch.resize(alerts.size());
+            for (int shift = 0; shift < keyBytes * 8; shift += 8) {
+                size_t offsets[257] = {};
+                for (const CollisionAlert& alert : alerts) {
+                    offsets[((key(alert) >> shift) & 0xFF) + 1]++;
+                }
+                if(std::find(offsets + 1, offsets + 257, alerts.size()) != offsets + 257) {
+                    continue;
+                }
+                for (int digit = 0; digit < 256; digit++) {
+                    offsets[digit + 1] += offsets[digit];
+                }
+                for (const CollisionAlert& alert : alerts) {
+                    sortScratch[offsets[(key(alert) >> shift) & 0xFF]++] = alert;
+                }
+                alerts.swap(sortScratch);
+            }
+        }
+
+        // Adds an alert to found if a and b come within alertDistance of each other in the look-ahead time
+        void checkPair(const ContactPath& a, const ContactPath& b, std::vector<CollisionAlert>& found) const {
+            float relativeX = b.x - a.x, relativeY = b.y - a.y;
+            float closingX = b.velocityX - a.velocityX, closingY = b.velocityY - a.velocityY;
+            float closingSquared = closingX * closingX + closingY * closingY;
+            // The time the separation is smallest, held to the look-ahead window
+            float time = closingSquared > 0.0f ? -(relativeX * closingX + relativeY * closingY) / closingSquared : 0.0f;
+            time = std::min(std::max(time, 0.0f), (float) lookAhead);
+            float closestX = relativeX + closingX * time, closestY = relativeY + closingY * time;
+            float distanceSquared = closestX * closestX + closestY * closestY;
+            if(distanceSquared <= alertDistance * alertDistance) {
+                found.push_back(CollisionAlert{std::min(a.id, b.id), std::max(a.id, b.id), std::sqrt(distanceSquared), time, false});
+            }
+        }
+
+    public:
+        float alertDistance;
+        double lookAhead;
+        double coastTime;
+        // Whether new alerts are logged. Public so it can be turned off when the caller raises the alerts itself
+        bool logAlerts;
+
+        /** Constructor CollisionMonitor
+         * Makes a monitor with no contacts seen yet
+         *
+         * @param alertDistance the distance two contacts must pass within to be alerted
+         * @param lookAhead the seconds ahead a close approach is looked for
+         *
+         * @author Daniel Marcovecchio
+         */
+        CollisionMonitor(float alertDistance, double lookAhead) : alertDistance(alertDistance), lookAhead(lookAhead),
+                coastTime(10.0), logAlerts(true) {}
+        ~CollisionMonitor() = default;
+
+        /** Method update
+         * Method to bring the contact velocities up to date with the display, then find every pair of contacts whose
+         * closest point of approach in the next lookAhead seconds is within alertDistance. A contact first seen this
+         * frame, or that has not moved for coastTime seconds, is taken to be still
+         *
+         * @param radar the display whose active Icons are the contacts
+         * @param now the time of this frame in seconds, which should increase from frame to frame
+         * @param alerts the list the alerts are written to soonest first, replacing what it held
+         *
+         * @return the number of alerts that are new this frame
+         *
+         * @author Daniel Marcovecchio
+         */
+        size_t update(const RadarDisplay& radar, double now, std::vector<CollisionAlert>& alerts);
+};
+
+size_t CollisionMonitor::update(const RadarDisplay& radar, double now, std::vector<CollisionAlert>& alerts) {
+    // Implementation of update
+
+    // Update the track of every slot, and sort the active contacts into speed classes by how far they reach. Slots stay
+    // with their Icon while it is on the display, so a track is only started again when its slot holds a different Icon
+    const size_t numberOfSlots = radar.getNumberOfSlots();
+    const float horizon = (float) lookAhead;
+    const float classReach = 4.0f * std::max(alertDistance, 1.0f);
+    slotTracks.resize(numberOfSlots);
+    slotTracked.resize(numberOfSlots, 0);
+    for (SpeedClass& speedClass : speedClasses) {
+        speedClass.paths.clear();
+        speedClass.pathMiddleX.clear();
+        speedClass.pathMiddleY.clear();
+        speedClass.furthestReach = 0.0f;
+    }
+    for (size_t slot = 0; slot < numberOfSlots; slot++) {
+        const Icon* icon = radar.getIconInSlot((unsigned int) slot);
+        if(icon == nullptr) {
+            slotTracked[slot] = 0;
+            continue;
+        }
+        ContactTrack& track = slotTracks[slot];
+        if(!slotTracked[slot] || track.id != icon->id) {
+            track = ContactTrack{icon->id, icon->xPosition, icon->yPosition, 0.0f, 0.0f, now};
+            slotTracked[slot] = 1;
+        } else if(icon->xPosition != track.x || icon->yPosition != track.y) {
+            double elapsed = now - track.lastMoveTime;
+            if(elapsed > 0.0) {
+                track.velocityX = (float) ((icon->xPosition - track.x) / elapsed);
+                track.velocityY = (float) ((icon->yPosition - track.y) / elapsed);
+            }
+            track.x = icon->xPosition;
+            track.y = icon->yPosition;
+            track.lastMoveTime = now;
+        } else if(now - track.lastMoveTime > coastTime) {
+            track.velocityX = 0.0f;
+            track.velocityY = 0.0f;
+        }
+
+        ContactPath path{track.x, track.y, track.velocityX, track.velocityY, track.x + track.velocityX * horizon * 0.5f,
+                         track.y + track.velocityY * horizon * 0.5f, 0.0f, track.id};
+        path.reach = std::sqrt(path.velocityX * path.velocityX + path.velocityY * path.velocityY) * horizon * 0.5f;
+        int k = 0;
+        while (k < numberOfSpeedClasses - 1 && path.reach > classReach * (float) (1 << k)) {
+            k++;
+        }
+        SpeedClass& speedClass = speedClasses[k];
+        speedClass.paths.push_back(path);
+        speedClass.pathMiddleX.push_back(path.middleX);
+        speedClass.pathMiddleY.push_back(path.middleY);
+        speedClass.furthestReach = std::max(speedClass.furthestReach, path.reach);
+    }
+
+    // Index the middles of each class's paths, with cells no narrower than two of its contacts can be apart and still
+    // close to alertDistance. The small extra allows for the rounding of the path middles
+    const float searchSlack = alertDistance * 1.001f + 1e-3f;
+    for (SpeedClass& speedClass : speedClasses) {
+        if(speedClass.paths.empty()) {
+            continue;
+        }
+        speedClass.pathGrid.build(speedClass.pathMiddleX.data(), speedClass.pathMiddleY.data(), speedClass.paths.size(),
+                                  searchSlack + 2.0f * speedClass.furthestReach);
+        speedClass.pathsInCellOrder.clear();
+        speedClass.middleXInCellOrder.clear();
+        speedClass.middleYInCellOrder.clear();
+        speedClass.reachInCellOrder.clear();
+        for (unsigned int point : speedClass.pathGrid.getPointsInCellOrder()) {
+            const ContactPath& path = speedClass.paths[point];
+            speedClass.pathsInCellOrder.push_back(path);
+            speedClass.middleXInCellOrder.push_back(path.middleX);
+            speedClass.middleYInCellOrder.push_back(path.middleY);
+            speedClass.reachInCellOrder.push_back(path.reach);
+        }
+    }
+
+    int numberOfThreads = 1;
+#ifdef _OPENMP
+    numberOfThreads = omp_get_max_threads();
+#endif
+    threadAlerts.resize(numberOfThreads);
+
+    #pragma omp parallel num_threads(numberOfThreads)
+    {
+        int thread = 0;
+#ifdef _OPENMP
+        thread = omp_get_thread_num();
+#endif
+        std::vector<CollisionAlert>& found = threadAlerts[thread];
+        found.clear();
+        std::vector<unsigned int> candidates;
+
+        // Pairs in the same class are in the same or neighbouring cells. Each cell is checked against itself and the
+        // cells to its right and below, so every pair of cells is checked once. The cell to the right and the three
+        // below are each one run of contacts. Rows of cells are split between threads
+        for (const SpeedClass& speedClass : speedClasses) {
+            if(speedClass.paths.empty()) {
+                continue;
+            }
+            const SpatialGrid& grid = speedClass.pathGrid;
+            const ContactPath* paths = speedClass.pathsInCellOrder.data();
+            const float* middleXs = speedClass.middleXInCellOrder.data();
+            const float* middleYs = speedClass.middleYInCellOrder.data();
+            const float* reaches = speedClass.reachInCellOrder.data();
+            #pragma omp for schedule(dynamic, 2) nowait
+            for (int row = 0; row < grid.getRows(); row++) {
+                for (int column = 0; column < grid.getColumns(); column++) {
+                    unsigned int first, last, sameRowLast, belowFirst, belowLast;
+                    grid.getCellRun(row, column, column, first, last);
+                    if(first == last) {
+                        continue;
+                    }
+                    grid.getCellRun(row, column, column + 1, first, sameRowLast);
+                    grid.getCellRun(row + 1, column - 1, column + 1, belowFirst, belowLast);
+                    candidates.resize(std::max(candidates.size(), (size_t) (sameRowLast - first + belowLast - belowFirst)));
+                    for (unsigned int e = first; e < last; e++) {
+                        // Two contacts can only come within alertDistance if the middles of their paths are within
+                        // alertDistance plus both their reaches. Those that are go in candidates without a branch, as
+                        // whether each one does is hard to predict
+                        const float middleX = middleXs[e], middleY = middleYs[e], slack = searchSlack + reaches[e];
+                        unsigned int* candidate = candidates.data();
+                        size_t numberOfCandidates = 0;
+                        for (unsigned int other = e + 1; other < sameRowLast; other++) {
+                            float separationX = middleXs[other] - middleX, separationY = middleYs[other] - middleY;
+                            float limit = slack + reaches[other];
+                            candidate[numberOfCandidates] = other;
+                            numberOfCandidates += separationX * separationX + separationY * separationY <= limit * limit;
+                        }
+                        for (unsigned int other = belowFirst; other < belowLast; other++) {
+                            float separationX = middleXs[other] - middleX, separationY = middleYs[other] - middleY;
+                            float limit = slack + reaches[other];
+                            candidate[numberOfCandidates] = other;
+                            numberOfCandidates += separationX * separationX + separationY * separationY <= limit * limit;
+                        }
+                        for (size_t c = 0; c < numberOfCandidates; c++) {
+                            checkPair(paths[e], paths[candidate[c]], found);
+                        }
+                    }
+                }
+            }
+        }
+
+        // A pair in different classes is found by the faster contact. The slower one can only come within alertDistance
+        // of it if the middle of its path is within alertDistance plus its reach of the faster one's path, so each slower
+        // class is searched along that path, only as wide as the furthest reach in the class. So a few fast contacts do
+        // not widen the search of every slow one, and they only search a strip around their own long paths
+        for (int fasterClass = 1; fasterClass < numberOfSpeedClasses; fasterClass++) {
+            const std::vector<ContactPath>& fasterPaths = speedClasses[fasterClass].paths;
+            #pragma omp for schedule(dynamic, 16) nowait
+            for (long long entry = 0; entry < (long long) fasterPaths.size(); entry++) {
+                const ContactPath& a = fasterPaths[entry];
+                const float pathEndX = a.x + a.velocityX * horizon, pathEndY = a.y + a.velocityY * horizon;
+                for (int k = 0; k < fasterClass; k++) {
+                    const SpeedClass& speedClass = speedClasses[k];
+                    if(speedClass.paths.empty()) {
+                        continue;
+                    }
+                    candidates.clear();
+                    speedClass.pathGrid.findNearSegment(a.x, a.y, pathEndX, pathEndY, searchSlack + speedClass.furthestReach, candidates);
+                    for (unsigned int point : candidates) {
+                        checkPair(a, speedClass.paths[point], found);
+                    }
+                }
+            }
+        }
+    }
+
+    // Sort the alerts by pair, so the new ones are found walking alongside last frame's sorted pairs, which also leaves
+    // this frame's pairs sorted for the next. Then put them soonest first, alerts at the same time staying in ID order
+    alerts.clear();
+    for (const std::vector<CollisionAlert>& found : threadAlerts) {
+        alerts.insert(alerts.end(), found.begin(), found.end());
+    }
+    sortAlertsByKey(alerts, 8, [](const CollisionAlert& alert) {
+        return pairKey(alert.firstId, alert.secondId);
+    });
+    size_t newAlerts = 0;
+    size_t previous = 0;
+    framePairs.clear();
+    for (CollisionAlert& alert : alerts) {
+        unsigned long long key = pairKey(alert.firstId, alert.secondId);
+        while (previous < alertedPairs.size() && alertedPairs[previous] < key) {
+            previous++;
+        }
+        alert.isNew = previous == alertedPairs.size() || alertedPairs[previous] != key;
+        newAlerts += alert.isNew;
+        framePairs.push_back(key);
+    }
+    alertedPairs.swap(framePairs);
+    // Times are never negative, so their bits sort in the same order as they do. A time of -0 is taken as 0
+    sortAlertsByKey(alerts, 4, [](const CollisionAlert& alert) {
+        unsigned int bits = 0;
+        if(alert.timeToClosest > 0.0f) {
+            std::memcpy(&bits, &alert.timeToClosest, sizeof(bits));
+        }
+        return bits;
+    });
+    if(logAlerts) {
+        for (const CollisionAlert& alert : alerts) {
+            if(alert.isNew) {
+                RADAR_LOG(logWarning, "Collision alert: Icons %d and %d pass within %.1f in %.1f seconds", alert.firstId,
+                          alert.secondId, alert.closestDistance, alert.timeToClosest);
+            }
+        }
+    }
+    return newAlerts;
+}
+
+void initialiseAsDefaultDiagonalLine(Icon* icon) {
+    // initialiseAsDefaultDiagonalLine Function takes a icon pointer and populates it with pixel data of a diagonal line, of brightness 15
+
+    // Loop for all pixel slots, iconPixelsNumber, default 16
+    for (int i = 0; i < iconPixelsNumber; i++) {
         // Create a new Pixel object with xCoord and yCoord equal to i+1
         // And brightness level of 15
         // Sample data would look like:
@@ -368,26 +3344,898 @@ void initialiseAsDefaultDiagonalLine(Icon* icon) {
 }
 
 Icon* initPlane() {
-    // Initialize and return a Plane of ID 0
-    return new Icon(0);
+    // Initialize and return a Plane of ID 0, sharing the plane template
+    return new Icon(0, defaultIconTemplates().findTemplate("plane"));
 }
 Icon* initHelicopter() {
-    // Initialize and return a Helicopter of ID 1
-    return new Icon(1);
+    // Initialize and return a Helicopter of ID 1, sharing the helicopter template
+    return new Icon(1, defaultIconTemplates().findTemplate("helicopter"));
 }
 Icon* initSpaceship() {
-    // Initialize and return a Helicopter of ID 2
-    return new Icon(2);
+    // Initialize and return a Spaceship of ID 2, sharing the spaceship template
+    return new Icon(2, defaultIconTemplates().findTemplate("spaceship"));
+}
+
+/** Heap allocation counters
+* Every allocation made with new is counted, including those of the standard containers, so the benchmark can check
+* the per-frame paths do not touch the heap once they are warmed up. Only built with RADAR_COUNT_ALLOCATIONS
+*/
+#ifdef RADAR_COUNT_ALLOCATIONS
+const bool heapAllocationsCounted = true;
+std::atomic<size_t> heapAllocations(0);
+std::atomic<size_t> heapAllocatedBytes(0);
+
+void* operator new(std::size_t size) {
+    heapAllocations.fetch_add(1, std::memory_order_relaxed);
+    heapAllocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    void* memory = std::malloc(size == 0 ? 1 : size);
+    if(memory == nullptr) {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+// GCC sees the free of memory from new once these are inlined and warns, not knowing new above uses malloc
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic pop
+#endif
+
+void operator delete(void* memory, std::size_t) noexcept {
+    operator delete(memory);
+}
+#else
+const bool heapAllocationsCounted = false;
+#endif
+
+/** Method heapAllocationCount
+* Method to read the number of heap allocations counted so far
+*
+* @return the number of allocations made with new, or 0 when not built with RADAR_COUNT_ALLOCATIONS
+*
+* @author Daniel Marcovecchio
+*/
+size_t heapAllocationCount() {
+#ifdef RADAR_COUNT_ALLOCATIONS
+    return heapAllocations.load();
+#else
+    return 0;
+#endif
+}
+
+/** Method peakMemoryKilobytes
+* Method to read the most memory the process has had resident so far
+*
+* @return the peak resident memory in kilobytes, or 0 where the platform does not report it
+*
+* @author Daniel Marcovecchio
+*/
+size_t peakMemoryKilobytes() {
+#if defined(__unix__) || defined(__APPLE__)
+    struct rusage usage;
+    if(getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+#ifdef __APPLE__
+    // macOS reports bytes where Linux reports kilobytes
+    return (size_t) usage.ru_maxrss / 1024;
+#else
+    return (size_t) usage.ru_maxrss;
+#endif
+#else
+    return 0;
+#endif
+}
+
+/** Method printLatencyPercentiles
+* Method to print the median, 90th and 99th percentile and worst of a set of timings, in microseconds
+*
+* @param name what was timed
+* @param samples the time each operation took in seconds, which is sorted
+*
+* @author Daniel Marcovecchio
+*/
+void printLatencyPercentiles(const char* name, std::vector<double>& samples) {
+    if(samples.empty()) {
+        return;
+    }
+    std::sort(samples.begin(), samples.end());
+    size_t last = samples.size() - 1;
+    std::cout << "  " << name << " latency: p50 " << samples[last / 2] * 1e6 << " us, p90 " << samples[last * 9 / 10] * 1e6
+              << " us, p99 " << samples[last * 99 / 100] * 1e6 << " us, max " << samples[last] * 1e6 << " us\n";
+}
+
+/** Method makeTestIcons
+* Method to make the Icons for a test mode, with ids 0 up and random positions across a square area. Every Icon
+* shares the shape of one diagonal line, or takes each template of the default library in turn
+*
+* @param icons set to the Icons
+* @param numberOfIcons the number of Icons to make
+* @param seed the seed for std::rand, which the random numbers the test draws afterwards carry on from
+* @param areaSize the width and height of the area
+* @param everyTemplate true to use the default templates in turn instead of the diagonal line
+*
+* @author Daniel Marcovecchio
+*/
+void makeTestIcons(std::vector<Icon>& icons, int numberOfIcons, unsigned int seed, int areaSize, bool everyTemplate = false) {
+    Icon diagonalLine(-1);
+    initialiseAsDefaultDiagonalLine(&diagonalLine);
+    IconTemplateLibrary& templates = defaultIconTemplates();
+    icons.clear();
+    icons.reserve(std::max(numberOfIcons, 0));
+    std::srand(seed);
+    for (int i = 0; i < numberOfIcons; i++) {
+        if(everyTemplate) {
+            icons.emplace_back(i, templates.getTemplate(i % templates.getNumberOfTemplates()));
+        } else {
+            icons.emplace_back(i, diagonalLine.getShape());
+        }
+        icons.back().setPosition((float) (std::rand() % areaSize), (float) (std::rand() % areaSize));
+    }
+}
+
+/** Method makeTestDisplay
+* Method to make the Icons for a test mode with makeTestIcons and add them all to a display, which does not log each one
+* The display keeps pointers to the Icons, so the vector must not change size while the display is in use
+*
+* @param radar the display to add the Icons to
+* @param icons set to the Icons
+* @param numberOfIcons, seed, areaSize, everyTemplate as for makeTestIcons
+*
+* @author Daniel Marcovecchio
+*/
+void makeTestDisplay(RadarDisplay& radar, std::vector<Icon>& icons, int numberOfIcons, unsigned int seed, int areaSize,
+                     bool everyTemplate = false) {
+    makeTestIcons(icons, numberOfIcons, seed, areaSize, everyTemplate);
+    radar.logIconChanges = false;
+    radar.reserveIcons(radar.getNumberOfActiveIcons() + icons.size());
+    for (Icon& icon : icons) {
+        radar.addIcon(&icon);
+    }
+}
+
+/** Method runRenderTest
+* Method to time rendering of a display full of moving Icons, every Icon moving a little each frame
+* Prints the average time per frame and the frame rate, then saves the last frame to radarRenderTest.pgm
+*
+* @param numberOfIcons the number of Icons to spread over a 1024x1024 display
+* @param numberOfFrames the number of frames to render
+*
+* @author Daniel Marcovecchio
+*/
+void runRenderTest(int numberOfIcons, int numberOfFrames) {
+    std::cout << "----- Render Test: " << numberOfIcons << " icons, " << numberOfFrames << " frames -----\n";
+
+    // Make the Icons, each a diagonal line at a random position moving in a random direction
+    const int frameSize = 1024;
+    std::vector<Icon> icons;
+    RadarDisplay radar;
+    makeTestDisplay(radar, icons, numberOfIcons, 1, frameSize);
+    std::vector<float> velocities((size_t) numberOfIcons * 2);
+    for (int i = 0; i < numberOfIcons; i++) {
+        velocities[i * 2] = (float) (std::rand() % 5 - 2);
+        velocities[i * 2 + 1] = (float) (std::rand() % 5 - 2);
+    }
+
+    RadarFramebuffer frame(frameSize, frameSize);
+    RadarRenderer renderer;
+    double renderSeconds = 0.0;
+    for (int f = 0; f < numberOfFrames; f++) {
+        // Move every Icon, wrapping around the edges, then time only the render
+        for (int i = 0; i < numberOfIcons; i++) {
+            float x = std::fmod(icons[i].xPosition + velocities[i * 2] + frameSize, (float) frameSize);
+            float y = std::fmod(icons[i].yPosition + velocities[i * 2 + 1] + frameSize, (float) frameSize);
+            icons[i].setPosition(x, y);
+        }
+        auto start = std::chrono::steady_clock::now();
+        renderer.renderFrame(radar, frame);
+        renderSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    double millisecondsPerFrame = renderSeconds * 1000.0 / numberOfFrames;
+    std::cout << "Average render time: " << millisecondsPerFrame << " ms per frame ("
+              << 1000.0 / millisecondsPerFrame << " frames per second)\n";
+    frame.writePGM("radarRenderTest.pgm");
+}
+
+/** Method runQueryTest
+* Method to time the spatial index, rebuilding it and running range, rectangle, nearest and under-the-cursor queries
+* over Icons spread across a 4096x4096 area. Each query type is also checked against a full scan for a few queries
+*
+* @param numberOfIcons the number of Icons to index
+*
+* @author Daniel Marcovecchio
+*/
+void runQueryTest(int numberOfIcons) {
+    std::cout << "----- Query Test: " << numberOfIcons << " icons -----\n";
+
+    const int areaSize = 4096;
+    const int numberOfQueries = 10000;
+    std::vector<Icon> icons;
+    RadarDisplay radar;
+    makeTestDisplay(radar, icons, numberOfIcons, 2, areaSize);
+
+    auto start = std::chrono::steady_clock::now();
+    radar.updateSpatialIndex();
+    std::cout << "Index rebuild: " << std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() << " ms\n";
+
+    // Query points, the same for every query type
+    std::vector<float> queryXs(numberOfQueries), queryYs(numberOfQueries);
+    for (int q = 0; q < numberOfQueries; q++) {
+        queryXs[q] = (float) (std::rand() % areaSize);
+        queryYs[q] = (float) (std::rand() % areaSize);
+    }
+
+    std::vector<Icon*> found;
+    const char* queryNames[4] = {"Range 50", "Rectangle 100x100", "Nearest 8", "At point"};
+    for (int type = 0; type < 4; type++) {
+        size_t totalFound = 0, mismatches = 0;
+        start = std::chrono::steady_clock::now();
+        for (int q = 0; q < numberOfQueries; q++) {
+            float x = queryXs[q], y = queryYs[q];
+            if(type == 0) radar.findIconsInRange(x, y, 50.0f, found);
+            else if(type == 1) radar.findIconsInRectangle(x, y, x + 100.0f, y + 100.0f, found);
+            else if(type == 2) radar.findNearestIcons(x, y, 8, found);
+            else radar.findIconsAtPoint(x, y, found);
+            totalFound += found.size();
+        }
+        double microseconds = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / numberOfQueries;
+
+        // Check the first few queries against a full scan. For nearest, compare the distance of the k-th Icon found
+        for (int q = 0; q < 20 && type < 3; q++) {
+            float x = queryXs[q], y = queryYs[q];
+            std::vector<float> distances;
+            size_t expected = 0;
+            for (const Icon& icon : icons) {
+                float dx = icon.xPosition - x, dy = icon.yPosition - y;
+                if(type == 0 && dx * dx + dy * dy <= 2500.0f) expected++;
+                if(type == 1 && dx >= 0.0f && dx <= 100.0f && dy >= 0.0f && dy <= 100.0f) expected++;
+                if(type == 2) distances.push_back(dx * dx + dy * dy);
+            }
+            if(type == 0) radar.findIconsInRange(x, y, 50.0f, found);
+            else if(type == 1) radar.findIconsInRectangle(x, y, x + 100.0f, y + 100.0f, found);
+            if(type == 2) {
+                radar.findNearestIcons(x, y, 8, found);
+                std::nth_element(distances.begin(), distances.begin() + 7, distances.end());
+                float dx = found.back()->xPosition - x, dy = found.back()->yPosition - y;
+                mismatches += found.size() != 8 || dx * dx + dy * dy != distances[7];
+            } else {
+                mismatches += found.size() != expected;
+            }
+        }
+        std::cout << queryNames[type] << ": " << microseconds << " us per query, " << (double) totalFound / numberOfQueries
+                  << " icons found on average, " << mismatches << " mismatches against a full scan\n";
+    }
+}
+
+/** Method runIngestTest
+* Method to time the track feed. Records a feed of random walks for many Icons to radarTracks.bin, reads it back,
+* then replays it from several producer threads while this thread applies the updates in frames of up to 100000
+*
+* @param numberOfIcons the number of Icons on the display
+* @param numberOfUpdates the number of track updates in the recording
+* @param numberOfProducers the number of producer threads replaying the recording
+*
+* @author Daniel Marcovecchio
+*/
+void runIngestTest(int numberOfIcons, int numberOfUpdates, int numberOfProducers) {
+    std::cout << "----- Ingest Test: " << numberOfIcons << " icons, " << numberOfUpdates << " updates, "
+              << numberOfProducers << " producers -----\n";
+
+    std::vector<Icon> icons;
+    RadarDisplay radar;
+    makeTestDisplay(radar, icons, numberOfIcons, 3, 1024);
+
+    // Record a feed where every Icon is updated in turn, each time stepping a little from where it was
+    std::vector<TrackUpdate> recording(numberOfUpdates);
+    std::vector<float> walkX(numberOfIcons, 512.0f), walkY(numberOfIcons, 512.0f);
+    std::srand(3);
+    for (int i = 0; i < numberOfUpdates; i++) {
+        int id = i % numberOfIcons;
+        walkX[id] += (float) (std::rand() % 3 - 1);
+        walkY[id] += (float) (std::rand() % 3 - 1);
+        recording[i] = TrackUpdate{id, walkX[id], walkY[id], (unsigned int) (10 + std::rand() % 11), i * 1e-6};
+    }
+    std::vector<TrackUpdate> replay;
+    if(!writeTrackRecording("radarTracks.bin", recording) || !readTrackRecording("radarTracks.bin", replay)) {
+        return;
+    }
+
+    // Start the producers, then apply updates in frames until every producer is done and the feed is empty
+    MpscRingBuffer<TrackUpdate> feed(1 << 16);
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> producers;
+    std::atomic<int> producersRunning(numberOfProducers);
+    for (int p = 0; p < numberOfProducers; p++) {
+        producers.emplace_back([&replay, &feed, &producersRunning, p, numberOfProducers]() {
+            replayTrackUpdates(replay, feed, p, numberOfProducers);
+            producersRunning--;
+        });
+    }
+    size_t applied = 0, frames = 0;
+    for (;;) {
+        bool producersDone = producersRunning.load() == 0;
+        size_t appliedThisFrame = radar.applyTrackUpdates(feed, 100000);
+        applied += appliedThisFrame;
+        frames++;
+        if(producersDone && appliedThisFrame == 0) {
+            break;
+        }
+        if(appliedThisFrame == 0) {
+            std::this_thread::yield();
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    for (std::thread& producer : producers) {
+        producer.join();
+    }
+
+    // With producers interleaving, some updates arrive after a newer one for the same Icon and are skipped
+    size_t skipped = radar.getStaleTrackUpdates() + radar.getUnknownTrackUpdates();
+    std::cout << "Applied " << applied << " updates and skipped " << skipped << " out of order in " << frames << " frames, "
+              << seconds * 1000.0 << " ms (" << (applied + skipped) / seconds / 1e6 << " million updates per second)\n";
+    int lastId = (numberOfUpdates - 1) % numberOfIcons;
+    std::cout << "Icon " << lastId << " ended at (" << icons[lastId].xPosition << ", " << icons[lastId].yPosition
+              << "), recorded (" << walkX[lastId] << ", " << walkY[lastId] << ")\n";
+}
+
+/** Method runSnapshotTest
+* Method to time publishing snapshots while reader threads use them. Each frame the display thread moves every Icon
+* to an x position equal to the frame number, then publishes. Readers render and query whatever snapshot is current,
+* and check every Icon in it has the same x, which would not hold if a reader ever saw a half-written frame
+*
+* @param numberOfIcons the number of Icons on the display
+* @param numberOfReaders the number of reader threads
+* @param numberOfFrames the number of frames to publish
+*
+* @author Daniel Marcovecchio
+*/
+void runSnapshotTest(int numberOfIcons, int numberOfReaders, int numberOfFrames) {
+    std::cout << "----- Snapshot Test: " << numberOfIcons << " icons, " << numberOfReaders << " readers, "
+              << numberOfFrames << " frames -----\n";
+
+    // Every frame moves the Icons to the same x before it is published, so where they start does not matter
+    std::vector<Icon> icons;
+    RadarDisplay radar;
+    makeTestDisplay(radar, icons, numberOfIcons, 4, 1024);
+    RadarSnapshotBuffer snapshots;
+
+    // Readers alternate between rendering the snapshot and querying it, until the display thread is done
+    std::atomic<bool> publishing(true);
+    std::vector<std::thread> readers;
+    std::vector<size_t> framesRead(numberOfReaders, 0), tornFrames(numberOfReaders, 0);
+    std::vector<double> readSeconds(numberOfReaders, 0.0);
+    for (int r = 0; r < numberOfReaders; r++) {
+        readers.emplace_back([&, r]() {
+            RadarRenderer renderer;
+            RadarFramebuffer frame(1024, 1024);
+            std::vector<const Icon*> found;
+            unsigned long long lastFrame = 0;
+            while (publishing.load()) {
+                auto start = std::chrono::steady_clock::now();
+                const RadarSnapshot* snapshot = snapshots.acquire();
+                if(snapshot->frameNumber == lastFrame) {
+                    snapshots.release(snapshot);
+                    std::this_thread::yield();
+                    continue;
+                }
+                lastFrame = snapshot->frameNumber;
+                if(r % 2 == 0) {
+                    renderer.renderFrame(*snapshot, frame);
+                } else {
+                    for (int q = 0; q < 100; q++) {
+                        snapshot->findNearestIcons((float) (lastFrame % 1024), (float) (q * 10), 8, found);
+                    }
+                }
+                for (const Icon& icon : snapshot->icons) {
+                    tornFrames[r] += icon.xPosition != (float) lastFrame;
+                }
+                snapshots.release(snapshot);
+                readSeconds[r] += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                framesRead[r]++;
+            }
+        });
+    }
+
+    // Move every Icon and publish, timing only the publish
+    double publishSeconds = 0.0;
+    for (int f = 1; f <= numberOfFrames; f++) {
+        for (Icon& icon : icons) {
+            icon.xPosition = (float) f;
+        }
+        auto start = std::chrono::steady_clock::now();
+        snapshots.publish(radar);
+        publishSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+    publishing.store(false);
+    for (std::thread& reader : readers) {
+        reader.join();
+    }
+
+    std::cout << "Average publish time: " << publishSeconds * 1000.0 / numberOfFrames << " ms\n";
+    for (int r = 0; r < numberOfReaders; r++) {
+        std::cout << "Reader " << r << (r % 2 == 0 ? " (render)" : " (query)") << ": " << framesRead[r] << " frames, "
+                  << (framesRead[r] ? readSeconds[r] * 1000.0 / framesRead[r] : 0.0) << " ms per frame, "
+                  << tornFrames[r] << " icons from a different frame\n";
+    }
+}
+
+/** Method runDirtyTest
+* Method to compare drawing every tile each frame against redrawing only changed tiles, on a display where only a
+* few of the Icons move each frame, and one is removed and added back. Checks both ways end with the same frame
+*
+* @param numberOfIcons the number of Icons spread over a 1024x1024 display
+* @param numberOfMoving the number of those Icons moved with moveIcon each frame
+* @param numberOfFrames the number of frames to render each way
+*
+* @author Daniel Marcovecchio
+*/
+void runDirtyTest(int numberOfIcons, int numberOfMoving, int numberOfFrames) {
+    std::cout << "----- Dirty Tile Test: " << numberOfIcons << " icons, " << numberOfMoving << " moving, "
+              << numberOfFrames << " frames -----\n";
+
+    const int frameSize = 1024;
+    std::vector<Icon> icons;
+    RadarDisplay radar;
+    makeTestDisplay(radar, icons, numberOfIcons, 5, frameSize);
+
+    RadarFramebuffer fullFrame(frameSize, frameSize), dirtyFrame(frameSize, frameSize);
+    RadarRenderer fullRenderer, dirtyRenderer;
+    dirtyRenderer.renderChangedTiles(radar, dirtyFrame);
+    double fullSeconds = 0.0, dirtySeconds = 0.0;
+    size_t fullTiles = 0, dirtyTiles = 0;
+    for (int f = 0; f < numberOfFrames; f++) {
+        // Move the first few Icons a step to the right, wrapping around
+        for (int i = 0; i < numberOfMoving && i < numberOfIcons; i++) {
+            radar.moveIcon(i, std::fmod(icons[i].xPosition + 1.0f, (float) frameSize), icons[i].yPosition);
+        }
+        // Take the last Icon off the display every other frame and put it back on the next, to check adds and removes
+        if(f % 2 == 0) {
+            radar.removeIcon(&icons.back());
+        } else {
+            radar.addIcon(&icons.back());
+        }
+        auto start = std::chrono::steady_clock::now();
+        dirtyTiles += dirtyRenderer.renderChangedTiles(radar, dirtyFrame).tilesRedrawn;
+        auto middle = std::chrono::steady_clock::now();
+        fullTiles += fullRenderer.renderFrame(radar, fullFrame).tilesRedrawn;
+        auto end = std::chrono::steady_clock::now();
+        dirtySeconds += std::chrono::duration<double>(middle - start).count();
+        fullSeconds += std::chrono::duration<double>(end - middle).count();
+    }
+
+    std::cout << "Full render: " << fullSeconds * 1000.0 / numberOfFrames << " ms and " << fullTiles / numberOfFrames
+              << " tiles per frame\n";
+    std::cout << "Changed tiles only: " << dirtySeconds * 1000.0 / numberOfFrames << " ms and " << dirtyTiles / numberOfFrames
+              << " tiles per frame\n";
+    std::cout << "Frames match: " << (fullFrame.brightness == dirtyFrame.brightness ? "yes" : "no") << "\n";
+}
+
+/** Method runSweepTest
+* Method to time the radar scope. Icons move across a 1024x1024 display at 60 frames per second, each frame is drawn
+* with renderChangedTiles, and the scope advances with a 2 second sweep and 1 second fade half-life
+*
+* @param numberOfIcons the number of moving Icons
+* @param numberOfFrames the number of frames to run
+*
+* @author Daniel Marcovecchio
+*/
+void runSweepTest(int numberOfIcons, int numberOfFrames) {
+    std::cout << "----- Sweep Test: " << numberOfIcons << " icons, " << numberOfFrames << " frames -----\n";
+
+    const int frameSize = 1024;
+    std::vector<Icon> icons;
+    RadarDisplay radar;
+    makeTestDisplay(radar, icons, numberOfIcons, 6, frameSize, true);
+    std::vector<float> velocities((size_t) numberOfIcons * 2);
+    for (int i = 0; i < numberOfIcons; i++) {
+        velocities[i * 2] = (float) (std::rand() % 5 - 2) * 0.5f;
+        velocities[i * 2 + 1] = (float) (std::rand() % 5 - 2) * 0.5f;
+    }
+
+    RadarFramebuffer frame(frameSize, frameSize);
+    RadarRenderer renderer;
+    RadarScope scope(frameSize, frameSize, 2.0, 1.0);
+    double sweepSeconds = 0.0;
+    for (int f = 0; f < numberOfFrames; f++) {
+        for (int i = 0; i < numberOfIcons; i++) {
+            radar.moveIcon(i, std::fmod(icons[i].xPosition + velocities[i * 2] + frameSize, (float) frameSize),
+                           std::fmod(icons[i].yPosition + velocities[i * 2 + 1] + frameSize, (float) frameSize));
+        }
+        renderer.renderChangedTiles(radar, frame);
+        auto start = std::chrono::steady_clock::now();
+        scope.advance(frame, 1.0 / 60.0);
+        sweepSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+    std::cout << "Average sweep and fade time: " << sweepSeconds * 1000.0 / numberOfFrames << " ms per frame\n";
+    scope.writePGM("radarSweep.pgm");
+}
+
+/** Method runPolarTest
+* Method to time converting sweeps of radar returns into display coordinates, against working out the sine and cosine
+* of every return. Reports the largest difference in pixels, then plots one sweep to radarReturns.pgm
+*
+* @param numberOfReturns the number of returns in a sweep
+* @param bearingBits the angular resolution of the converter tables
+*
+* @author Daniel Marcovecchio
+*/
+void runPolarTest(int numberOfReturns, int bearingBits) {
+    std::cout << "----- Polar Test: " << numberOfReturns << " returns, " << bearingBits << " bearing bits -----\n";
+
+    const int frameSize = 1024;
+    const float maxRange = 50000.0f;
+    const int numberOfSweeps = 20;
+    size_t count = (size_t) std::max(numberOfReturns, 0);
+    std::vector<float> ranges(count), xs(count), ys(count);
+    std::vector<unsigned short> bearings(count);
+    std::srand(9);
+    for (size_t i = 0; i < count; i++) {
+        ranges[i] = (float) std::rand() / (float) RAND_MAX * maxRange;
+        bearings[i] = (unsigned short) (std::rand() & 0xFFFF);
+    }
+
+    RadarReturnConverter converter(frameSize, frameSize, maxRange, bearingBits);
+    auto start = std::chrono::steady_clock::now();
+    for (int s = 0; s < numberOfSweeps; s++) {
+        converter.convert(ranges.data(), bearings.data(), count, xs.data(), ys.data());
+    }
+    double tableSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() / numberOfSweeps;
+
+    // The same conversion with a sine and cosine per return, on one thread as it would be written without the converter
+    const double pi = 3.14159265358979323846;
+    const double pixelsPerMetre = frameSize / 2.0 / maxRange;
+    std::vector<float> referenceXs(count), referenceYs(count);
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < count; i++) {
+        double bearing = 2.0 * pi * bearings[i] / 65536.0;
+        referenceXs[i] = (float) (frameSize / 2.0 + ranges[i] * pixelsPerMetre * std::sin(bearing));
+        referenceYs[i] = (float) (frameSize / 2.0 - ranges[i] * pixelsPerMetre * std::cos(bearing));
+    }
+    double referenceSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    float largestError = 0.0f;
+    for (size_t i = 0; i < count; i++) {
+        largestError = std::max(largestError, std::max(std::fabs(xs[i] - referenceXs[i]), std::fabs(ys[i] - referenceYs[i])));
+    }
+    std::cout << "Table conversion: " << tableSeconds * 1000.0 << " ms per sweep, " << count / tableSeconds / 1e6
+              << " million returns per second\n";
+    std::cout << "Sine and cosine per return: " << referenceSeconds * 1000.0 << " ms per sweep, " << count / referenceSeconds / 1e6
+              << " million returns per second\n";
+    std::cout << "Largest difference: " << largestError << " pixels\n";
+
+    RadarFramebuffer frame(frameSize, frameSize);
+    for (size_t i = 0; i < count; i++) {
+        int x = (int) xs[i], y = (int) ys[i];
+        if(x >= 0 && x < frameSize && y >= 0 && y < frameSize) {
+            unsigned char& pixel = frame.brightness[(size_t) y * frameSize + x];
+            pixel = (unsigned char) std::min<unsigned int>(pixel + 1u, maxPixelBrightness);
+        }
+    }
+    frame.writePGM("radarReturns.pgm");
+}
+
+/** Method runCollisionTest
+* Method to time the collision monitor over contacts moving at steady velocities across a 8192x8192 area, most at up
+* to half a pixel a second and one in a thousand at up to 100. The alerts of the last frame for the first 1000
+* contacts are checked against a scan of every other contact
+*
+* @param numberOfContacts the number of Icons on the display
+* @param numberOfFrames the number of one second frames to run
+*
+* @author Daniel Marcovecchio
+*/
+void runCollisionTest(int numberOfContacts, int numberOfFrames) {
+    std::cout << "----- Collision Test: " << numberOfContacts << " contacts, " << numberOfFrames << " frames -----\n";
+
+    const int areaSize = 8192;
+    std::vector<Icon> icons;
+    RadarDisplay radar;
+    makeTestDisplay(radar, icons, numberOfContacts, 10, areaSize);
+    // Velocities are whole eighths of a pixel per second, so every position and velocity worked out is exact
+    std::vector<float> velocities((size_t) std::max(numberOfContacts, 0) * 2);
+    for (int i = 0; i < numberOfContacts; i++) {
+        float step = i % 1000 == 999 ? 25.0f : 0.125f;
+        velocities[i * 2] = (float) (std::rand() % 9 - 4) * step;
+        velocities[i * 2 + 1] = (float) (std::rand() % 9 - 4) * step;
+    }
+
+    CollisionMonitor monitor(8.0f, 60.0);
+    monitor.logAlerts = false;
+    std::vector<CollisionAlert> alerts;
+    std::vector<double> frameSamples;
+    size_t newAlerts = 0;
+    for (int f = 0; f < numberOfFrames; f++) {
+        for (int i = 0; i < numberOfContacts; i++) {
+            radar.moveIcon(i, icons[i].xPosition + velocities[i * 2], icons[i].yPosition + velocities[i * 2 + 1]);
+        }
+        auto start = std::chrono::steady_clock::now();
+        newAlerts += monitor.update(radar, (double) f, alerts);
+        // The first frame has no velocities yet, so it is not timed
+        if(f > 0) {
+            frameSamples.push_back(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+        }
+    }
+    std::cout << "Alerts in the last frame: " << alerts.size() << ", new alerts over all frames: " << newAlerts << "\n";
+    if(!frameSamples.empty()) {
+        printLatencyPercentiles("Collision check", frameSamples);
+    }
+
+    // Count the last frame's alerts involving the first contacts, then find them again by checking every other contact
+    const int checkedContacts = std::min(numberOfContacts, 1000);
+    size_t expected = 0, reported = 0;
+    for (const CollisionAlert& alert : alerts) {
+        reported += alert.firstId < checkedContacts;
+    }
+    const float horizon = (float) monitor.lookAhead;
+    for (int a = 0; a < checkedContacts && numberOfFrames > 1; a++) {
+        for (int b = a + 1; b < numberOfContacts; b++) {
+            float relativeX = icons[b].xPosition - icons[a].xPosition, relativeY = icons[b].yPosition - icons[a].yPosition;
+            float closingX = velocities[b * 2] - velocities[a * 2], closingY = velocities[b * 2 + 1] - velocities[a * 2 + 1];
+            float closingSquared = closingX * closingX + closingY * closingY;
+            float time = closingSquared > 0.0f ? -(relativeX * closingX + relativeY * closingY) / closingSquared : 0.0f;
+            time = std::min(std::max(time, 0.0f), horizon);
+            float closestX = relativeX + closingX * time, closestY = relativeY + closingY * time;
+            expected += closestX * closestX + closestY * closestY <= monitor.alertDistance * monitor.alertDistance;
+        }
+    }
+    std::cout << "Alerts for the first " << checkedContacts << " contacts: " << reported << ", " << expected
+              << " found checking every pair\n";
+}
+
+/** Method runSceneTest
+* Method to time saving a scene, mapping it back in and restoring it to a new display, with Icons of every template
+* and one with its own edited shape. Checks the restored display renders the same 1024x1024 frame as the original
+*
+* @param numberOfIcons the number of Icons in the scene
+*
+* @author Daniel Marcovecchio
+*/
+void runSceneTest(int numberOfIcons) {
+    std::cout << "----- Scene Test: " << numberOfIcons << " icons -----\n";
+
+    const int frameSize = 1024;
+    std::vector<Icon> icons;
+    RadarDisplay radar;
+    makeTestDisplay(radar, icons, numberOfIcons, 8, frameSize, true);
+    for (Icon& icon : icons) {
+        icon.brightness = (unsigned char) (10 + std::rand() % 11);
+        radar.markIconChanged(&icon);
+    }
+    if(numberOfIcons > 0) {
+        icons[0].setPixel(0, Pixel(0, 0, 20));
+        radar.markIconChanged(&icons[0]);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    if(!writeRadarScene("radarScene.bin", radar)) {
+        return;
+    }
+    auto saved = std::chrono::steady_clock::now();
+    MappedRadarScene scene;
+    if(!scene.open("radarScene.bin")) {
+        return;
+    }
+    auto opened = std::chrono::steady_clock::now();
+    RadarDisplay restoredRadar;
+    restoredRadar.logIconChanges = false;
+    std::vector<Icon> restoredIcons;
+    size_t restored = scene.restore(restoredRadar, restoredIcons);
+    auto end = std::chrono::steady_clock::now();
+    std::cout << "Saved " << scene.getNumberOfIcons() << " icons and " << scene.getNumberOfTemplates() << " templates in "
+              << std::chrono::duration<double, std::milli>(saved - start).count() << " ms\n";
+    std::cout << "Mapped the scene in " << std::chrono::duration<double, std::milli>(opened - saved).count()
+              << " ms, restored " << restored << " icons to a new display in "
+              << std::chrono::duration<double, std::milli>(end - opened).count() << " ms\n";
+
+    RadarFramebuffer originalFrame(frameSize, frameSize), restoredFrame(frameSize, frameSize);
+    RadarRenderer renderer;
+    renderer.renderFrame(radar, originalFrame);
+    renderer.renderFrame(restoredRadar, restoredFrame);
+    std::cout << "Frames match: " << (originalFrame.brightness == restoredFrame.brightness ? "yes" : "no") << "\n";
+}
+
+/** Method runBenchmark
+* Method to stress test the whole display at 1000 Icons, then ten times more each round up to maxIcons. Each round
+* times adding, finding, removing and adding back every Icon, applying track updates in frames, range queries and
+* rendering. With RADAR_COUNT_ALLOCATIONS it also counts the heap allocations made by the per-frame paths once warmed up
+*
+* @param maxIcons the number of Icons in the biggest round
+*
+* @author Daniel Marcovecchio
+*/
+void runBenchmark(int maxIcons) {
+    std::cout << "----- Benchmark: up to " << maxIcons << " icons -----\n";
+
+    const int frameSize = 1024;
+
+    for (int numberOfIcons = 1000; numberOfIcons <= maxIcons; numberOfIcons *= 10) {
+        std::cout << numberOfIcons << " icons\n";
+        // The Icons are added here rather than with makeTestDisplay, so adding them can be timed
+        std::vector<Icon> icons;
+        makeTestIcons(icons, numberOfIcons, 7, frameSize);
+        RadarDisplay radar;
+        radar.logIconChanges = false;
+
+        // Registry operations, timed as a whole as each one is too quick to time on its own
+        auto start = std::chrono::steady_clock::now();
+        for (Icon& icon : icons) {
+            radar.addIcon(&icon);
+        }
+        double addSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::vector<int> lookupIds(numberOfIcons);
+        for (int i = 0; i < numberOfIcons; i++) {
+            lookupIds[i] = std::rand() % numberOfIcons;
+        }
+        size_t found = 0;
+        start = std::chrono::steady_clock::now();
+        for (int id : lookupIds) {
+            found += radar.findIcon(id) != nullptr;
+        }
+        double findSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < numberOfIcons; i += 2) {
+            radar.removeIcon(&icons[i]);
+        }
+        for (int i = 0; i < numberOfIcons; i += 2) {
+            radar.addIcon(&icons[i]);
+        }
+        double churnSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "  Add: " << numberOfIcons / addSeconds / 1e6 << " million per second, find: "
+                  << numberOfIcons / findSeconds / 1e6 << " million per second (" << found << " found), remove and add back: "
+                  << numberOfIcons / churnSeconds / 1e6 << " million per second\n";
+
+        // Track updates, a frame of updates for a tenth of the Icons queued then applied at a time
+        const int updatesPerFrame = std::min(std::max(numberOfIcons / 10, 100), 50000);
+        const int updateFrames = 100;
+        MpscRingBuffer<TrackUpdate> feed(updatesPerFrame);
+        std::vector<double> frameSamples;
+        frameSamples.reserve(updateFrames);
+        size_t allocationsBefore = 0;
+        int nextId = 0;
+        double timestamp = 0.0;
+        for (int f = -1; f < updateFrames; f++) {
+            for (int u = 0; u < updatesPerFrame; u++) {
+                timestamp += 1e-6;
+                feed.tryPush(TrackUpdate{nextId, (float) (std::rand() % frameSize), (float) (std::rand() % frameSize), 15, timestamp});
+                nextId = (nextId + 1) % numberOfIcons;
+            }
+            // The first frame warms up the buffers the display reuses, so it is not counted
+            if(f == 0) {
+                allocationsBefore = heapAllocationCount();
+            }
+            start = std::chrono::steady_clock::now();
+            radar.applyTrackUpdates(feed, (size_t) updatesPerFrame);
+            if(f >= 0) {
+                frameSamples.push_back(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+            }
+        }
+        size_t ingestAllocations = heapAllocationCount() - allocationsBefore;
+        double ingestSeconds = 0.0;
+        for (double sample : frameSamples) {
+            ingestSeconds += sample;
+        }
+        std::cout << "  Track updates: " << (double) updatesPerFrame * updateFrames / ingestSeconds / 1e6
+                  << " million per second in frames of " << updatesPerFrame;
+        if(heapAllocationsCounted) {
+            std::cout << ", " << (double) ingestAllocations / updateFrames << " heap allocations per frame";
+        }
+        std::cout << "\n";
+        printLatencyPercentiles("Update frame", frameSamples);
+
+        // Range queries, each timed on its own. The first one rebuilds the index after the updates
+        const int numberOfQueries = 10000;
+        std::vector<Icon*> foundIcons;
+        radar.findIconsInRange(0.0f, 0.0f, 1.0f, foundIcons);
+        std::vector<double> querySamples(numberOfQueries);
+        size_t totalFound = 0;
+        allocationsBefore = heapAllocationCount();
+        for (int q = 0; q < numberOfQueries; q++) {
+            float x = (float) (std::rand() % frameSize), y = (float) (std::rand() % frameSize);
+            auto queryStart = std::chrono::steady_clock::now();
+            radar.findIconsInRange(x, y, 20.0f, foundIcons);
+            querySamples[q] = std::chrono::duration<double>(std::chrono::steady_clock::now() - queryStart).count();
+            totalFound += foundIcons.size();
+        }
+        std::cout << "  Range 20 queries: " << (double) totalFound / numberOfQueries << " icons found on average";
+        if(heapAllocationsCounted) {
+            std::cout << ", " << heapAllocationCount() - allocationsBefore << " heap allocations in " << numberOfQueries
+                      << " queries";
+        }
+        std::cout << "\n";
+        printLatencyPercentiles("Query", querySamples);
+
+        // Rendering, with fewer frames for the bigger rounds
+        const int renderFrames = std::min(std::max(20000000 / numberOfIcons, 10), 200);
+        RadarFramebuffer frame(frameSize, frameSize);
+        RadarRenderer renderer;
+        renderer.renderFrame(radar, frame);
+        std::vector<double> renderSamples(renderFrames);
+        allocationsBefore = heapAllocationCount();
+        for (int f = 0; f < renderFrames; f++) {
+            auto renderStart = std::chrono::steady_clock::now();
+            renderer.renderFrame(radar, frame);
+            renderSamples[f] = std::chrono::duration<double>(std::chrono::steady_clock::now() - renderStart).count();
+        }
+        std::cout << "  Render: " << renderFrames << " frames";
+        if(heapAllocationsCounted) {
+            std::cout << ", " << (double) (heapAllocationCount() - allocationsBefore) / renderFrames << " heap allocations per frame";
+        }
+        std::cout << "\n";
+        printLatencyPercentiles("Render frame", renderSamples);
+
+        std::cout << "  Peak memory so far: " << peakMemoryKilobytes() / 1024.0 << " MB\n";
+    }
 }
 
 /** main method
 * main implementation for testing the different OOP implementations in this program
 * All test data is pre-written/hardcoded, as required in the subtasks
+* Run with --render-test [icons] [frames] to only run the render timing test
+* Run with --query-test [icons] to only run the spatial query timing test
+* Run with --ingest-test [icons] [updates] [producers] to only run the track feed timing test
+* Run with --snapshot-test [icons] [readers] [frames] to only run the snapshot publishing test
+* Run with --dirty-test [icons] [moving] [frames] to only run the changed tile rendering test
+* Run with --sweep-test [icons] [frames] to only run the radar sweep test
+* Run with --benchmark [max icons] to only run the stress benchmark
+* Run with --scene-test [icons] to only run the scene save and restore test
+* Run with --polar-test [returns] [bearing bits] to only run the radar return conversion test
+* Run with --collision-test [contacts] [frames] to only run the collision alert test
 *
 * @author Daniel Marcovecchio
 */
-int main()
+int main(int argc, char* argv[])
 {
+    if(argc > 1 && std::strcmp(argv[1], "--render-test") == 0) {
+        runRenderTest(argc > 2 ? std::atoi(argv[2]) : 50000, argc > 3 ? std::atoi(argv[3]) : 600);
+        return 0;
+    }
+    if(argc > 1 && std::strcmp(argv[1], "--query-test") == 0) {
+        runQueryTest(argc > 2 ? std::atoi(argv[2]) : 100000);
+        return 0;
+    }
+    if(argc > 1 && std::strcmp(argv[1], "--ingest-test") == 0) {
+        runIngestTest(argc > 2 ? std::atoi(argv[2]) : 100000, argc > 3 ? std::atoi(argv[3]) : 10000000,
+                      argc > 4 ? std::max(std::atoi(argv[4]), 1) : 4);
+        return 0;
+    }
+    if(argc > 1 && std::strcmp(argv[1], "--snapshot-test") == 0) {
+        runSnapshotTest(argc > 2 ? std::atoi(argv[2]) : 50000, argc > 3 ? std::atoi(argv[3]) : 3,
+                        argc > 4 ? std::atoi(argv[4]) : 300);
+        return 0;
+    }
+    if(argc > 1 && std::strcmp(argv[1], "--dirty-test") == 0) {
+        runDirtyTest(argc > 2 ? std::atoi(argv[2]) : 50000, argc > 3 ? std::atoi(argv[3]) : 100,
+                     argc > 4 ? std::atoi(argv[4]) : 300);
+        return 0;
+    }
+    if(argc > 1 && std::strcmp(argv[1], "--sweep-test") == 0) {
+        runSweepTest(argc > 2 ? std::atoi(argv[2]) : 2000, argc > 3 ? std::atoi(argv[3]) : 600);
+        return 0;
+    }
+    if(argc > 1 && std::strcmp(argv[1], "--benchmark") == 0) {
+        runBenchmark(argc > 2 ? std::atoi(argv[2]) : 1000000);
+        return 0;
+    }
+    if(argc > 1 && std::strcmp(argv[1], "--scene-test") == 0) {
+        runSceneTest(argc > 2 ? std::atoi(argv[2]) : 1000000);
+        return 0;
+    }
+    if(argc > 1 && std::strcmp(argv[1], "--polar-test") == 0) {
+        runPolarTest(argc > 2 ? std::atoi(argv[2]) : 4000000, argc > 3 ? std::atoi(argv[3]) : 16);
+        return 0;
+    }
+    if(argc > 1 && std::strcmp(argv[1], "--collision-test") == 0) {
+        runCollisionTest(argc > 2 ? std::atoi(argv[2]) : 100000, argc > 3 ? std::atoi(argv[3]) : 60);
+        return 0;
+    }
+
     std::cout << "------------- Radar Display Project ---------------\n";
 
     std::cout << "----- Displaying pixel data of aPixel -----\n";
@@ -446,6 +4294,104 @@ int main()
     // As we display it again, we can see that now this one is removed from the list of active Icons
     radar.showRadarDetail();
 
+    std::cout << "\n----- Icon Template Testing -----\n";
+
+    // -- Load any extra templates, then fill the 500 entry catalogue with contacts of every template
+    // Each contact shares its template's pixels, so the catalogue costs little more than 500 small Icons
+    defaultIconTemplates().loadFromFile("iconTemplates.txt");
+    IconTemplateLibrary& templates = defaultIconTemplates();
+    // Messages are written by the log's own thread, so wait for them before printing what follows them
+    flushLog();
+    std::cout << "Templates available: " << templates.getNumberOfTemplates() << "\n";
+    for (int i = 3; i < 500; i++) {
+        allIcons[i] = new Icon(i, templates.getTemplate(i % templates.getNumberOfTemplates()));
+    }
+    std::cout << "Memory per contact: " << sizeof(Icon) << " bytes, plus " << sizeof(IconTemplate)
+              << " bytes once per template. Each Icon holding its own 16 pixels would need "
+              << sizeof(Icon) - sizeof(std::shared_ptr<const IconTemplate>) + sizeof(float) * 2 * iconPixelsNumber + iconPixelsNumber
+              << " bytes\n";
+    std::cout << "Contact 4 is a " << allIcons[4]->getShape()->name << ", pixel 1: ";
+    allIcons[4]->getPixel(0).showPixelDetail();
+
+    // Setting a pixel of one contact gives it its own copy of the shape, leaving the rest of that template alone
+    allIcons[4]->setPixel(0, Pixel(0, 0, 5));
+    std::cout << "After editing contact 4, pixel 1 of contact 4: ";
+    allIcons[4]->getPixel(0).showPixelDetail();
+    std::cout << "Pixel 1 of contact " << 4 + templates.getNumberOfTemplates() << ", the same template: ";
+    allIcons[4 + templates.getNumberOfTemplates()]->getPixel(0).showPixelDetail();
+
+    std::cout << "\n----- Radar Display Capacity Testing -----\n";
+
+    // -- Test the RadarDisplay can take more than 100 Icons, adding 1000 on a separate display
+    // The Icons are held by value in a vector, as the display only keeps references to them
+    std::vector<Icon> manyIcons;
+    manyIcons.reserve(1000);
+    for (int i = 0; i < 1000; ++i) {
+        manyIcons.emplace_back(1000 + i);
+    }
+    // Logging every one of the changes would bury the output below, so the display stays quiet
+    RadarDisplay largeRadar;
+    largeRadar.logIconChanges = false;
+    largeRadar.reserveIcons(manyIcons.size());
+    std::vector<IconHandle> manyHandles;
+    for (Icon& icon : manyIcons) {
+        manyHandles.push_back(largeRadar.addIcon(&icon));
+    }
+    std::cout << "Active icons after adding 1000: " << largeRadar.getNumberOfActiveIcons() << "\n";
+
+    // Look one up by ID, then remove every other Icon by its handle
+    std::cout << "Found icon ID 1500: " << (largeRadar.findIcon(1500) != nullptr ? "yes" : "no") << "\n";
+    for (size_t i = 0; i < manyHandles.size(); i += 2) {
+        largeRadar.removeIcon(manyHandles[i]);
+    }
+    std::cout << "Active icons after removing half: " << largeRadar.getNumberOfActiveIcons() << "\n";
+    // A handle to a removed Icon no longer finds anything, even once its slot is reused
+    std::cout << "Removed handle still valid: " << (largeRadar.getIcon(manyHandles[0]) != nullptr ? "yes" : "no") << "\n";
+
+    std::cout << "\n----- Radar Rendering Testing -----\n";
+
+    // -- Render a few diagonal line Icons, one partly off the edge to show clipping, and save the frame as an image
+    RadarDisplay renderRadar;
+    Icon lineA(1), lineB(2), lineC(3);
+    initialiseAsDefaultDiagonalLine(&lineA);
+    initialiseAsDefaultDiagonalLine(&lineB);
+    initialiseAsDefaultDiagonalLine(&lineC);
+    lineA.setPosition(4, 4);
+    lineB.setPosition(30, 10);
+    lineC.setPosition(56, 40);
+    renderRadar.addIcon(&lineA);
+    renderRadar.addIcon(&lineB);
+    renderRadar.addIcon(&lineC);
+    RadarFramebuffer renderFrame(64, 64);
+    RadarRenderer renderer;
+    renderer.renderFrame(renderRadar, renderFrame);
+    if(renderFrame.writePGM("radarDisplay.pgm")) {
+        flushLog();
+        std::cout << "Rendered " << renderRadar.getNumberOfActiveIcons() << " icons to radarDisplay.pgm\n";
+    }
+
+    std::cout << "\n----- Radar Spatial Query Testing -----\n";
+
+    // -- Ask which Icons are near a point, and which one is under a cursor on a lit pixel of lineB
+    std::vector<Icon*> foundIcons;
+    renderRadar.findIconsInRange(0, 0, 30, foundIcons);
+    std::cout << "Icons within 30 of (0, 0): " << foundIcons.size() << "\n";
+    renderRadar.findNearestIcons(60, 40, 1, foundIcons);
+    std::cout << "Nearest icon to (60, 40): ID " << foundIcons[0]->id << "\n";
+    renderRadar.findIconsAtPoint(35.5f, 15.5f, foundIcons);
+    std::cout << "Icons under the cursor at (35.5, 15.5): " << foundIcons.size() << (foundIcons.empty() ? "" : ", ID ")
+              << (foundIcons.empty() ? "" : std::to_string(foundIcons[0]->id)) << "\n";
+
+    // Free the catalogue, which every test above is now done with
+    for (int i = 0; i < 500; i++) {
+        delete allIcons[i];
+    }
+
+    // The log counts every message, so errors can be checked for without reading the output
+    flushLog();
+    std::cout << "\nLogged " << getLogMessageCount(logError) << " errors, " << getLogMessageCount(logWarning) << " warnings and "
+              << getLogMessageCount(logInfo) << " info messages, " << getDroppedLogMessages() << " dropped\n";
+
     // ------- END
 
     // We're done! :D
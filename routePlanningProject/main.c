@@ -13,17 +13,73 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <math.h>
+#include <string.h>
+#include <time.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 //------------- Public Variables Declaration
 
 // The array of possible locations with their x and y coordinates
 // The array of location ID's represent the indexes for finding these coordinates
-float xCoordOfPossibleLocations[] = {0,9,6,7,1,21,7,11,5,9,8};
-float yCoordOfPossibleLocations[] = {0,8,8,8,1,11,11,11,5,9,1};
+float defaultXCoordOfLocations[] = {0,9,6,7,1,21,7,11,5,9,8};
+float defaultYCoordOfLocations[] = {0,8,8,8,1,11,11,11,5,9,1};
+
+// The coordinates the route search uses, the default locations unless another set (e.g. a benchmark instance) is given
+float* xCoordOfPossibleLocations = defaultXCoordOfLocations;
+float* yCoordOfPossibleLocations = defaultYCoordOfLocations;
+
+// The road network cost of travelling between each pair of possible locations, row major
+// NULL until a road network is loaded, in which case straight-line distances are used
+float* roadCostOfPossibleLocations = NULL;
+int numberOfRoadCostLocations = 0;
 
 // The length of the location array to search
 int routeLength = 0;
 
+//------------- Trace Configuration
+
+// The verbosity levels of the planner trace, from no output at all up to logging every single tested route
+#define ROUTE_TRACE_SILENT 0
+#define ROUTE_TRACE_SUMMARY 1
+#define ROUTE_TRACE_IMPROVEMENTS 2
+#define ROUTE_TRACE_ALL_ROUTES 3
+
+// The highest trace level compiled into the program
+// Any trace statement above this level is a constant false condition, so the compiler removes it from the search entirely
+// Build with -DROUTE_TRACE_MAX_LEVEL=0 to strip all tracing out of the hot path
+#ifndef ROUTE_TRACE_MAX_LEVEL
+#define ROUTE_TRACE_MAX_LEVEL ROUTE_TRACE_ALL_ROUTES
+#endif
+
+// Check if a trace level is both compiled in and selected at runtime
+#define ROUTE_TRACE_ENABLED(level) ((level) <= ROUTE_TRACE_MAX_LEVEL && (level) <= routeTraceLevel)
+
+// The runtime selected trace level, defaults to only printing the summary counters at the end of a search
+int routeTraceLevel = ROUTE_TRACE_SUMMARY;
+
+// The stream the trace is written to, and the buffer given to it. NULL stream means stdout
+FILE* routeTraceFile = NULL;
+char* routeTraceBuffer = NULL;
+
+// The counters collected during a search, reported once at the end instead of printing per route
+typedef struct {
+    unsigned long long nodesExplored;   // Every node (partial route) visited in the permutation tree
+    unsigned long long nodesPruned;     // Nodes whose branch was cut as it could not beat the shortest route
+    unsigned long long routesEvaluated; // Complete routes whose total distance was computed
+    clock_t searchStartTime;
+    clock_t searchEndTime;
+} RouteSearchCounters;
+
+RouteSearchCounters routeSearchCounters;
+
+//------------- Memory Tracking
+
+// The heap memory currently held and the most held at once by the planner, counted by plannerMalloc and friends
+size_t plannerBytesInUse = 0;
+size_t plannerPeakBytes = 0;
+
 /**
 * Function distanceAToB - Returns the distance between two points (A and B) using the Pythagorean method
 *
@@ -40,230 +96,3845 @@ int routeLength = 0;
 *
 * @return distanceAToB (float) - The distance between point A and point B
 */
-float distanceAToB(float pointAXCoord, float pointAYCoord, float pointBXCoord, float pointBYCoord);
-
-
+float distanceAToB(float pointAXCoord, float pointAYCoord, float pointBXCoord, float pointBYCoord);
+
+
+
+/**
+* Function totalDistanceOfRoute - Returns the total distance of a given route
+*
+* Method - Iterates for each journey in the route, from location to location, and sums each distance
+*
+* Copyright Daniel Marcovecchio
+*
+* Dependencies: stdio.h, stdlib.h
+*
+* @author https://github.com/BlackHat0001
+*
+* @param xCoordLocations[] (float) - The x coordinate array of all possible delivery locations
+* @param yCoordLocations[] (float) - The y coordinate array of all possible delivery locations
+* @param routeLocations[] (int) - The route in which to find the distance for, starting and ending at the depot (0,0)
+*
+* @return totalDistance (float) - The total distance for this route
+*/
+float totalDistanceOfRoute(float xCoordLocations[], float yCoordLocations[], int routeLocations[]);
+
+
+
+/**
+* Function permutateRoutes - A recursive function that finds all permutations of an array of locations, and returns the shortest distance and route
+*
+* Based on the Permutation method - https://www.geeksforgeeks.org/print-all-possible-permutations-of-an-array-vector-without-duplicates-using-backtracking
+* Branches that can no longer beat the shortest route are pruned, and the work done is recorded in routeSearchCounters
+* Tested routes are only logged when the trace level is ROUTE_TRACE_ALL_ROUTES
+*
+* Copyright Daniel Marcovecchio
+*
+* Dependencies: stdio.h, stdlib.h
+*
+* @author https://github.com/BlackHat0001
+*
+* @param route[] (int) - The current route array, indicative of the branch in the tree
+* @param index (int) - The current index through the route array, indicative of the level in the tree
+* @param shortestDistance (float) - The shortest distance found at this branch in the tree
+* @param shortestRoute[] (int) - An array to store the shortest route found
+*
+* @return shortestDistance (float) - The shortest distance found in the whole tree. This is the shortest possible distance
+*
+* @warning If a value quite small is passed for shortestDistance, then the comparison may fail to produce the shortest distance. Recommend 1E14f
+*/
+float permutateRoutes(int route[], int index, float shortestDistance, int shortestRoute[]);
+
+
+
+/**
+* Function openRouteTrace - Directs the planner trace to a file with a large fully buffered stream, or to stdout
+* The buffer means a trace of every route is written in large blocks rather than one system call per line
+*
+* Copyright Daniel Marcovecchio
+*
+* Dependencies: stdio.h, stdlib.h
+*
+* @author https://github.com/BlackHat0001
+*
+* @param path (const char*) - The file to write the trace to, or NULL to keep writing to stdout
+* @param bufferSize (size_t) - The size of the trace file buffer in bytes
+*
+* @return success (int) - 1 if the trace stream was opened, 0 if the file could not be opened
+*/
+int openRouteTrace(const char* path, size_t bufferSize);
+
+
+
+/**
+* Function closeRouteTrace - Flushes and closes the trace stream opened by openRouteTrace
+*
+* Copyright Daniel Marcovecchio
+*
+* Dependencies: stdio.h, stdlib.h
+*
+* @author https://github.com/BlackHat0001
+*/
+void closeRouteTrace();
+
+
+
+/**
+* Function resetRouteSearchCounters - Zeroes the search counters and starts the search timer
+*
+* Copyright Daniel Marcovecchio
+*
+* Dependencies: time.h, string.h
+*
+* @author https://github.com/BlackHat0001
+*/
+void resetRouteSearchCounters();
+
+
+
+/**
+* Function reportRouteSearchCounters - Stops the search timer and prints the counters for the last search
+* Prints the nodes explored, nodes pruned, routes evaluated and the evaluation throughput per second
+*
+* Copyright Daniel Marcovecchio
+*
+* Dependencies: stdio.h, time.h
+*
+* @author https://github.com/BlackHat0001
+*/
+void reportRouteSearchCounters();
+
+
+
+//------------- Fleet Routing (CVRP) Declarations
+
+// The number of nearest neighbours kept per stop. Savings and local search moves are only tried between neighbours,
+// which keeps each pass linear in the number of stops instead of quadratic
+#define FLEET_NEIGHBOUR_COUNT 40
+
+// The longest route 2-opt tries every segment of. Longer routes only try segments joining neighbouring stops
+#define FLEET_FULL_TWO_OPT_STOPS 128
+
+// The largest instance to precompute a full distance matrix for. Above this the legs are computed on demand
+#define FLEET_MAX_MATRIX_STOPS 2048
+
+// The smallest change in distance that counts as an improvement, so rounding noise can not make moves cycle
+#define FLEET_IMPROVEMENT_EPSILON 1E-4f
+
+/** Struct DeliveryInstance
+* The input to the fleet planner. Location 0 is always the depot every vehicle starts and finishes at
+*
+* @property numberOfStops (int) - The number of locations, including the depot
+* @property xCoords, yCoords (float*) - The coordinates of every location
+* @property demands (int*) - The demand of every location, the depot has zero demand
+* @property vehicleCapacity (int) - The total demand one vehicle can carry
+* @property fleetSize (int) - The number of vehicles available
+* @property distanceMatrix (float*) - Optional numberOfStops^2 matrix of leg distances, NULL to compute legs on demand
+*/
+typedef struct {
+    int numberOfStops;
+    float* xCoords;
+    float* yCoords;
+    int* demands;
+    int vehicleCapacity;
+    int fleetSize;
+    float* distanceMatrix;
+} DeliveryInstance;
+
+/** Struct FleetPlan
+* The routes of every vehicle. Each route lists its stops in order, the depot at the start and end is implied
+*
+* @property numberOfRoutes (int) - The number of routes, some may be empty after improvement
+* @property routes (int**) - The stops of each route
+* @property routeSizes (int*) - The number of stops on each route
+* @property routeAllocations (int*) - The allocated length of each route array
+* @property routeLoads (int*) - The total demand on each route
+* @property routeOfStop (int*) - The route each stop is on, indexed by stop
+* @property positionOfStop (int*) - The position of each stop within its route, indexed by stop
+*/
+typedef struct {
+    int numberOfRoutes;
+    int** routes;
+    int* routeSizes;
+    int* routeAllocations;
+    int* routeLoads;
+    int* routeOfStop;
+    int* positionOfStop;
+} FleetPlan;
+
+/**
+* Function loadDeliveryInstance - Reads a fleet instance from a text file
+*
+* The file holds the fleet size and vehicle capacity, followed by one "x y demand" line per location,
+* the first location being the depot. Lines starting with # are comments
+*
+* Copyright Daniel Marcovecchio
+*
+* Dependencies: stdio.h, stdlib.h
+*
+* @author https://github.com/BlackHat0001
+*
+* @param path (const char*) - The instance file to read
+* @param instance (DeliveryInstance*) - The instance to fill, free with freeDeliveryInstance
+*
+* @return success (int) - 1 if the instance was read, 0 if the file is missing or malformed
+*/
+int loadDeliveryInstance(const char* path, DeliveryInstance* instance);
+
+
+
+/**
+* Function freeDeliveryInstance - Frees the arrays owned by a DeliveryInstance
+*
+* Copyright Daniel Marcovecchio
+*
+* @author https://github.com/BlackHat0001
+*
+* @param instance (DeliveryInstance*) - The instance to free
+*/
+void freeDeliveryInstance(DeliveryInstance* instance);
+
+
+
+/**
+* Function stopDistance - Returns the leg distance between two locations of an instance
+* Reads the distance matrix if one has been built, else computes the straight-line distance
+*
+* Copyright Daniel Marcovecchio
+*
+* Dependencies: math.h
+*
+* @author https://github.com/BlackHat0001
+*
+* @param instance (const DeliveryInstance*) - The instance the locations belong to
+* @param a (int) - The location the leg starts at
+* @param b (int) - The location the leg finishes at
+*
+* @return distance (float) - The distance from a to b
+*/
+float stopDistance(const DeliveryInstance* instance, int a, int b);
+
+
+
+/**
+* Function buildDistanceMatrix - Precomputes every leg distance of an instance, rows in parallel
+* Skipped for instances bigger than FLEET_MAX_MATRIX_STOPS, which keep computing legs on demand
+*
+* Copyright Daniel Marcovecchio
+*
+* Dependencies: stdlib.h, math.h
+*
+* @author https://github.com/BlackHat0001
+*
+* @param instance (DeliveryInstance*) - The instance to build the matrix for
+*/
+void buildDistanceMatrix(DeliveryInstance* instance);
+
+
+
+/**
+* Function solveFleetRoutes - Plans routes for the whole fleet
+*
+* Method - Clarke-Wright savings builds the initial routes, then local search relocates and swaps stops between
+* routes and applies 2-opt within routes until no move improves the total distance. If the plan needs more vehicles
+* than the fleet has, the lightest routes are emptied into the others and the local search is run again.
+* Moves are evaluated for all stops in parallel, and every non-conflicting improving move found in a pass is applied
+*
+* Copyright Daniel Marcovecchio
+*
+* Dependencies: stdio.h, stdlib.h, math.h
+*
+* @author https://github.com/BlackHat0001
+*
+* @param instance (DeliveryInstance*) - The instance to plan, the distance matrix is built if it fits
+* @param plan (FleetPlan*) - The plan to fill, free with freeFleetPlan
+*
+* @return totalDistance (float) - The total distance driven by the whole fleet
+*/
+float solveFleetRoutes(DeliveryInstance* instance, FleetPlan* plan);
+
+
+
+/**
+* Function fleetPlanDistance - Returns the total distance driven by every vehicle of a plan, routes summed in parallel
+*
+* Copyright Daniel Marcovecchio
+*
+* @author https://github.com/BlackHat0001
+*
+* @param instance (const DeliveryInstance*) - The instance the plan is for
+* @param plan (const FleetPlan*) - The plan to measure
+*
+* @return totalDistance (float) - The sum of every route's distance from and back to the depot
+*/
+float fleetPlanDistance(const DeliveryInstance* instance, const FleetPlan* plan);
+
+
+
+/**
+* Function countUsedRoutes - Returns the number of routes of a plan which visit at least one stop
+*
+* Copyright Daniel Marcovecchio
+*
+* @author https://github.com/BlackHat0001
+*
+* @param plan (const FleetPlan*) - The plan to count
+*
+* @return usedRoutes (int) - The number of vehicles needed for this plan
+*/
+int countUsedRoutes(const FleetPlan* plan);
+
+
+
+/**
+* Function printFleetPlan - Logs every used route of a plan with its load and distance
+*
+* Copyright Daniel Marcovecchio
+*
+* Dependencies: stdio.h
+*
+* @author https://github.com/BlackHat0001
+*
+* @param instance (const DeliveryInstance*) - The instance the plan is for
+* @param plan (const FleetPlan*) - The plan to log
+*/
+void printFleetPlan(const DeliveryInstance* instance, const FleetPlan* plan);
+
+
+
+/**
+* Function freeFleetPlan - Frees the arrays owned by a FleetPlan
+*
+* Copyright Daniel Marcovecchio
+*
+* @author https://github.com/BlackHat0001
+*
+* @param plan (FleetPlan*) - The plan to free
+*/
+void freeFleetPlan(FleetPlan* plan);
+
+
+
+//------------- Road Network Declarations
+
+/** Struct RoadGraph
+* A road network held in compressed sparse row form, so the roads leaving a junction are contiguous in memory
+* Every road can be driven both ways, so is stored once in each direction
+*
+* @property numberOfNodes (int) - The number of junctions
+* @property numberOfArcs (int) - The number of one-way arcs, twice the number of roads
+* @property nodeX, nodeY (float*) - The coordinates of every junction
+* @property arcStart (int*) - The first arc leaving each junction, with arcStart[numberOfNodes] the total arc count
+* @property arcTarget (int*) - The junction each arc leads to
+* @property arcCost (float*) - The cost of driving each arc
+*/
+typedef struct {
+    int numberOfNodes;
+    int numberOfArcs;
+    float* nodeX;
+    float* nodeY;
+    int* arcStart;
+    int* arcTarget;
+    float* arcCost;
+} RoadGraph;
+
+/**
+* Function loadRoadGraph - Reads a road network from an edge list file
+*
+* The file has "v x y" lines for junctions, numbered from 0 in the order they appear, and "e from to [cost]"
+* lines for two-way roads between them. A road without a cost costs its straight-line length.
+* Lines starting with # are comments
+*
+* Copyright Daniel Marcovecchio
+*
+* Dependencies: stdio.h, stdlib.h
+*
+* @author https://github.com/BlackHat0001
+*
+* @param path (const char*) - The edge list file to read
+* @param graph (RoadGraph*) - The graph to fill, free with freeRoadGraph
+*
+* @return success (int) - 1 if the graph was read, 0 if the file is missing or malformed
+*/
+int loadRoadGraph(const char* path, RoadGraph* graph);
+
+
+
+/**
+* Function freeRoadGraph - Frees the arrays owned by a RoadGraph
+*
+* Copyright Daniel Marcovecchio
+*
+* @author https://github.com/BlackHat0001
+*
+* @param graph (RoadGraph*) - The graph to free
+*/
+void freeRoadGraph(RoadGraph* graph);
+
+
+
+/**
+* Function buildRoadCostMatrix - Computes the road cost between every pair of locations
+*
+* Method - Each location joins the road network at its nearest junction, paying the straight-line distance to it.
+* A Dijkstra search with a binary heap is then run from every location's junction, in parallel over the locations,
+* each stopping as soon as every other location's junction has been reached
+*
+* Copyright Daniel Marcovecchio
+*
+* Dependencies: stdlib.h, math.h
+*
+* @author https://github.com/BlackHat0001
+*
+* @param graph (const RoadGraph*) - The road network
+* @param xCoords, yCoords (const float*) - The coordinates of the locations
+* @param numberOfLocations (int) - The number of locations
+*
+* @return matrix (float*) - numberOfLocations^2 costs, row major, free with plannerFree. NULL if a location can not
+*                           be reached by road from another
+*/
+float* buildRoadCostMatrix(const RoadGraph* graph, const float* xCoords, const float* yCoords, int numberOfLocations);
+
+
+
+//------------- Interval Leg Cost Declarations
+
+/** Struct CostInterval
+* A cost only known to lie in a range, like a leg whose travel time depends on traffic. This is the C form of the
+* interval type in src/interval.cpp, and two are added the same way, {amin + bmin, amax + bmax}
+*
+* @property min (float) - The best case cost
+* @property max (float) - The worst case cost
+*/
+typedef struct {
+    float min;
+    float max;
+} CostInterval;
+
+// The range of cost of travelling between each pair of possible locations, row major
+// NULL until leg cost intervals are loaded, in which case every leg costs exactly its legDistance
+CostInterval* legCostIntervalsOfPossibleLocations = NULL;
+int numberOfLegIntervalLocations = 0;
+
+/**
+* Function addCostIntervals - Returns the sum of two cost intervals, the sum of their best cases to the sum of their worst
+*
+* Copyright Daniel Marcovecchio
+*
+* @author https://github.com/BlackHat0001
+*
+* @param a (CostInterval) - The first interval
+* @param b (CostInterval) - The second interval
+*
+* @return sum (CostInterval) - The interval a + b
+*/
+CostInterval addCostIntervals(CostInterval a, CostInterval b);
+
+
+
+/**
+* Function legCostInterval - Returns the range of cost of travelling between two of the possible locations
+* This is the loaded interval if leg cost intervals have been loaded, else exactly the legDistance
+*
+* Copyright Daniel Marcovecchio
+*
+* @author https://github.com/BlackHat0001
+*
+* @param pointA (int) - The location ID the leg starts at
+* @param pointB (int) - The location ID the leg finishes at
+*
+* @return cost (CostInterval) - The best and worst case cost of the leg
+*/
+CostInterval legCostInterval(int pointA, int pointB);
+
+
+
+/**
+* Function loadLegCostIntervals - Reads the cost intervals of legs between the possible locations from a file
+*
+* The file has "from to min max" lines, each giving the best and worst case cost of the leg between two location IDs,
+* driven either way. Legs not in the file cost exactly their legDistance. Lines starting with # are comments
+*
+* Copyright Daniel Marcovecchio
+*
+* Dependencies: stdio.h, stdlib.h
+*
+* @author https://github.com/BlackHat0001
+*
+* @param path (const char*) - The leg interval file to read
+* @param numberOfLocations (int) - The number of possible locations
+*
+* @return intervals (CostInterval*) - numberOfLocations^2 intervals, row major, free with plannerFree. NULL if the file
+*                                     is missing or malformed
+*/
+CostInterval* loadLegCostIntervals(const char* path, int numberOfLocations);
+
+
+
+/**
+* Function totalCostIntervalOfRoute - Returns the best and worst case total cost of a given route
+* The best case is every leg at its lowest cost, and the worst case every leg at its highest
+*
+* Copyright Daniel Marcovecchio
+*
+* @author https://github.com/BlackHat0001
+*
+* @param routeLocations[] (int) - The route, starting and ending at the depot (0,0)
+*
+* @return totalCost (CostInterval) - The range of total cost of this route
+*/
+CostInterval totalCostIntervalOfRoute(int routeLocations[]);
+
+
+
+/**
+* Function findWorstCaseRoute - Finds the route whose worst case cost is lowest, the min-max route
+*
+* Method - The same permutation search as permutateRoutes over worst case leg costs. Worst case costs need not obey
+* the triangle inequality, so branches are pruned with a bound that does not rely on it. Every location still to be
+* visited, and the depot, must be arrived at by some leg, so the cheapest worst case arrival at each one is added
+* to the worst case of the fixed part of the route
+*
+* Copyright Daniel Marcovecchio
+*
+* Dependencies: stdlib.h
+*
+* @author https://github.com/BlackHat0001
+*
+* @param route[] (int) - The locations to visit, in any order. Left in the same order when done
+* @param bestRoute[] (int) - An array to store the min-max route found
+*
+* @return worstCase (float) - The worst case cost of the min-max route
+*/
+float findWorstCaseRoute(int route[], int bestRoute[]);
+
+
+
+/**
+* Function findMinMaxRegretRoute - Finds the most robust route, the one whose cost can fall furthest short of the best
+* route for the same traffic by the least
+*
+* Method - The regret of a route in one traffic scenario is its cost less the cost of the best route for that
+* scenario. For interval costs, a route's largest regret is in the scenario where its own legs are at their worst
+* and every other leg at its best, so it is found with one permutation search in that scenario, not by sampling
+* scenarios. Routes are searched as in findWorstCaseRoute, and as the min-max route never costs more than its
+* worst case, a branch whose worst case bound is more than that plus the best regret found is pruned
+*
+* Copyright Daniel Marcovecchio
+*
+* Dependencies: stdlib.h
+*
+* @author https://github.com/BlackHat0001
+*
+* @param route[] (int) - The locations to visit, in any order. Left in the same order when done
+* @param minMaxWorstCase (float) - The worst case cost of the min-max route, from findWorstCaseRoute
+* @param bestRoute[] (int) - An array to store the min-max regret route found
+*
+* @return maximumRegret (float) - The largest regret of the min-max regret route
+*/
+float findMinMaxRegretRoute(int route[], float minMaxWorstCase, int bestRoute[]);
+
+
+
+//------------- Incremental Route Declarations
+
+// The number of route positions either side of a change that the localised improvement may move stops within
+#define INCREMENTAL_WINDOW 6
+
+// The longest run of stops an Or-opt move relocates at once
+#define INCREMENTAL_MAX_SEGMENT 3
+
+// The largest route a full solve re-runs the exact permutation search on, longer routes only get a local search
+#define INCREMENTAL_MAX_EXACT_STOPS 10
+
+// The most updates made between checks of a route's quality, each check costing O(n^2) for the lower bound
+#define INCREMENTAL_CHECK_INTERVAL 16
+
+// The relative loss in quality allowed before an update falls back to a full solve, e.g. 0.02 is 2%
+#define INCREMENTAL_DEFAULT_DEGRADATION 0.02f
+
+/** Struct PlannedRoute
+* An optimised single vehicle route kept up to date as deliveries are added and cancelled during the day
+*
+* The quality of the route is estimated as its distance over a lower bound on any route through the same stops.
+* A full solve records this ratio as the reference, and an update that leaves the route more than the allowed
+* degradation above it is solved again in full
+*
+* Updates keep the distance from the legs they add and take away. The lower bound is a scan of every pair of stops,
+* so the quality is only checked every INCREMENTAL_CHECK_INTERVAL updates, or sooner once the distance has moved by
+* more than the allowed degradation of the bound since the last check
+*
+* @property stops (int*) - The location IDs of the route in order, without the depot
+* @property numberOfStops (int) - The number of stops on the route
+* @property capacity (int) - The number of stops the stops array has room for
+* @property distance (float) - The total distance of the route, from the depot and back
+* @property lowerBound (float) - The lower bound on the distance of the stops at the last check
+* @property referenceRatio (float) - The distance over the lower bound at the last full solve
+* @property updatesSinceCheck (int) - The number of updates since the last check
+* @property changeSinceCheck (float) - The sum of the sizes of the distance changes since the last check
+* @property fullSolves (int) - The number of updates that fell back to a full solve
+*/
+typedef struct {
+    int* stops;
+    int numberOfStops;
+    int capacity;
+    float distance;
+    float lowerBound;
+    float referenceRatio;
+    int updatesSinceCheck;
+    float changeSinceCheck;
+    int fullSolves;
+} PlannedRoute;
+
+/**
+* Function initialisePlannedRoute - Starts a planned route from an already optimised route, e.g. one found by
+* permutateRoutes, which becomes the reference quality for later updates
+*
+* Copyright Daniel Marcovecchio
+*
+* Dependencies: stdlib.h
+*
+* @author https://github.com/BlackHat0001
+*
+* @param plannedRoute (PlannedRoute*) - The planned route to fill, free with freePlannedRoute
+* @param route[] (int) - The optimised route, without the depot
+* @param numberOfStops (int) - The number of stops on the route
+*/
+void initialisePlannedRoute(PlannedRoute* plannedRoute, int route[], int numberOfStops);
+
+
+
+/**
+* Function freePlannedRoute - Frees the stops of a planned route
+*
+* Copyright Daniel Marcovecchio
+*
+* @author https://github.com/BlackHat0001
+*
+* @param plannedRoute (PlannedRoute*) - The planned route to free
+*/
+void freePlannedRoute(PlannedRoute* plannedRoute);
+
+
+
+/**
+* Function addStopToPlannedRoute - Adds a delivery to a planned route without solving it again from scratch
+*
+* Method - The stop is inserted where it adds the least distance, then 2-opt and Or-opt moves within
+* INCREMENTAL_WINDOW positions of it repair the route around the insertion. If the update is due a quality check
+* and the route is then more than maxDegradation worse than the reference quality, it is solved again in full
+*
+* Copyright Daniel Marcovecchio
+*
+* Dependencies: stdlib.h
+*
+* @author https://github.com/BlackHat0001
+*
+* @param plannedRoute (PlannedRoute*) - The planned route to update
+* @param stop (int) - The location ID of the delivery to add
+* @param maxDegradation (float) - The relative loss in quality allowed before a full solve
+*
+* @return distance (float) - The total distance of the updated route, -1 if the stop is already on the route
+*/
+float addStopToPlannedRoute(PlannedRoute* plannedRoute, int stop, float maxDegradation);
+
+
+
+/**
+* Function removeStopFromPlannedRoute - Cancels a delivery of a planned route without solving it again from scratch
+*
+* Method - The stop is taken out and its neighbours joined, then the route is repaired around the gap and checked
+* against the reference quality as in addStopToPlannedRoute
+*
+* Copyright Daniel Marcovecchio
+*
+* @author https://github.com/BlackHat0001
+*
+* @param plannedRoute (PlannedRoute*) - The planned route to update
+* @param stop (int) - The location ID of the delivery to cancel
+* @param maxDegradation (float) - The relative loss in quality allowed before a full solve
+*
+* @return distance (float) - The total distance of the updated route, -1 if the stop is not on the route
+*/
+float removeStopFromPlannedRoute(PlannedRoute* plannedRoute, int stop, float maxDegradation);
+
+
+
+/**
+* Function runRouteChanges - Applies a list of added and cancelled deliveries to an optimised route, printing each
+* updated route with the time it took beside the time of solving the same stops again from scratch
+*
+* Copyright Daniel Marcovecchio
+*
+* Dependencies: stdio.h, stdlib.h
+*
+* @author https://github.com/BlackHat0001
+*
+* @param changes (const char*) - Comma separated changes, +ID to add a delivery and -ID to cancel one, e.g. "+6,-2"
+* @param route[] (int) - The optimised route, without the depot
+* @param numberOfStops (int) - The number of stops on the route
+* @param numberOfLocations (int) - The number of possible locations, IDs from 1 up to this less one can be added
+*
+* @return exitCode (int) - 0 if every change was applied, -1 if a change is malformed or cannot be made
+*/
+int runRouteChanges(const char* changes, int route[], int numberOfStops, int numberOfLocations);
+
+
+
+//------------- Annealing Declarations
+
+// The number of nearest neighbours a move picks the stop to join from. Moves that join distant stops rarely improve
+#define ANNEALING_NEIGHBOUR_COUNT 10
+
+// The number of times during the time budget the islands stop to pass their best tours round the ring
+#define ANNEALING_MIGRATIONS 16
+
+// The temperature at the start and the end of the budget, as fractions of the average leg of the starting tour.
+// The temperature falls geometrically between them with the time used
+#define ANNEALING_START_TEMPERATURE 0.3
+#define ANNEALING_END_TEMPERATURE 0.001
+
+/**
+* Function solveAnnealingTour - Finds a short single tour through every location of an instance within a time budget
+*
+* Method - Simulated annealing runs on independent islands, one per thread, each with its own random number generator
+* and a starting tour built by nearest neighbour from a different random location. Moves are 2-opt and relocating a
+* stop, each joining a stop to one of its nearest neighbours. ANNEALING_MIGRATIONS times during the budget every
+* island passes its best tour to the next island round the ring, which takes it up if it is shorter than its own.
+* Islands only search in parallel, so more cores give more and better searched tours in the same time
+*
+* Copyright Daniel Marcovecchio
+*
+* Dependencies: stdlib.h, math.h, omp.h if built with OpenMP
+*
+* @author https://github.com/BlackHat0001
+*
+* @param instance (DeliveryInstance*) - The instance to solve, as a single tour from the depot. The distance matrix
+*                                       is built if it fits
+* @param seconds (double) - The wall clock time budget
+* @param seed (unsigned long long) - The seed of the island random number generators
+* @param bestTour[] (int) - An array of numberOfStops - 1 ints to store the best tour found, without the depot
+*
+* @return distance (float) - The distance of the best tour found, -1 if out of memory
+*/
+float solveAnnealingTour(DeliveryInstance* instance, double seconds, unsigned long long seed, int bestTour[]);
+
+
+
+//------------- Benchmark Declarations
+
+// The instance sizes the benchmark generates, in number of delivery locations (not counting the depot)
+#define BENCHMARK_NUMBER_OF_SIZES 12
+const int benchmarkSizes[BENCHMARK_NUMBER_OF_SIZES] = {5, 8, 10, 20, 50, 100, 200, 500, 1000, 2000, 5000, 10000};
+
+// The largest instance the exact permutation search is run on, and optimality gaps are measured for
+#define BENCHMARK_MAX_EXACT_STOPS 10
+
+// The largest instance the annealing search is run on. Bigger instances need more time than a benchmark row should take
+#define BENCHMARK_MAX_ANNEALING_STOPS 2000
+
+// The capacity of each vehicle in generated instances, with demands drawn from 1 to BENCHMARK_MAX_DEMAND
+#define BENCHMARK_VEHICLE_CAPACITY 100
+#define BENCHMARK_MAX_DEMAND 20
+
+// The side length of the square generated locations are placed in, the depot is at its centre
+#define BENCHMARK_AREA_SIZE 1000.0f
+
+/**
+* Function generateDeliveryInstance - Generates a reproducible random fleet instance
+*
+* Uniform instances scatter the locations evenly over the area. Clustered instances place them in normally
+* distributed groups of about 50 around random centres, like deliveries to towns. The same seed always gives the
+* same instance on every platform, as the generator does not use rand()
+*
+* Copyright Daniel Marcovecchio
+*
+* Dependencies: stdlib.h, math.h
+*
+* @author https://github.com/BlackHat0001
+*
+* @param instance (DeliveryInstance*) - The instance to fill, free with freeDeliveryInstance
+* @param numberOfDeliveries (int) - The number of delivery locations, the depot is added to these
+* @param clustered (int) - 1 for clustered locations, 0 for uniform
+* @param seed (unsigned long long) - The seed of the generator
+*/
+void generateDeliveryInstance(DeliveryInstance* instance, int numberOfDeliveries, int clustered, unsigned long long seed);
+
+
+
+/**
+* Function runPlannerBenchmark - Times every solver on generated instances and writes the results as CSV
+*
+* For each size up to maxDeliveries, a uniform and a clustered instance are generated and solved by the exact
+* permutation search (small sizes only), the savings planner with a single unlimited vehicle (a single tour), the
+* annealing search for a single tour (up to BENCHMARK_MAX_ANNEALING_STOPS) and the savings planner with capacity limits. Each row records the distance, vehicles, wall clock time, peak heap
+* memory and, where the exact search was run, the gap of the single tour to the optimum
+*
+* Copyright Daniel Marcovecchio
+*
+* Dependencies: stdio.h, stdlib.h
+*
+* @author https://github.com/BlackHat0001
+*
+* @param csvPath (const char*) - The file to write the CSV to, or "-" for stdout
+* @param maxDeliveries (int) - The largest instance size to run
+* @param annealingSeconds (double) - The time budget of each annealing search
+*
+* @return exitCode (int) - 0 if the benchmark ran, -1 if the CSV file could not be opened
+*/
+int runPlannerBenchmark(const char* csvPath, int maxDeliveries, double annealingSeconds);
+
+
+
+//------------- Helper Functions
+
+/**
+* Function copyRouteWithOrigin - Writes a route into a caller owned array with the depot origin added to the beginning and end
+* E.g. [1, 2, 3] -> [0, 1, 2, 3, 0]
+* Unlike addOrigin this does not allocate, so is safe to call for every permutation in the search
+*
+* Copyright Daniel Marcovecchio
+*
+* @author https://github.com/BlackHat0001
+* @param route[] (int) - The input array
+* @param routeSize (int) - The size of the input array
+* @param routeWithOrigin[] (int) - The output array, must have space for routeSize+2 elements
+*/
+void copyRouteWithOrigin(int route[],
+                         int routeSize,
+                         int routeWithOrigin[]) {
+    // Set the first element of the output array to zero (the origin for the depot)
+    routeWithOrigin[0] = 0;
+    // Now we loop for over the input array and append the contents to the output array
+    for (int i = 0; i < routeSize; i++) {
+        routeWithOrigin[i+1] = route[i];
+    }
+    // Finally set the last element to zero. This being the destination of the depot
+    routeWithOrigin[routeSize+1] = 0;
+}
+
+/**
+* Function addOrigin - Adds the depot origin to the beginning and end of an array
+* E.g. [1, 2, 3] -> [0, 1, 2, 3, 0]
+*
+* Copyright Daniel Marcovecchio
+*
+* @author https://github.com/BlackHat0001
+* @param route[] (int) - The input array
+* @param routeSize (int) - The size of the input array
+* @return routeWithOrigin (int*) - Pointer to the new array
+*/
+int* addOrigin(int route[],
+               int routeSize) {
+    // Dynamically allocate memory for a new array, 2 bigger than the input array
+    // Stores this in the routeWithOrigin pointer
+    int* routeWithOrigin = (int*) malloc((routeSize+2) * sizeof(int));
+
+    // Fill the new array with the route between the depot origin and destination
+    copyRouteWithOrigin(route, routeSize, routeWithOrigin);
+
+    // Return the pointer to the routeWithOrigin array
+    return routeWithOrigin;
+}
+
+/**
+* Function swap - Swaps the ith and jth elements of an array
+* E.g. [1, 2, 3] -> [1, 3, 2] where i=1, j=2
+*
+* Copyright Daniel Marcovecchio
+*
+* @author https://github.com/BlackHat0001
+* @param array[] (int) - The input array
+* @param i (int) - The ith element to swap
+* @param j (int) - The jth element to swap
+* @return routeWithOrigin (int*) - The swapped array
+*/
+void swap(int array[], int i, int j) {
+    // Store the element at the ith position, swap, and replace at the new jth position
+    int temp = array[i];
+    array[i] = array[j];
+    array[j] = temp;
+}
+
+/**
+* Function legDistance - Returns the cost of travelling between two of the possible locations
+* This is the road network cost if one has been loaded, else the straight-line distance using distanceAToB
+*
+* Copyright Daniel Marcovecchio
+*
+* @author https://github.com/BlackHat0001
+* @param xCoordLocations[] (float) - The x coordinate array of all possible delivery locations
+* @param yCoordLocations[] (float) - The y coordinate array of all possible delivery locations
+* @param pointA (int) - The location ID the leg starts at
+* @param pointB (int) - The location ID the leg finishes at
+* @return distance (float) - The cost of the leg from pointA to pointB
+*/
+float legDistance(float xCoordLocations[], float yCoordLocations[], int pointA, int pointB) {
+    if(roadCostOfPossibleLocations != NULL) {
+        return roadCostOfPossibleLocations[pointA * numberOfRoadCostLocations + pointB];
+    }
+    return distanceAToB(xCoordLocations[pointA], yCoordLocations[pointA], xCoordLocations[pointB], yCoordLocations[pointB]);
+}
+
+/**
+* Functions plannerMalloc, plannerCalloc, plannerRealloc, plannerFree - Heap allocation that counts the planner's memory
+* Each block stores its size in a header in front of it, so plannerBytesInUse and plannerPeakBytes can be kept
+* These are not thread safe, so must not be called from inside a parallel region
+*
+* Copyright Daniel Marcovecchio
+*
+* Dependencies: stdlib.h, string.h
+*
+* @author https://github.com/BlackHat0001
+*/
+#define PLANNER_ALLOCATION_HEADER 16
+
+void* plannerMalloc(size_t size) {
+    // Allocate space for the header too, and record the size in it
+    char* block = (char*) malloc(size + PLANNER_ALLOCATION_HEADER);
+    if(block == NULL) {
+        return NULL;
+    }
+    *(size_t*) block = size;
+
+    // Count the new block, and raise the peak if this is the most held at once
+    plannerBytesInUse += size;
+    if(plannerBytesInUse > plannerPeakBytes) {
+        plannerPeakBytes = plannerBytesInUse;
+    }
+    return block + PLANNER_ALLOCATION_HEADER;
+}
+
+void* plannerCalloc(size_t count, size_t size) {
+    void* block = plannerMalloc(count * size);
+    if(block != NULL) {
+        memset(block, 0, count * size);
+    }
+    return block;
+}
+
+void plannerFree(void* pointer) {
+    if(pointer == NULL) {
+        return;
+    }
+    char* block = (char*) pointer - PLANNER_ALLOCATION_HEADER;
+    plannerBytesInUse -= *(size_t*) block;
+    free(block);
+}
+
+void* plannerRealloc(void* pointer, size_t size) {
+    if(pointer == NULL) {
+        return plannerMalloc(size);
+    }
+    char* block = (char*) pointer - PLANNER_ALLOCATION_HEADER;
+    size_t oldSize = *(size_t*) block;
+    block = (char*) realloc(block, size + PLANNER_ALLOCATION_HEADER);
+    if(block == NULL) {
+        return NULL;
+    }
+    *(size_t*) block = size;
+    plannerBytesInUse = plannerBytesInUse - oldSize + size;
+    if(plannerBytesInUse > plannerPeakBytes) {
+        plannerPeakBytes = plannerBytesInUse;
+    }
+    return block + PLANNER_ALLOCATION_HEADER;
+}
+
+//------------- Trace Functions
+
+int openRouteTrace(const char* path, size_t bufferSize) {
+    // Function to open the trace stream and give it a large buffer
+
+    // Close any trace that is already open, so we never leak a stream or its buffer
+    closeRouteTrace();
+
+    // With no file the trace stays on stdout, which the C library already fully buffers when redirected to a file
+    // Its buffering is left alone, as setvbuf may only be called before a stream is first used
+    if(path == NULL) {
+        return 1;
+    }
+
+    routeTraceFile = fopen(path, "w");
+    if(routeTraceFile == NULL) {
+        printf("Error: Could not open trace file %s\n", path);
+        return 0;
+    }
+
+    // Give the file a large fully buffered block, so lines are only written out once the buffer fills
+    // This must be done before anything is written to the file
+    if(bufferSize > 0) {
+        routeTraceBuffer = (char*) malloc(bufferSize);
+        if(routeTraceBuffer != NULL) {
+            setvbuf(routeTraceFile, routeTraceBuffer, _IOFBF, bufferSize);
+        }
+    }
+    return 1;
+}
+
+void closeRouteTrace() {
+    // Function to flush and close the trace stream
+
+    // Flush whatever is still waiting in the buffer
+    fflush(routeTraceFile != NULL ? routeTraceFile : stdout);
+
+    // Close the trace file if we opened one, stdout is left open for the rest of the program
+    if(routeTraceFile != NULL) {
+        fclose(routeTraceFile);
+        routeTraceFile = NULL;
+    }
+
+    // The buffer is only freed once its file is closed and no longer using it
+    free(routeTraceBuffer);
+    routeTraceBuffer = NULL;
+}
+
+void resetRouteSearchCounters() {
+    // Function to zero all counters and start the timer for a new search
+    memset(&routeSearchCounters, 0, sizeof(routeSearchCounters));
+    routeSearchCounters.searchStartTime = clock();
+}
+
+void reportRouteSearchCounters() {
+    // Function to stop the timer and print the counters of the last search
+
+    routeSearchCounters.searchEndTime = clock();
+
+    // Only report if the summary trace level is enabled
+    if(!ROUTE_TRACE_ENABLED(ROUTE_TRACE_SUMMARY)) {
+        return;
+    }
+
+    // Compute the search time in seconds, and the number of routes evaluated per second
+    double searchTime = (double)(routeSearchCounters.searchEndTime - routeSearchCounters.searchStartTime)/CLOCKS_PER_SEC;
+    double routesPerSecond = searchTime > 0 ? routeSearchCounters.routesEvaluated / searchTime : 0;
+
+    FILE* stream = routeTraceFile != NULL ? routeTraceFile : stdout;
+    fprintf(stream, "Search counters | Nodes explored: %llu | Nodes pruned: %llu | Routes evaluated: %llu"
+                    " | Search time: %3.4f seconds | Routes evaluated per second: %.0f\n",
+            routeSearchCounters.nodesExplored, routeSearchCounters.nodesPruned, routeSearchCounters.routesEvaluated,
+            searchTime, routesPerSecond);
+    fflush(stream);
+}
+
+//-------------
+
+
+
+float distanceAToB(float pointAXCoord, float pointAYCoord, float pointBXCoord, float pointBYCoord) {
+    // Function to compute and return the distance between 2D points A and B
+
+    // Computes the difference of the X coordinates, and Y coordinates, squares and sum them, then square roots them
+    // Follows this formula D = sqrt((bX-aX)^2 + (bY-aY)^2)
+    return sqrt(pow((pointBXCoord - pointAXCoord), 2) + pow((pointBYCoord - pointAYCoord), 2));
+}
+
+
+
+float totalDistanceOfRoute(float xCoordLocations[], float yCoordLocations[], int routeLocations[]) {
+    // Function to compute the total distance of a route
+
+    // First we check to see the route does start and end at the origin (0, 0) ID: 0
+    if(routeLocations[0] != 0 || routeLocations[routeLength+1] != 0) {
+        // If it does not, terminate the program as we do not want to continue computation
+        printf("Error: Route does not start or finish at depot. Program terminating...\n");
+        exit(-1);
+    }
+
+    // Define the total distance var to be used in summing all distances in the loop
+    float totalDistance = 0;
+
+    // Define the route length including the start and end point
+    int routeLengthIncOrigin = routeLength + 2;
+
+    // Loop for locations in this route
+    for (int i = 0; i < routeLengthIncOrigin-1; i++) {
+
+        // Retrieve the current location and the next location, by indexing the now at i, and one aheaad at i+1
+        // This becomes the pointA and pointB for this location
+        int pointA = routeLocations[i];
+        int pointB = routeLocations[i+1];
+
+        // Compute the distance between points A and B, and sum this to the total distance of the route
+        // This is the road distance if a road network has been loaded, else the straight-line distance
+        totalDistance += legDistance(xCoordLocations, yCoordLocations, pointA, pointB);
+    }
+
+    // There is no requirement to check if the route has returned to the depot as we have already confirmed that the route contains this
+
+    return totalDistance;
+}
+
+
+
+float permutateRoutes(int route[], int index, float shortestDistance, int shortestRoute[]) {
+    // Function to recursivley generate all permutations of the selected locations
+    // and finds the shortest possible route of these permutations
+
+    // Count this node of the permutation tree
+    routeSearchCounters.nodesExplored++;
+
+    // If the current index of the search for this permutation has reached the end of the array,
+    // then this permutation is complete. This is then where the distance for this route is calculated
+    if (index == routeLength - 1) {
+
+        // Add the depot origin and destination to this permutation
+        // E.g. [1, 2, 3] -> [0, 1, 2, 3, 0]
+        // This is written into a stack array, as allocating for every permutation would dominate the search
+        int routeWithOrigin[routeLength+2];
+        copyRouteWithOrigin(route, routeLength, routeWithOrigin);
+
+        // Calculate the distance of this permutation (route) using totalDistanceOfRoute
+        // Passing in the predefined list of possible locations
+        float distance = totalDistanceOfRoute(xCoordOfPossibleLocations, yCoordOfPossibleLocations, routeWithOrigin);
+        routeSearchCounters.routesEvaluated++;
+
+        // Log every tested route only if the highest trace level is selected
+        if(ROUTE_TRACE_ENABLED(ROUTE_TRACE_ALL_ROUTES)) {
+            FILE* stream = routeTraceFile != NULL ? routeTraceFile : stdout;
+            fprintf(stream, "Tested Route: ");
+            // Loop over the current permutation for logging perposes
+            for(int i=0; i<routeLength+2; i++) {
+                fprintf(stream, "%d ", routeWithOrigin[i]);
+            }
+            fprintf(stream, "| Calculated Distance: %f\n", distance);
+        }
+
+        // If this distance is less than the shortest found elsewhere in the tree,
+        // known via the shortestDistance parameter, then a new shortest route has been found
+        if(distance < shortestDistance) {
+            // Copy this permutation (route) to the shortestRoute pointer
+            for (int i = 0; i < routeLength; i++) {
+                shortestRoute[i] = route[i];
+            }
+
+            if(ROUTE_TRACE_ENABLED(ROUTE_TRACE_IMPROVEMENTS)) {
+                fprintf(routeTraceFile != NULL ? routeTraceFile : stdout, "New shortest distance: %f\n", distance);
+            }
+
+            // Return this distance up the tree to be used as the new shortestDistance
+            return distance;
+        }
+
+    // Else, this permutation is not at the end yet, so continue searching
+    } else {
+
+        // Before branching, check if this branch can still beat the shortest route
+        // The locations fixed so far are route[0] to route[index-1], travelled from the depot in order
+        // Any completion of this branch must then return to the depot, which by the triangle inequality is never
+        // shorter than travelling straight back, so prefix + straight return is a lower bound for the whole branch
+        if (index > 0) {
+            // Road distances are shortest paths, so obey the triangle inequality just like straight lines
+            float prefixDistance = legDistance(xCoordOfPossibleLocations, yCoordOfPossibleLocations, 0, route[0]);
+            for (int i = 1; i < index; i++) {
+                prefixDistance += legDistance(xCoordOfPossibleLocations, yCoordOfPossibleLocations, route[i-1], route[i]);
+            }
+            float lowerBound = prefixDistance
+                               + legDistance(xCoordOfPossibleLocations, yCoordOfPossibleLocations, route[index-1], 0);
+
+            // If even the lower bound is no better than the shortest found, no route in this branch can be, so cut it
+            if (lowerBound >= shortestDistance) {
+                routeSearchCounters.nodesPruned++;
+                return shortestDistance;
+            }
+        }
+
+        // Loop over the rest of this permutation from the current index
+        for (int k = index; k < routeLength; k++) {
+
+            // Swap the current index and the next element
+            // [1, 2, 3] -> [1, 3, 2] where index=1, k=2
+            swap(route, index, k);
+
+            // The function calls itself to permutate the rest of this permutation
+            // Searches the next "branch of the tree"
+            // The shortestDistance is updated to what this function returns
+            // It will be the same if no new shortest is found, else will update if the next shortest is found
+            shortestDistance = permutateRoutes(route, index+1, shortestDistance, shortestRoute);
+
+            // Un-swap the current index and the next element
+            swap(route, index, k);
+
+        }
+    }
+
+    // Return the current shortestDistance up the tree, if no new shortest was found
+    return shortestDistance;
+}
+
+
+//------------- Fleet Routing (CVRP)
+
+// The kinds of local search move tried between two routes
+#define FLEET_MOVE_NONE 0
+#define FLEET_MOVE_RELOCATE 1
+#define FLEET_MOVE_SWAP 2
+
+/** Struct FleetSaving
+* The Clarke-Wright saving of serving stops a and b on one route instead of two separate trips from the depot
+*/
+typedef struct {
+    int a;
+    int b;
+    float saving;
+} FleetSaving;
+
+/** Struct FleetMove
+* The best move found for one stop during a local search pass
+* Relocate moves the stop next to the other stop (after it if insertAfter is set), swap exchanges the two stops
+*/
+typedef struct {
+    float delta;
+    int type;
+    int stop;
+    int other;
+    int insertAfter;
+} FleetMove;
+
+/**
+* Function wallClockSeconds - Returns a wall clock time in seconds, for timing parallel code
+* Uses the OpenMP timer when built with OpenMP, as clock() sums the time of every thread
+*
+* Copyright Daniel Marcovecchio
+*
+* Dependencies: time.h, omp.h if built with OpenMP
+*
+* @author https://github.com/BlackHat0001
+* @return seconds (double) - Seconds since an arbitrary fixed point
+*/
+double wallClockSeconds() {
+#ifdef _OPENMP
+    return omp_get_wtime();
+#else
+    return (double) clock()/CLOCKS_PER_SEC;
+#endif
+}
+
+int loadDeliveryInstance(const char* path, DeliveryInstance* instance) {
+    // Function to read a fleet instance from a text file
+
+    memset(instance, 0, sizeof(*instance));
+
+    FILE* file = fopen(path, "r");
+    if(file == NULL) {
+        printf("Error: Could not open instance file %s\n", path);
+        return 0;
+    }
+
+    // The header (fleet size and capacity) is the first line that is not a comment
+    int headerRead = 0;
+    // The number of locations there is currently space for, the arrays are doubled as they fill
+    int allocatedStops = 0;
+    char line[256];
+
+    while(fgets(line, sizeof(line), file) != NULL) {
+        // Skip any leading whitespace, then skip comments and blank lines
+        char* first = line;
+        while(*first == ' ' || *first == '\t') {
+            first++;
+        }
+        if(*first == '#' || *first == '\n' || *first == '\r' || *first == '\0') {
+            continue;
+        }
+
+        if(!headerRead) {
+            if(sscanf(first, "%d %d", &instance->fleetSize, &instance->vehicleCapacity) != 2
+               || instance->fleetSize < 1 || instance->vehicleCapacity < 1) {
+                printf("Error: Instance %s must start with a fleet size and capacity of at least 1\n", path);
+                fclose(file);
+                return 0;
+            }
+            headerRead = 1;
+            continue;
+        }
+
+        // Every other line is a location
+        float x, y;
+        int demand;
+        if(sscanf(first, "%f %f %d", &x, &y, &demand) != 3 || demand < 0) {
+            printf("Error: Malformed location line in %s: %s", path, line);
+            fclose(file);
+            freeDeliveryInstance(instance);
+            return 0;
+        }
+
+        // Grow the arrays if they are full
+        if(instance->numberOfStops == allocatedStops) {
+            allocatedStops = allocatedStops > 0 ? allocatedStops * 2 : 64;
+            float* xCoords = (float*) plannerRealloc(instance->xCoords, allocatedStops * sizeof(float));
+            float* yCoords = (float*) plannerRealloc(instance->yCoords, allocatedStops * sizeof(float));
+            int* demands = (int*) plannerRealloc(instance->demands, allocatedStops * sizeof(int));
+            if(xCoords != NULL) instance->xCoords = xCoords;
+            if(yCoords != NULL) instance->yCoords = yCoords;
+            if(demands != NULL) instance->demands = demands;
+            if(xCoords == NULL || yCoords == NULL || demands == NULL) {
+                printf("Error: Out of memory reading %s\n", path);
+                fclose(file);
+                freeDeliveryInstance(instance);
+                return 0;
+            }
+        }
+
+        instance->xCoords[instance->numberOfStops] = x;
+        instance->yCoords[instance->numberOfStops] = y;
+        instance->demands[instance->numberOfStops] = demand;
+        instance->numberOfStops++;
+    }
+    fclose(file);
+
+    // There must be a depot and at least one stop to deliver to
+    if(instance->numberOfStops < 2) {
+        printf("Error: Instance %s needs a depot and at least one delivery location\n", path);
+        freeDeliveryInstance(instance);
+        return 0;
+    }
+
+    // The depot has nothing to deliver, and every stop must fit in a single vehicle
+    instance->demands[0] = 0;
+    for(int i = 1; i < instance->numberOfStops; i++) {
+        if(instance->demands[i] > instance->vehicleCapacity) {
+            printf("Error: Location %d demand %d is more than the vehicle capacity %d\n",
+                   i, instance->demands[i], instance->vehicleCapacity);
+            freeDeliveryInstance(instance);
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+void freeDeliveryInstance(DeliveryInstance* instance) {
+    // Function to free the arrays owned by an instance
+    plannerFree(instance->xCoords);
+    plannerFree(instance->yCoords);
+    plannerFree(instance->demands);
+    plannerFree(instance->distanceMatrix);
+    memset(instance, 0, sizeof(*instance));
+}
+
+float stopDistance(const DeliveryInstance* instance, int a, int b) {
+    // Function to return the distance of a leg, from the matrix if there is one
+
+    if(instance->distanceMatrix != NULL) {
+        return instance->distanceMatrix[(size_t) a * instance->numberOfStops + b];
+    }
+
+    // Same formula as distanceAToB, written with sqrtf as this is called for every move of the local search
+    float dx = instance->xCoords[b] - instance->xCoords[a];
+    float dy = instance->yCoords[b] - instance->yCoords[a];
+    return sqrtf(dx*dx + dy*dy);
+}
+
+void buildDistanceMatrix(DeliveryInstance* instance) {
+    // Function to precompute every leg distance of an instance
+
+    int n = instance->numberOfStops;
+    if(instance->distanceMatrix != NULL || n > FLEET_MAX_MATRIX_STOPS) {
+        return;
+    }
+
+    float* matrix = (float*) plannerMalloc((size_t) n * n * sizeof(float));
+    if(matrix == NULL) {
+        return;
+    }
+
+    // Every row is independent, so the rows are filled in parallel
+    #pragma omp parallel for schedule(static)
+    for(int a = 0; a < n; a++) {
+        for(int b = 0; b < n; b++) {
+            matrix[(size_t) a * n + b] = stopDistance(instance, a, b);
+        }
+    }
+
+    // Only publish the matrix once it is complete, as stopDistance reads it as soon as it is set
+    instance->distanceMatrix = matrix;
+}
+
+/**
+* Function buildNeighbourLists - Finds the nearest stops to every stop, excluding the depot and the stop itself
+*
+* Copyright Daniel Marcovecchio
+*
+* @author https://github.com/BlackHat0001
+* @param instance (const DeliveryInstance*) - The instance to search
+* @param neighbourCount (int) - The number of neighbours to keep per stop, must be less than the number of stops
+* @return neighbours (int*) - neighbourCount nearest stops for every stop, nearest first. Row 0 (depot) is unused
+*/
+int* buildNeighbourLists(const DeliveryInstance* instance, int neighbourCount) {
+    int n = instance->numberOfStops;
+    int* neighbours = (int*) plannerMalloc((size_t) n * neighbourCount * sizeof(int));
+    if(neighbours == NULL) {
+        return NULL;
+    }
+
+    #pragma omp parallel
+    {
+        // Each thread keeps the distances of its current nearest list, sorted nearest first
+        float nearestDistances[neighbourCount];
+
+        #pragma omp for schedule(dynamic, 64)
+        for(int s = 1; s < n; s++) {
+            int* nearest = &neighbours[(size_t) s * neighbourCount];
+            int found = 0;
+
+            for(int t = 1; t < n; t++) {
+                if(t == s) {
+                    continue;
+                }
+                float distance = stopDistance(instance, s, t);
+
+                // Skip anything further than the furthest neighbour kept so far, once the list is full
+                if(found == neighbourCount && distance >= nearestDistances[found-1]) {
+                    continue;
+                }
+
+                // Insertion sort this stop into the nearest list, dropping the furthest if the list is full
+                int i = found < neighbourCount ? found++ : found-1;
+                while(i > 0 && nearestDistances[i-1] > distance) {
+                    nearestDistances[i] = nearestDistances[i-1];
+                    nearest[i] = nearest[i-1];
+                    i--;
+                }
+                nearestDistances[i] = distance;
+                nearest[i] = t;
+            }
+        }
+    }
+
+    return neighbours;
+}
+
+/**
+* Function compareSavings - qsort comparator ordering savings from largest to smallest
+*
+* Copyright Daniel Marcovecchio
+*
+* @author https://github.com/BlackHat0001
+*/
+int compareSavings(const void* x, const void* y) {
+    float a = ((const FleetSaving*) x)->saving;
+    float b = ((const FleetSaving*) y)->saving;
+    return (a < b) - (a > b);
+}
+
+/**
+* Function compareFleetMoves - qsort comparator ordering moves from most to least improving
+*
+* Copyright Daniel Marcovecchio
+*
+* @author https://github.com/BlackHat0001
+*/
+int compareFleetMoves(const void* x, const void* y) {
+    float a = ((const FleetMove*) x)->delta;
+    float b = ((const FleetMove*) y)->delta;
+    return (a > b) - (a < b);
+}
+
+/**
+* Function reverseLinkedRoute - Reverses a route held as a linked list during savings construction
+*
+* Copyright Daniel Marcovecchio
+*
+* @author https://github.com/BlackHat0001
+* @param next[], prev[] (int) - The links of every stop, 0 meaning the depot
+* @param head, tail (int*) - The first and last stop of the route, swapped by this function
+*/
+void reverseLinkedRoute(int next[], int prev[], int* head, int* tail) {
+    // Walk the route from its head, swapping the next and prev links of every stop
+    int s = *head;
+    while(s != 0) {
+        int following = next[s];
+        next[s] = prev[s];
+        prev[s] = following;
+        s = following;
+    }
+    int oldHead = *head;
+    *head = *tail;
+    *tail = oldHead;
+}
+
+/**
+* Function clarkeWrightSavings - Builds initial routes with the Clarke-Wright savings method
+*
+* Method - Every stop starts on its own trip from the depot. The savings d(0,a) + d(0,b) - d(a,b) are sorted, and
+* for each saving the routes of a and b are joined if both are at the end of their routes and the load fits
+*
+* Copyright Daniel Marcovecchio
+*
+* @author https://github.com/BlackHat0001
+* @param instance (const DeliveryInstance*) - The instance to plan
+* @param neighbours (const int*) - The neighbour lists, only savings between neighbours are considered
+* @param neighbourCount (int) - The number of neighbours per stop
+* @param plan (FleetPlan*) - The plan to fill
+* @return success (int) - 1 if the plan was built, 0 if out of memory
+*/
+int clarkeWrightSavings(const DeliveryInstance* instance, const int* neighbours, int neighbourCount, FleetPlan* plan) {
+    int n = instance->numberOfStops;
+
+    // Compute the savings for every stop and each of its neighbours, keeping only those which save distance
+    // A pair may appear twice if each is the neighbour of the other, the second is skipped as they are already joined
+    FleetSaving* savings = (FleetSaving*) plannerMalloc((size_t) n * neighbourCount * sizeof(FleetSaving));
+    if(savings == NULL) {
+        return 0;
+    }
+    int numberOfSavings = 0;
+    for(int a = 1; a < n; a++) {
+        for(int k = 0; k < neighbourCount; k++) {
+            int b = neighbours[(size_t) a * neighbourCount + k];
+            float saving = stopDistance(instance, 0, a) + stopDistance(instance, 0, b) - stopDistance(instance, a, b);
+            if(saving > 0) {
+                savings[numberOfSavings].a = a;
+                savings[numberOfSavings].b = b;
+                savings[numberOfSavings].saving = saving;
+                numberOfSavings++;
+            }
+        }
+    }
+    qsort(savings, numberOfSavings, sizeof(FleetSaving), compareSavings);
+
+    // Routes are linked lists during construction. Links of 0 mean the depot, as stop IDs start at 1
+    // Each route is known by an ID, stored for every stop, with its head, tail, load and size stored by ID
+    int* next = (int*) plannerCalloc(n, sizeof(int));
+    int* prev = (int*) plannerCalloc(n, sizeof(int));
+    int* routeId = (int*) plannerMalloc(n * sizeof(int));
+    int* head = (int*) plannerMalloc(n * sizeof(int));
+    int* tail = (int*) plannerMalloc(n * sizeof(int));
+    int* load = (int*) plannerMalloc(n * sizeof(int));
+    int* size = (int*) plannerMalloc(n * sizeof(int));
+
+    // Begin with every stop on its own route
+    for(int s = 1; s < n; s++) {
+        routeId[s] = s;
+        head[s] = s;
+        tail[s] = s;
+        load[s] = instance->demands[s];
+        size[s] = 1;
+    }
+
+    for(int i = 0; i < numberOfSavings; i++) {
+        int a = savings[i].a;
+        int b = savings[i].b;
+        int routeA = routeId[a];
+        int routeB = routeId[b];
+
+        // Both stops must be on different routes, at an end next to the depot, and the joined load must fit
+        if(routeA == routeB
+           || (prev[a] != 0 && next[a] != 0)
+           || (prev[b] != 0 && next[b] != 0)
+           || load[routeA] + load[routeB] > instance->vehicleCapacity) {
+            continue;
+        }
+
+        // Turn the routes so route A finishes at a and route B starts at b, then link a to b
+        if(tail[routeA] != a) {
+            reverseLinkedRoute(next, prev, &head[routeA], &tail[routeA]);
+        }
+        if(head[routeB] != b) {
+            reverseLinkedRoute(next, prev, &head[routeB], &tail[routeB]);
+        }
+        next[a] = b;
+        prev[b] = a;
+
+        // Keep the ID of the larger route, so only the smaller route's stops need relabelling
+        int keptRoute = size[routeA] >= size[routeB] ? routeA : routeB;
+        if(keptRoute == routeA) {
+            for(int s = b; s != 0; s = next[s]) {
+                routeId[s] = routeA;
+            }
+        } else {
+            for(int s = head[routeA]; s != b; s = next[s]) {
+                routeId[s] = routeB;
+            }
+        }
+        int joinedLoad = load[routeA] + load[routeB];
+        int joinedSize = size[routeA] + size[routeB];
+        head[keptRoute] = head[routeA];
+        tail[keptRoute] = tail[routeB];
+        load[keptRoute] = joinedLoad;
+        size[keptRoute] = joinedSize;
+    }
+
+    // Count the routes, which start at every stop linked from the depot
+    int numberOfRoutes = 0;
+    for(int s = 1; s < n; s++) {
+        if(prev[s] == 0) {
+            numberOfRoutes++;
+        }
+    }
+
+    // Copy the linked routes into the arrays of the plan
+    plan->numberOfRoutes = numberOfRoutes;
+    plan->routes = (int**) plannerMalloc(numberOfRoutes * sizeof(int*));
+    plan->routeSizes = (int*) plannerMalloc(numberOfRoutes * sizeof(int));
+    plan->routeAllocations = (int*) plannerMalloc(numberOfRoutes * sizeof(int));
+    plan->routeLoads = (int*) plannerMalloc(numberOfRoutes * sizeof(int));
+    plan->routeOfStop = (int*) plannerMalloc(n * sizeof(int));
+    plan->positionOfStop = (int*) plannerMalloc(n * sizeof(int));
+    plan->routeOfStop[0] = -1;
+    plan->positionOfStop[0] = -1;
+
+    int r = 0;
+    for(int s = 1; s < n; s++) {
+        if(prev[s] != 0) {
+            continue;
+        }
+        int id = routeId[s];
+        plan->routeSizes[r] = size[id];
+        plan->routeAllocations[r] = size[id];
+        plan->routeLoads[r] = load[id];
+        plan->routes[r] = (int*) plannerMalloc(size[id] * sizeof(int));
+        int position = 0;
+        for(int t = s; t != 0; t = next[t]) {
+            plan->routes[r][position] = t;
+            plan->routeOfStop[t] = r;
+            plan->positionOfStop[t] = position;
+            position++;
+        }
+        r++;
+    }
+
+    plannerFree(savings);
+    plannerFree(next);
+    plannerFree(prev);
+    plannerFree(routeId);
+    plannerFree(head);
+    plannerFree(tail);
+    plannerFree(load);
+    plannerFree(size);
+    return 1;
+}
+
+/**
+* Function stopBefore / stopAfter - Return the stop before or after a position on a route, 0 being the depot
+*
+* Copyright Daniel Marcovecchio
+*
+* @author https://github.com/BlackHat0001
+*/
+int stopBefore(const FleetPlan* plan, int route, int position) {
+    return position > 0 ? plan->routes[route][position-1] : 0;
+}
+int stopAfter(const FleetPlan* plan, int route, int position) {
+    return position < plan->routeSizes[route]-1 ? plan->routes[route][position+1] : 0;
+}
+
+/**
+* Function findBestFleetMove - Finds the best relocate or swap of a stop with any of its neighbours on another route
+*
+* Copyright Daniel Marcovecchio
+*
+* @author https://github.com/BlackHat0001
+* @param instance (const DeliveryInstance*) - The instance being planned
+* @param plan (const FleetPlan*) - The current plan, which is only read
+* @param neighbours (const int*) - The neighbour lists
+* @param neighbourCount (int) - The number of neighbours per stop
+* @param s (int) - The stop to find a move for
+* @return move (FleetMove) - The best move, with type FLEET_MOVE_NONE if nothing improves the plan
+*/
+FleetMove findBestFleetMove(const DeliveryInstance* instance, const FleetPlan* plan,
+                            const int* neighbours, int neighbourCount, int s) {
+    FleetMove best;
+    best.delta = -FLEET_IMPROVEMENT_EPSILON;
+    best.type = FLEET_MOVE_NONE;
+    best.stop = s;
+    best.other = 0;
+    best.insertAfter = 0;
+
+    int capacity = instance->vehicleCapacity;
+    int routeA = plan->routeOfStop[s];
+    int positionS = plan->positionOfStop[s];
+    int beforeS = stopBefore(plan, routeA, positionS);
+    int afterS = stopAfter(plan, routeA, positionS);
+
+    // The distance saved by taking s out of its route and joining its neighbours directly
+    float removeGain = stopDistance(instance, beforeS, s) + stopDistance(instance, s, afterS)
+                       - stopDistance(instance, beforeS, afterS);
+
+    for(int k = 0; k < neighbourCount; k++) {
+        int v = neighbours[(size_t) s * neighbourCount + k];
+        int routeB = plan->routeOfStop[v];
+        if(routeB == routeA) {
+            continue;
+        }
+        int positionV = plan->positionOfStop[v];
+        int beforeV = stopBefore(plan, routeB, positionV);
+        int afterV = stopAfter(plan, routeB, positionV);
+
+        // Relocate s to just before or just after v, if route B has the capacity for it
+        if(plan->routeLoads[routeB] + instance->demands[s] <= capacity) {
+            float insertBefore = stopDistance(instance, beforeV, s) + stopDistance(instance, s, v)
+                                 - stopDistance(instance, beforeV, v) - removeGain;
+            float insertAfter = stopDistance(instance, v, s) + stopDistance(instance, s, afterV)
+                                - stopDistance(instance, v, afterV) - removeGain;
+            if(insertBefore < best.delta) {
+                best.delta = insertBefore;
+                best.type = FLEET_MOVE_RELOCATE;
+                best.other = v;
+                best.insertAfter = 0;
+            }
+            if(insertAfter < best.delta) {
+                best.delta = insertAfter;
+                best.type = FLEET_MOVE_RELOCATE;
+                best.other = v;
+                best.insertAfter = 1;
+            }
+        }
+
+        // Swap s and v, if both routes have the capacity after the exchange
+        if(plan->routeLoads[routeA] - instance->demands[s] + instance->demands[v] <= capacity
+           && plan->routeLoads[routeB] - instance->demands[v] + instance->demands[s] <= capacity) {
+            float swapDelta = stopDistance(instance, beforeS, v) + stopDistance(instance, v, afterS) - removeGain
+                              - stopDistance(instance, beforeS, afterS)
+                              + stopDistance(instance, beforeV, s) + stopDistance(instance, s, afterV)
+                              - stopDistance(instance, beforeV, v) - stopDistance(instance, v, afterV);
+            if(swapDelta < best.delta) {
+                best.delta = swapDelta;
+                best.type = FLEET_MOVE_SWAP;
+                best.other = v;
+                best.insertAfter = 0;
+            }
+        }
+    }
+
+    return best;
+}
+
+/**
+* Function applyFleetMove - Applies a relocate or swap move to the plan, updating loads and stop positions
+*
+* Copyright Daniel Marcovecchio
+*
+* @author https://github.com/BlackHat0001
+* @param instance (const DeliveryInstance*) - The instance being planned
+* @param plan (FleetPlan*) - The plan to change
+* @param move (const FleetMove*) - The move to apply, found by findBestFleetMove
+*/
+void applyFleetMove(const DeliveryInstance* instance, FleetPlan* plan, const FleetMove* move) {
+    int s = move->stop;
+    int v = move->other;
+    int routeA = plan->routeOfStop[s];
+    int routeB = plan->routeOfStop[v];
+    int positionS = plan->positionOfStop[s];
+
+    if(move->type == FLEET_MOVE_SWAP) {
+        // Exchange the two stops in place, the rest of both routes is unchanged
+        int positionV = plan->positionOfStop[v];
+        plan->routes[routeA][positionS] = v;
+        plan->routes[routeB][positionV] = s;
+        plan->routeOfStop[s] = routeB;
+        plan->routeOfStop[v] = routeA;
+        plan->positionOfStop[s] = positionV;
+        plan->positionOfStop[v] = positionS;
+        plan->routeLoads[routeA] += instance->demands[v] - instance->demands[s];
+        plan->routeLoads[routeB] += instance->demands[s] - instance->demands[v];
+        return;
+    }
+
+    // Relocate, first take s out of route A and close the gap
+    int* stopsA = plan->routes[routeA];
+    int sizeA = --plan->routeSizes[routeA];
+    memmove(&stopsA[positionS], &stopsA[positionS+1], (sizeA - positionS) * sizeof(int));
+    for(int i = positionS; i < sizeA; i++) {
+        plan->positionOfStop[stopsA[i]] = i;
+    }
+    plan->routeLoads[routeA] -= instance->demands[s];
+
+    // Make space in route B if it is full, doubling its allocation
+    if(plan->routeSizes[routeB] == plan->routeAllocations[routeB]) {
+        plan->routeAllocations[routeB] *= 2;
+        plan->routes[routeB] = (int*) plannerRealloc(plan->routes[routeB], plan->routeAllocations[routeB] * sizeof(int));
+    }
+
+    // Then open a gap next to v in route B and put s into it
+    int* stopsB = plan->routes[routeB];
+    int insertPosition = plan->positionOfStop[v] + (move->insertAfter ? 1 : 0);
+    int sizeB = plan->routeSizes[routeB]++;
+    memmove(&stopsB[insertPosition+1], &stopsB[insertPosition], (sizeB - insertPosition) * sizeof(int));
+    stopsB[insertPosition] = s;
+    for(int i = insertPosition; i <= sizeB; i++) {
+        plan->positionOfStop[stopsB[i]] = i;
+    }
+    plan->routeOfStop[s] = routeB;
+    plan->routeLoads[routeB] += instance->demands[s];
+}
+
+/**
+* Function twoOptRoute - Improves a single route with 2-opt, reversing segments while that shortens the route
+*
+* Method - Short routes try every segment. Longer routes only try segments which would join a stop to one of its
+* neighbours, which keeps a sweep linear in the route length rather than quadratic
+*
+* Copyright Daniel Marcovecchio
+*
+* @author https://github.com/BlackHat0001
+* @param instance (const DeliveryInstance*) - The instance being planned
+* @param plan (FleetPlan*) - The plan, only this route and the positions of its stops are changed
+* @param neighbours (const int*) - The neighbour lists
+* @param neighbourCount (int) - The number of neighbours per stop
+* @param route (int) - The route to improve
+* @return improved (int) - 1 if the route was shortened
+*/
+int twoOptRoute(const DeliveryInstance* instance, FleetPlan* plan, const int* neighbours, int neighbourCount, int route) {
+    int* stops = plan->routes[route];
+    int size = plan->routeSizes[route];
+    int improved = 0;
+    int improvedThisSweep = 1;
+
+    while(improvedThisSweep) {
+        improvedThisSweep = 0;
+        // Short routes also start from the depot at position -1, which has no neighbour list to search from
+        int firstPosition = size <= FLEET_FULL_TWO_OPT_STOPS ? -1 : 0;
+        for(int i = firstPosition; i < size-1; i++) {
+            int a = stopBefore(plan, route, i+1);
+
+            // Short routes try every j after i, long routes only the positions of the neighbours of the stop at i
+            int candidates = size <= FLEET_FULL_TWO_OPT_STOPS ? size : neighbourCount;
+            for(int k = 0; k < candidates; k++) {
+                int j;
+                if(size <= FLEET_FULL_TWO_OPT_STOPS) {
+                    j = k;
+                } else {
+                    int neighbour = neighbours[(size_t) a * neighbourCount + k];
+                    if(plan->routeOfStop[neighbour] != route) {
+                        continue;
+                    }
+                    j = plan->positionOfStop[neighbour];
+                }
+                if(j <= i+1) {
+                    continue;
+                }
+
+                // Reversing stops i+1 to j replaces the legs (a, b) and (c, d) with (a, c) and (b, d),
+                // so the stop at i is joined to the stop at j
+                int b = stops[i+1];
+                int c = stops[j];
+                int d = stopAfter(plan, route, j);
+                float delta = stopDistance(instance, a, c) + stopDistance(instance, b, d)
+                              - stopDistance(instance, a, b) - stopDistance(instance, c, d);
+                if(delta < -FLEET_IMPROVEMENT_EPSILON) {
+                    for(int left = i+1, right = j; left < right; left++, right--) {
+                        swap(stops, left, right);
+                    }
+                    // Positions are read by the neighbour lookups above, so keep the reversed segment's up to date
+                    for(int position = i+1; position <= j; position++) {
+                        plan->positionOfStop[stops[position]] = position;
+                    }
+                    improvedThisSweep = 1;
+                    improved = 1;
+                }
+            }
+        }
+    }
+
+    return improved;
+}
+
+/**
+* Function improveFleetPlan - Local search over the whole plan until no move shortens it
+*
+* Method - Each pass finds the best inter-route move of every stop in parallel, sorts the improving moves,
+* and applies each one whose two routes have not already been changed in this pass. Every route is then
+* improved with 2-opt in parallel. Passes repeat until neither finds an improvement
+*
+* Copyright Daniel Marcovecchio
+*
+* @author https://github.com/BlackHat0001
+* @param instance (const DeliveryInstance*) - The instance being planned
+* @param neighbours (const int*) - The neighbour lists
+* @param neighbourCount (int) - The number of neighbours per stop
+* @param plan (FleetPlan*) - The plan to improve
+* @return movesApplied (long) - The number of inter-route moves applied
+*/
+long improveFleetPlan(const DeliveryInstance* instance, const int* neighbours, int neighbourCount, FleetPlan* plan) {
+    int n = instance->numberOfStops;
+    FleetMove* moves = (FleetMove*) plannerMalloc(n * sizeof(FleetMove));
+    char* routeChanged = (char*) plannerMalloc(plan->numberOfRoutes);
+    long movesApplied = 0;
+    int pass = 0;
+    int improved = 1;
+
+    while(improved) {
+        improved = 0;
+        pass++;
+
+        // Find the best move of every stop in parallel, the plan is only read here
+        #pragma omp parallel for schedule(dynamic, 32)
+        for(int s = 1; s < n; s++) {
+            moves[s] = findBestFleetMove(instance, plan, neighbours, neighbourCount, s);
+        }
+
+        // Gather the improving moves to the front, best first
+        int numberOfMoves = 0;
+        for(int s = 1; s < n; s++) {
+            if(moves[s].type != FLEET_MOVE_NONE) {
+                moves[numberOfMoves++] = moves[s];
+            }
+        }
+        qsort(moves, numberOfMoves, sizeof(FleetMove), compareFleetMoves);
+
+        // Apply every move whose routes are still as they were when it was evaluated
+        memset(routeChanged, 0, plan->numberOfRoutes);
+        int appliedThisPass = 0;
+        for(int i = 0; i < numberOfMoves; i++) {
+            int routeA = plan->routeOfStop[moves[i].stop];
+            int routeB = plan->routeOfStop[moves[i].other];
+            if(routeChanged[routeA] || routeChanged[routeB]) {
+                continue;
+            }
+            applyFleetMove(instance, plan, &moves[i]);
+            routeChanged[routeA] = 1;
+            routeChanged[routeB] = 1;
+            appliedThisPass++;
+        }
+        movesApplied += appliedThisPass;
+
+        // Straighten out every route, each route is independent so they are improved in parallel
+        int twoOptImproved = 0;
+        #pragma omp parallel for schedule(dynamic) reduction(|:twoOptImproved)
+        for(int r = 0; r < plan->numberOfRoutes; r++) {
+            twoOptImproved |= twoOptRoute(instance, plan, neighbours, neighbourCount, r);
+        }
+
+        improved = appliedThisPass > 0 || twoOptImproved;
+
+        if(ROUTE_TRACE_ENABLED(ROUTE_TRACE_IMPROVEMENTS)) {
+            fprintf(routeTraceFile != NULL ? routeTraceFile : stdout,
+                    "Local search pass %d | Moves applied: %d | Total distance: %f\n",
+                    pass, appliedThisPass, fleetPlanDistance(instance, plan));
+        }
+    }
+
+    plannerFree(moves);
+    plannerFree(routeChanged);
+    return movesApplied;
+}
+
+/**
+* Function eliminateFleetRoutes - Empties the lightest routes while the plan needs more vehicles than the fleet has
+*
+* Method - Every stop of the lightest route is moved to its cheapest position on any other route with the capacity.
+* Stops with nowhere to go are left where they are, and elimination stops there
+*
+* Copyright Daniel Marcovecchio
+*
+* @author https://github.com/BlackHat0001
+* @param instance (const DeliveryInstance*) - The instance being planned
+* @param plan (FleetPlan*) - The plan to reduce
+* @return eliminated (int) - The number of routes emptied
+*/
+int eliminateFleetRoutes(const DeliveryInstance* instance, FleetPlan* plan) {
+    int eliminated = 0;
+
+    while(countUsedRoutes(plan) > instance->fleetSize) {
+        // Find the lightest route that still has stops
+        int lightest = -1;
+        for(int r = 0; r < plan->numberOfRoutes; r++) {
+            if(plan->routeSizes[r] > 0 && (lightest < 0 || plan->routeLoads[r] < plan->routeLoads[lightest])) {
+                lightest = r;
+            }
+        }
+
+        // Move its stops out one by one, always taking the first as the route shrinks
+        while(plan->routeSizes[lightest] > 0) {
+            int s = plan->routes[lightest][0];
+            FleetMove best;
+            best.delta = 1E30f;
+            best.type = FLEET_MOVE_NONE;
+            best.stop = s;
+
+            // Try every position next to every stop on the other routes
+            for(int v = 1; v < instance->numberOfStops; v++) {
+                int route = plan->routeOfStop[v];
+                if(route == lightest || plan->routeLoads[route] + instance->demands[s] > instance->vehicleCapacity) {
+                    continue;
+                }
+                int beforeV = stopBefore(plan, route, plan->positionOfStop[v]);
+                int afterV = stopAfter(plan, route, plan->positionOfStop[v]);
+                float insertBefore = stopDistance(instance, beforeV, s) + stopDistance(instance, s, v)
+                                     - stopDistance(instance, beforeV, v);
+                float insertAfter = stopDistance(instance, v, s) + stopDistance(instance, s, afterV)
+                                    - stopDistance(instance, v, afterV);
+                if(insertBefore < best.delta || insertAfter < best.delta) {
+                    best.delta = insertBefore < insertAfter ? insertBefore : insertAfter;
+                    best.type = FLEET_MOVE_RELOCATE;
+                    best.other = v;
+                    best.insertAfter = insertAfter < insertBefore;
+                }
+            }
+
+            // If no other route can take this stop, the fleet can not be reduced any further
+            if(best.type == FLEET_MOVE_NONE) {
+                return eliminated;
+            }
+            applyFleetMove(instance, plan, &best);
+        }
+        eliminated++;
+    }
+
+    return eliminated;
+}
+
+float solveFleetRoutes(DeliveryInstance* instance, FleetPlan* plan) {
+    // Function to plan the routes of the whole fleet
+
+    memset(plan, 0, sizeof(*plan));
+
+    // Precompute the legs if the instance is small enough, every move is evaluated from these
+    buildDistanceMatrix(instance);
+
+    // Keep at most FLEET_NEIGHBOUR_COUNT neighbours, fewer if there are not that many other stops
+    int neighbourCount = instance->numberOfStops - 2 < FLEET_NEIGHBOUR_COUNT ? instance->numberOfStops - 2 : FLEET_NEIGHBOUR_COUNT;
+    int* neighbours = NULL;
+    if(neighbourCount > 0) {
+        neighbours = buildNeighbourLists(instance, neighbourCount);
+        if(neighbours == NULL) {
+            printf("Error: Out of memory planning the fleet\n");
+            return -1;
+        }
+    }
+
+    // Build the initial routes from the savings, then improve them with local search
+    if(!clarkeWrightSavings(instance, neighbours, neighbourCount, plan)) {
+        printf("Error: Out of memory planning the fleet\n");
+        plannerFree(neighbours);
+        return -1;
+    }
+    if(ROUTE_TRACE_ENABLED(ROUTE_TRACE_IMPROVEMENTS)) {
+        fprintf(routeTraceFile != NULL ? routeTraceFile : stdout,
+                "Savings construction | Routes: %d | Total distance: %f\n",
+                plan->numberOfRoutes, fleetPlanDistance(instance, plan));
+    }
+
+    if(neighbourCount > 0) {
+        improveFleetPlan(instance, neighbours, neighbourCount, plan);
+
+        // The savings method does not limit the number of routes, so empty routes until the fleet can cover the plan
+        // then improve again, as the moved stops were only placed by cheapest insertion
+        if(eliminateFleetRoutes(instance, plan) > 0) {
+            improveFleetPlan(instance, neighbours, neighbourCount, plan);
+        }
+    }
+
+    plannerFree(neighbours);
+    return fleetPlanDistance(instance, plan);
+}
+
+float fleetPlanDistance(const DeliveryInstance* instance, const FleetPlan* plan) {
+    // Function to total the distance of every route, summed in double so the order of the parallel sum barely matters
+
+    double totalDistance = 0;
+    #pragma omp parallel for schedule(static) reduction(+:totalDistance)
+    for(int r = 0; r < plan->numberOfRoutes; r++) {
+        int size = plan->routeSizes[r];
+        if(size == 0) {
+            continue;
+        }
+        // From the depot, along every stop, and back to the depot
+        float routeDistance = stopDistance(instance, 0, plan->routes[r][0]);
+        for(int i = 1; i < size; i++) {
+            routeDistance += stopDistance(instance, plan->routes[r][i-1], plan->routes[r][i]);
+        }
+        routeDistance += stopDistance(instance, plan->routes[r][size-1], 0);
+        totalDistance += routeDistance;
+    }
+    return (float) totalDistance;
+}
+
+int countUsedRoutes(const FleetPlan* plan) {
+    // Function to count the routes that visit at least one stop
+    int usedRoutes = 0;
+    for(int r = 0; r < plan->numberOfRoutes; r++) {
+        if(plan->routeSizes[r] > 0) {
+            usedRoutes++;
+        }
+    }
+    return usedRoutes;
+}
+
+void printFleetPlan(const DeliveryInstance* instance, const FleetPlan* plan) {
+    // Function to log each used route of the plan
+
+    int vehicle = 1;
+    for(int r = 0; r < plan->numberOfRoutes; r++) {
+        int size = plan->routeSizes[r];
+        if(size == 0) {
+            continue;
+        }
+
+        float routeDistance = stopDistance(instance, 0, plan->routes[r][0]) + stopDistance(instance, plan->routes[r][size-1], 0);
+        for(int i = 1; i < size; i++) {
+            routeDistance += stopDistance(instance, plan->routes[r][i-1], plan->routes[r][i]);
+        }
+
+        printf("Vehicle %d | Load: %d/%d | Distance: %f | Route: 0 -> ",
+               vehicle, plan->routeLoads[r], instance->vehicleCapacity, routeDistance);
+        for(int i = 0; i < size; i++) {
+            printf("%d -> ", plan->routes[r][i]);
+        }
+        printf("0\n");
+        vehicle++;
+    }
+}
+
+void freeFleetPlan(FleetPlan* plan) {
+    // Function to free the arrays owned by a plan
+    for(int r = 0; r < plan->numberOfRoutes; r++) {
+        plannerFree(plan->routes[r]);
+    }
+    plannerFree(plan->routes);
+    plannerFree(plan->routeSizes);
+    plannerFree(plan->routeAllocations);
+    plannerFree(plan->routeLoads);
+    plannerFree(plan->routeOfStop);
+    plannerFree(plan->positionOfStop);
+    memset(plan, 0, sizeof(*plan));
+}
+
+
+//------------- Road Network
+
+int loadRoadGraph(const char* path, RoadGraph* graph) {
+    // Function to read a road network from an edge list file
+
+    memset(graph, 0, sizeof(*graph));
+
+    FILE* file = fopen(path, "r");
+    if(file == NULL) {
+        printf("Error: Could not open road network file %s\n", path);
+        return 0;
+    }
+
+    // The roads are read into plain lists first, then sorted by junction into the CSR arrays
+    int allocatedNodes = 0, allocatedRoads = 0, numberOfRoads = 0;
+    int* roadFrom = NULL;
+    int* roadTo = NULL;
+    float* roadCost = NULL;
+    int success = 1;
+    char line[256];
+
+    while(success && fgets(line, sizeof(line), file) != NULL) {
+        // Skip any leading whitespace, then skip comments and blank lines
+        char* first = line;
+        while(*first == ' ' || *first == '\t') {
+            first++;
+        }
+        if(*first == '#' || *first == '\n' || *first == '\r' || *first == '\0') {
+            continue;
+        }
+
+        if(*first == 'v') {
+            // Grow the junction arrays if they are full
+            if(graph->numberOfNodes == allocatedNodes) {
+                allocatedNodes = allocatedNodes > 0 ? allocatedNodes * 2 : 256;
+                graph->nodeX = (float*) plannerRealloc(graph->nodeX, allocatedNodes * sizeof(float));
+                graph->nodeY = (float*) plannerRealloc(graph->nodeY, allocatedNodes * sizeof(float));
+            }
+            if(sscanf(first + 1, "%f %f", &graph->nodeX[graph->numberOfNodes], &graph->nodeY[graph->numberOfNodes]) != 2) {
+                success = 0;
+            }
+            graph->numberOfNodes++;
+
+        } else if(*first == 'e') {
+            // Grow the road lists if they are full
+            if(numberOfRoads == allocatedRoads) {
+                allocatedRoads = allocatedRoads > 0 ? allocatedRoads * 2 : 256;
+                roadFrom = (int*) plannerRealloc(roadFrom, allocatedRoads * sizeof(int));
+                roadTo = (int*) plannerRealloc(roadTo, allocatedRoads * sizeof(int));
+                roadCost = (float*) plannerRealloc(roadCost, allocatedRoads * sizeof(float));
+            }
+            int from, to;
+            float cost;
+            int fields = sscanf(first + 1, "%d %d %f", &from, &to, &cost);
+            // Roads must join junctions which have already been listed, and can not have a negative cost
+            if(fields < 2 || from < 0 || to < 0 || from >= graph->numberOfNodes || to >= graph->numberOfNodes
+               || (fields == 3 && cost < 0)) {
+                success = 0;
+            } else {
+                roadFrom[numberOfRoads] = from;
+                roadTo[numberOfRoads] = to;
+                roadCost[numberOfRoads] = fields == 3 ? cost : distanceAToB(graph->nodeX[from], graph->nodeY[from],
+                                                                            graph->nodeX[to], graph->nodeY[to]);
+                numberOfRoads++;
+            }
+
+        } else {
+            success = 0;
+        }
+
+        if(!success) {
+            printf("Error: Malformed line in road network %s: %s", path, line);
+        }
+    }
+    fclose(file);
+
+    if(success && graph->numberOfNodes == 0) {
+        printf("Error: Road network %s has no junctions\n", path);
+        success = 0;
+    }
+
+    if(success) {
+        // Count the arcs leaving every junction, each road gives one arc from both of its ends
+        graph->numberOfArcs = numberOfRoads * 2;
+        graph->arcStart = (int*) plannerCalloc(graph->numberOfNodes + 1, sizeof(int));
+        graph->arcTarget = (int*) plannerMalloc(graph->numberOfArcs * sizeof(int));
+        graph->arcCost = (float*) plannerMalloc(graph->numberOfArcs * sizeof(float));
+        for(int r = 0; r < numberOfRoads; r++) {
+            graph->arcStart[roadFrom[r] + 1]++;
+            graph->arcStart[roadTo[r] + 1]++;
+        }
+
+        // Turn the counts into starting offsets, then place every arc, moving each junction's next free slot along
+        for(int v = 0; v < graph->numberOfNodes; v++) {
+            graph->arcStart[v+1] += graph->arcStart[v];
+        }
+        int* nextSlot = (int*) plannerMalloc(graph->numberOfNodes * sizeof(int));
+        memcpy(nextSlot, graph->arcStart, graph->numberOfNodes * sizeof(int));
+        for(int r = 0; r < numberOfRoads; r++) {
+            int slot = nextSlot[roadFrom[r]]++;
+            graph->arcTarget[slot] = roadTo[r];
+            graph->arcCost[slot] = roadCost[r];
+            slot = nextSlot[roadTo[r]]++;
+            graph->arcTarget[slot] = roadFrom[r];
+            graph->arcCost[slot] = roadCost[r];
+        }
+        plannerFree(nextSlot);
+    }
+
+    plannerFree(roadFrom);
+    plannerFree(roadTo);
+    plannerFree(roadCost);
+    if(!success) {
+        freeRoadGraph(graph);
+    }
+    return success;
+}
+
+void freeRoadGraph(RoadGraph* graph) {
+    // Function to free the arrays owned by a graph
+    plannerFree(graph->nodeX);
+    plannerFree(graph->nodeY);
+    plannerFree(graph->arcStart);
+    plannerFree(graph->arcTarget);
+    plannerFree(graph->arcCost);
+    memset(graph, 0, sizeof(*graph));
+}
+
+/** Struct RoadHeapEntry
+* An entry in the Dijkstra priority queue, the cost a junction was reached with
+*/
+typedef struct {
+    float cost;
+    int node;
+} RoadHeapEntry;
+
+/**
+* Function roadDijkstra - Finds the road costs from one junction until every junction in targetsAtNode is reached
+*
+* Method - Dijkstra with a binary heap. Rather than decreasing keys, a junction is pushed again whenever a cheaper
+* way to it is found, and stale entries are skipped when popped. The heap can therefore hold up to one entry per arc.
+* Only the junctions touched are reset afterwards, so each search costs the size of the area explored, not the graph
+*
+* Copyright Daniel Marcovecchio
+*
+* @author https://github.com/BlackHat0001
+* @param graph (const RoadGraph*) - The road network
+* @param source (int) - The junction to search from
+* @param targetsAtNode (const int*) - The number of locations joined at each junction
+* @param numberOfTargets (int) - The sum of targetsAtNode, the search stops once this many have been reached
+* @param cost (float*) - Per junction workspace, INFINITY on entry. Holds the costs on return until reset
+* @param touched (int*) - Per junction workspace, returns the junctions whose cost was set
+* @param heap (RoadHeapEntry*) - Workspace with space for numberOfArcs + 1 entries
+* @return numberOfTouched (int) - The number of junctions in touched
+*/
+int roadDijkstra(const RoadGraph* graph, int source, const int* targetsAtNode, int numberOfTargets,
+                 float* cost, int* touched, RoadHeapEntry* heap) {
+    int numberOfTouched = 0;
+    int heapSize = 0;
+    int targetsReached = 0;
+
+    cost[source] = 0;
+    touched[numberOfTouched++] = source;
+    heap[heapSize].cost = 0;
+    heap[heapSize].node = source;
+    heapSize++;
+
+    while(heapSize > 0 && targetsReached < numberOfTargets) {
+        // Pop the cheapest entry, moving the last entry to the root and sifting it down
+        RoadHeapEntry top = heap[0];
+        RoadHeapEntry last = heap[--heapSize];
+        int hole = 0;
+        while(1) {
+            int child = 2*hole + 1;
+            if(child >= heapSize) {
+                break;
+            }
+            if(child + 1 < heapSize && heap[child+1].cost < heap[child].cost) {
+                child++;
+            }
+            if(heap[child].cost >= last.cost) {
+                break;
+            }
+            heap[hole] = heap[child];
+            hole = child;
+        }
+        heap[hole] = last;
+
+        // Skip stale entries, the junction has since been settled with a lower cost
+        if(top.cost > cost[top.node]) {
+            continue;
+        }
+        targetsReached += targetsAtNode[top.node];
+
+        // Relax every arc leaving this junction
+        for(int arc = graph->arcStart[top.node]; arc < graph->arcStart[top.node + 1]; arc++) {
+            int next = graph->arcTarget[arc];
+            float nextCost = top.cost + graph->arcCost[arc];
+            if(nextCost < cost[next]) {
+                if(cost[next] == INFINITY) {
+                    touched[numberOfTouched++] = next;
+                }
+                cost[next] = nextCost;
+
+                // Push the cheaper way to this junction, sifting it up from the bottom of the heap
+                int position = heapSize++;
+                while(position > 0 && heap[(position-1)/2].cost > nextCost) {
+                    heap[position] = heap[(position-1)/2];
+                    position = (position-1)/2;
+                }
+                heap[position].cost = nextCost;
+                heap[position].node = next;
+            }
+        }
+    }
+
+    return numberOfTouched;
+}
+
+float* buildRoadCostMatrix(const RoadGraph* graph, const float* xCoords, const float* yCoords, int numberOfLocations) {
+    // Function to compute the road cost between every pair of locations
+
+    int n = numberOfLocations;
+    int numberOfNodes = graph->numberOfNodes;
+
+    // Join every location to its nearest junction, remembering the straight-line distance it costs to get there
+    int* nodeOfLocation = (int*) plannerMalloc(n * sizeof(int));
+    float* accessCost = (float*) plannerMalloc(n * sizeof(float));
+    int* targetsAtNode = (int*) plannerCalloc(numberOfNodes, sizeof(int));
+    #pragma omp parallel for schedule(static)
+    for(int location = 0; location < n; location++) {
+        // Squared distances are compared, so only the nearest needs a square root
+        int nearest = 0;
+        float nearestSquared = INFINITY;
+        for(int v = 0; v < numberOfNodes; v++) {
+            float dx = graph->nodeX[v] - xCoords[location];
+            float dy = graph->nodeY[v] - yCoords[location];
+            if(dx*dx + dy*dy < nearestSquared) {
+                nearestSquared = dx*dx + dy*dy;
+                nearest = v;
+            }
+        }
+        nodeOfLocation[location] = nearest;
+        accessCost[location] = sqrtf(nearestSquared);
+    }
+    for(int location = 0; location < n; location++) {
+        targetsAtNode[nodeOfLocation[location]]++;
+    }
+
+    // Every thread needs its own search workspace, which is allocated here as plannerMalloc is not thread safe
+    int numberOfThreads = 1;
+#ifdef _OPENMP
+    numberOfThreads = omp_get_max_threads();
+#endif
+    float* costs = (float*) plannerMalloc((size_t) numberOfThreads * numberOfNodes * sizeof(float));
+    int* touched = (int*) plannerMalloc((size_t) numberOfThreads * numberOfNodes * sizeof(int));
+    RoadHeapEntry* heaps = (RoadHeapEntry*) plannerMalloc((size_t) numberOfThreads * (graph->numberOfArcs + 1) * sizeof(RoadHeapEntry));
+    for(size_t i = 0; i < (size_t) numberOfThreads * numberOfNodes; i++) {
+        costs[i] = INFINITY;
+    }
+
+    float* matrix = (float*) plannerMalloc((size_t) n * n * sizeof(float));
+    int unreachable = 0;
+
+    // One search per location, each filling its own row of the matrix
+    #pragma omp parallel for schedule(dynamic) reduction(|:unreachable)
+    for(int a = 0; a < n; a++) {
+        int thread = 0;
+#ifdef _OPENMP
+        thread = omp_get_thread_num();
+#endif
+        float* cost = &costs[(size_t) thread * numberOfNodes];
+        int* threadTouched = &touched[(size_t) thread * numberOfNodes];
+        RoadHeapEntry* heap = &heaps[(size_t) thread * (graph->numberOfArcs + 1)];
+
+        int numberOfTouched = roadDijkstra(graph, nodeOfLocation[a], targetsAtNode, n, cost, threadTouched, heap);
+
+        // The cost of a leg is getting onto the road network, driving, then getting off it again
+        for(int b = 0; b < n; b++) {
+            float roadCost = cost[nodeOfLocation[b]];
+            if(roadCost == INFINITY) {
+                unreachable = 1;
+            }
+            matrix[(size_t) a * n + b] = a == b ? 0 : accessCost[a] + roadCost + accessCost[b];
+        }
+
+        // Reset only the junctions this search reached, ready for the next search on this thread
+        for(int i = 0; i < numberOfTouched; i++) {
+            cost[threadTouched[i]] = INFINITY;
+        }
+    }
+
+    plannerFree(nodeOfLocation);
+    plannerFree(accessCost);
+    plannerFree(targetsAtNode);
+    plannerFree(costs);
+    plannerFree(touched);
+    plannerFree(heaps);
+
+    if(unreachable) {
+        printf("Error: Some delivery locations can not be reached from each other by road\n");
+        plannerFree(matrix);
+        return NULL;
+    }
+    return matrix;
+}
+
+
+//------------- Interval Leg Costs
+
+CostInterval addCostIntervals(CostInterval a, CostInterval b) {
+    // {cmin, cmax} = {amin + bmin, amax + bmax}, as in interval::operator+
+    CostInterval sum = {a.min + b.min, a.max + b.max};
+    return sum;
+}
+
+CostInterval legCostInterval(int pointA, int pointB) {
+    if(legCostIntervalsOfPossibleLocations != NULL) {
+        return legCostIntervalsOfPossibleLocations[pointA * numberOfLegIntervalLocations + pointB];
+    }
+    float distance = legDistance(xCoordOfPossibleLocations, yCoordOfPossibleLocations, pointA, pointB);
+    CostInterval cost = {distance, distance};
+    return cost;
+}
+
+CostInterval* loadLegCostIntervals(const char* path, int numberOfLocations) {
+    // Function to read the leg cost intervals from a file
+
+    FILE* file = fopen(path, "r");
+    if(file == NULL) {
+        printf("Error: Could not open leg interval file %s\n", path);
+        return NULL;
+    }
+
+    // Start with every leg at exactly its distance, which is the road cost if a road network has been loaded
+    CostInterval* intervals = (CostInterval*) plannerMalloc((size_t) numberOfLocations * numberOfLocations * sizeof(CostInterval));
+    for(int a = 0; a < numberOfLocations; a++) {
+        for(int b = 0; b < numberOfLocations; b++) {
+            float distance = legDistance(xCoordOfPossibleLocations, yCoordOfPossibleLocations, a, b);
+            intervals[a * numberOfLocations + b].min = distance;
+            intervals[a * numberOfLocations + b].max = distance;
+        }
+    }
+
+    char line[256];
+    int success = 1;
+    while(success && fgets(line, sizeof(line), file) != NULL) {
+        // Skip any leading whitespace, then skip comments and blank lines
+        char* first = line;
+        while(*first == ' ' || *first == '\t') {
+            first++;
+        }
+        if(*first == '#' || *first == '\n' || *first == '\r' || *first == '\0') {
+            continue;
+        }
+
+        int from, to;
+        float min, max;
+        // Legs must join possible locations, and their cost can not be negative or have a worst below its best
+        if(sscanf(first, "%d %d %f %f", &from, &to, &min, &max) != 4 || from < 0 || to < 0 || from >= numberOfLocations
+           || to >= numberOfLocations || min < 0 || max < min) {
+            printf("Error: Malformed line in leg interval file %s: %s", path, line);
+            success = 0;
+        } else {
+            CostInterval cost = {min, max};
+            intervals[from * numberOfLocations + to] = cost;
+            intervals[to * numberOfLocations + from] = cost;
+        }
+    }
+    fclose(file);
+
+    if(!success) {
+        plannerFree(intervals);
+        return NULL;
+    }
+    return intervals;
+}
+
+CostInterval totalCostIntervalOfRoute(int routeLocations[]) {
+    // Function to sum the cost intervals of every leg of a route, the same way as totalDistanceOfRoute
+
+    if(routeLocations[0] != 0 || routeLocations[routeLength+1] != 0) {
+        printf("Error: Route does not start or finish at depot. Program terminating...\n");
+        exit(-1);
+    }
+
+    CostInterval totalCost = {0, 0};
+    for (int i = 0; i < routeLength+1; i++) {
+        totalCost = addCostIntervals(totalCost, legCostInterval(routeLocations[i], routeLocations[i+1]));
+    }
+    return totalCost;
+}
+
+/**
+* Function highestLocationOfRoute - Returns the highest location ID of a route, to size arrays indexed by location
+*
+* Copyright Daniel Marcovecchio
+*
+* @author https://github.com/BlackHat0001
+* @param route[] (int) - The locations of the route, without the depot
+* @return highestLocation (int) - The highest location ID, 0 if the route is empty
+*/
+int highestLocationOfRoute(int route[]) {
+    int highestLocation = 0;
+    for (int i = 0; i < routeLength; i++) {
+        if(route[i] > highestLocation) {
+            highestLocation = route[i];
+        }
+    }
+    return highestLocation;
+}
+
+/**
+* Function fillArrivalBounds - Works out the cheapest leg arriving at each location of a route, and at the depot
+* The cost of a leg is its worst case if worstCase is 1, else its best case
+*
+* Copyright Daniel Marcovecchio
+*
+* @author https://github.com/BlackHat0001
+* @param route[] (int) - The locations of the route, without the depot
+* @param worstCase (int) - 1 to bound worst case costs, 0 to bound best case costs
+* @param arrivalBound[] (float) - Filled with the cheapest arrival at each location, indexed by location ID
+*/
+void fillArrivalBounds(int route[], int worstCase, float arrivalBound[]) {
+    for (int i = -1; i < routeLength; i++) {
+        int location = i < 0 ? 0 : route[i];
+        float cheapest = 1E14f;
+        // A location can be arrived at from the depot or any other location of the route
+        for (int j = -1; j < routeLength; j++) {
+            if(j == i) {
+                continue;
+            }
+            int from = j < 0 ? 0 : route[j];
+            CostInterval cost = legCostInterval(from, location);
+            float legCost = worstCase ? cost.max : cost.min;
+            if(legCost < cheapest) {
+                cheapest = legCost;
+            }
+        }
+        arrivalBound[location] = cheapest;
+    }
+}
+
+/**
+* Function permutateWorstCaseRoutes - The recursive search of findWorstCaseRoute, in the same form as permutateRoutes
+* Also used by findMinMaxRegretRoute for the best route of a scenario, where the legs of the scenario's route
+* (nextLocation) are at their worst case and every other leg at its best. With no scenario route, every leg is at
+* its worst
+*
+* Copyright Daniel Marcovecchio
+*
+* @author https://github.com/BlackHat0001
+* @param route[] (int) - The current route array, indicative of the branch in the tree
+* @param index (int) - The current index through the route array, indicative of the level in the tree
+* @param prefixCost (float) - The cost of the legs from the depot through route[0] to route[index-1]
+* @param bestCost (float) - The lowest cost found so far
+* @param bestRoute[] (int) - An array to store the lowest cost route found, or NULL to only find its cost
+* @param arrivalBound[] (float) - The cheapest arrival at each location, from fillArrivalBounds
+* @param nextLocation[] (int) - The location after each location on the scenario's route, or NULL for the worst case
+* @return bestCost (float) - The lowest cost found in the whole tree
+*/
+float permutateWorstCaseRoutes(int route[], int index, float prefixCost, float bestCost, int bestRoute[],
+                               const float arrivalBound[], const int nextLocation[]) {
+    routeSearchCounters.nodesExplored++;
+
+    // Bound this branch, the fixed legs plus the cheapest arrival at every location left and back at the depot
+    float lowerBound = prefixCost + arrivalBound[0];
+    for (int k = index; k < routeLength; k++) {
+        lowerBound += arrivalBound[route[k]];
+    }
+    if(lowerBound >= bestCost) {
+        routeSearchCounters.nodesPruned++;
+        return bestCost;
+    }
+
+    int previous = index > 0 ? route[index-1] : 0;
+    for (int k = index; k < routeLength; k++) {
+        swap(route, index, k);
+
+        // The cost of the leg just added, at its worst case unless the scenario has it at its best
+        int location = route[index];
+        CostInterval leg = legCostInterval(previous, location);
+        float legCost = nextLocation == NULL || nextLocation[previous] == location || nextLocation[location] == previous
+                        ? leg.max : leg.min;
+
+        if(index == routeLength - 1) {
+            // The route is complete once it returns to the depot
+            CostInterval back = legCostInterval(location, 0);
+            float backCost = nextLocation == NULL || nextLocation[location] == 0 || nextLocation[0] == location
+                             ? back.max : back.min;
+            float cost = prefixCost + legCost + backCost;
+            routeSearchCounters.routesEvaluated++;
+            if(cost < bestCost) {
+                bestCost = cost;
+                if(bestRoute != NULL) {
+                    for (int i = 0; i < routeLength; i++) {
+                        bestRoute[i] = route[i];
+                    }
+                }
+            }
+        } else {
+            bestCost = permutateWorstCaseRoutes(route, index+1, prefixCost + legCost, bestCost, bestRoute,
+                                                arrivalBound, nextLocation);
+        }
+
+        swap(route, index, k);
+    }
+    return bestCost;
+}
+
+float findWorstCaseRoute(int route[], int bestRoute[]) {
+    // Function to find the min-max route
+
+    float* arrivalBound = (float*) plannerMalloc((highestLocationOfRoute(route) + 1) * sizeof(float));
+    fillArrivalBounds(route, 1, arrivalBound);
+    for (int i = 0; i < routeLength; i++) {
+        bestRoute[i] = route[i];
+    }
+    float worstCase = permutateWorstCaseRoutes(route, 0, 0, 1E14f, bestRoute, arrivalBound, NULL);
+    plannerFree(arrivalBound);
+    return worstCase;
+}
+
+/**
+* Function permutateRegretRoutes - The recursive search of findMinMaxRegretRoute
+*
+* Copyright Daniel Marcovecchio
+*
+* @author https://github.com/BlackHat0001
+* @param route[] (int) - The current route array, indicative of the branch in the tree
+* @param index (int) - The current index through the route array, indicative of the level in the tree
+* @param prefixWorstCase (float) - The worst case cost of the legs from the depot through route[0] to route[index-1]
+* @param bestRegret (float) - The lowest maximum regret found so far
+* @param minMaxWorstCase (float) - The worst case cost of the min-max route
+* @param bestRoute[] (int) - An array to store the min-max regret route found
+* @param worstArrivalBound[], bestArrivalBound[] (float) - The cheapest worst and best case arrivals, from fillArrivalBounds
+* @param scenarioRoute[], nextLocation[] (int) - Working arrays of routeLength and highest location + 1 ints
+* @return bestRegret (float) - The lowest maximum regret found in the whole tree
+*/
+float permutateRegretRoutes(int route[], int index, float prefixWorstCase, float bestRegret, float minMaxWorstCase,
+                            int bestRoute[], const float worstArrivalBound[], const float bestArrivalBound[],
+                            int scenarioRoute[], int nextLocation[]) {
+    routeSearchCounters.nodesExplored++;
+
+    // A route's regret is at least its worst case less the min-max worst case, so bound that from the worst case bound
+    float lowerBound = prefixWorstCase + worstArrivalBound[0];
+    for (int k = index; k < routeLength; k++) {
+        lowerBound += worstArrivalBound[route[k]];
+    }
+    if(lowerBound - minMaxWorstCase >= bestRegret) {
+        routeSearchCounters.nodesPruned++;
+        return bestRegret;
+    }
+
+    if(index == routeLength) {
+        // The route is complete. Find the best route in the scenario where this route's legs are at their worst
+        nextLocation[0] = route[0];
+        for (int i = 0; i < routeLength; i++) {
+            nextLocation[route[i]] = i+1 < routeLength ? route[i+1] : 0;
+            scenarioRoute[i] = route[i];
+        }
+        float worstCase = prefixWorstCase + legCostInterval(route[routeLength-1], 0).max;
+        float bestInScenario = permutateWorstCaseRoutes(scenarioRoute, 0, 0, worstCase, NULL, bestArrivalBound, nextLocation);
+        float regret = worstCase - bestInScenario;
+        if(regret < bestRegret) {
+            bestRegret = regret;
+            for (int i = 0; i < routeLength; i++) {
+                bestRoute[i] = route[i];
+            }
+            if(ROUTE_TRACE_ENABLED(ROUTE_TRACE_IMPROVEMENTS)) {
+                fprintf(routeTraceFile != NULL ? routeTraceFile : stdout, "New lowest maximum regret: %f\n", regret);
+            }
+        }
+        return bestRegret;
+    }
+
+    int previous = index > 0 ? route[index-1] : 0;
+    for (int k = index; k < routeLength; k++) {
+        swap(route, index, k);
+        bestRegret = permutateRegretRoutes(route, index+1, prefixWorstCase + legCostInterval(previous, route[index]).max,
+                                           bestRegret, minMaxWorstCase, bestRoute, worstArrivalBound, bestArrivalBound,
+                                           scenarioRoute, nextLocation);
+        swap(route, index, k);
+    }
+    return bestRegret;
+}
+
+float findMinMaxRegretRoute(int route[], float minMaxWorstCase, int bestRoute[]) {
+    // Function to find the min-max regret route
+
+    int numberOfLocations = highestLocationOfRoute(route) + 1;
+    float* worstArrivalBound = (float*) plannerMalloc(numberOfLocations * sizeof(float));
+    float* bestArrivalBound = (float*) plannerMalloc(numberOfLocations * sizeof(float));
+    int* scenarioRoute = (int*) plannerMalloc(routeLength * sizeof(int));
+    int* nextLocation = (int*) plannerMalloc(numberOfLocations * sizeof(int));
+    fillArrivalBounds(route, 1, worstArrivalBound);
+    fillArrivalBounds(route, 0, bestArrivalBound);
+
+    for (int i = 0; i < routeLength; i++) {
+        bestRoute[i] = route[i];
+    }
+    float maximumRegret = permutateRegretRoutes(route, 0, 0, 1E14f, minMaxWorstCase, bestRoute, worstArrivalBound,
+                                                bestArrivalBound, scenarioRoute, nextLocation);
+
+    plannerFree(worstArrivalBound);
+    plannerFree(bestArrivalBound);
+    plannerFree(scenarioRoute);
+    plannerFree(nextLocation);
+    return maximumRegret;
+}
+
+
+//------------- Incremental Route Updates
+
+/**
+* Function plannedLeg - Returns the distance of a leg between two location IDs, 0 being the depot
+*
+* Copyright Daniel Marcovecchio
+*
+* @author https://github.com/BlackHat0001
+* @param pointA, pointB (int) - The location IDs the leg joins
+* @return distance (float) - The legDistance between them
+*/
+float plannedLeg(int pointA, int pointB) {
+    return legDistance(xCoordOfPossibleLocations, yCoordOfPossibleLocations, pointA, pointB);
+}
+
+/**
+* Function plannedStopAt - Returns the location at a position of a route, or the depot before and after its stops
+*
+* Copyright Daniel Marcovecchio
+*
+* @author https://github.com/BlackHat0001
+* @param route[] (int) - The route, without the depot
+* @param numberOfStops (int) - The number of stops on the route
+* @param position (int) - The position, -1 and numberOfStops being the depot
+* @return location (int) - The location ID at the position
+*/
+int plannedStopAt(const int route[], int numberOfStops, int position) {
+    return position < 0 || position >= numberOfStops ? 0 : route[position];
+}
+
+/**
+* Function plannedRouteDistance - Returns the total distance of a route from the depot and back
+*
+* Copyright Daniel Marcovecchio
+*
+* @author https://github.com/BlackHat0001
+* @param route[] (int) - The route, without the depot
+* @param numberOfStops (int) - The number of stops on the route
+* @return distance (float) - The total distance
+*/
+float plannedRouteDistance(const int route[], int numberOfStops) {
+    float distance = 0;
+    for (int i = 0; i <= numberOfStops; i++) {
+        distance += plannedLeg(plannedStopAt(route, numberOfStops, i-1), plannedStopAt(route, numberOfStops, i));
+    }
+    return distance;
+}
+
+/**
+* Function plannedRouteLowerBound - Returns a lower bound on the distance of any route through the given stops
+* Every location, the depot included, is left and arrived at by one leg each, so half its two shortest legs to any
+* other location is the least it can add. For a single stop both legs are the same one, out and back
+*
+* Copyright Daniel Marcovecchio
+*
+* @author https://github.com/BlackHat0001
+* @param route[] (int) - The stops, in any order, without the depot
+* @param numberOfStops (int) - The number of stops
+* @return lowerBound (float) - The lower bound
+*/
+float plannedRouteLowerBound(const int route[], int numberOfStops) {
+    if(numberOfStops < 2) {
+        return plannedRouteDistance(route, numberOfStops);
+    }
+
+    float lowerBound = 0;
+    for (int i = -1; i < numberOfStops; i++) {
+        int location = plannedStopAt(route, numberOfStops, i);
+        float shortest = 1E14f, secondShortest = 1E14f;
+        for (int j = -1; j < numberOfStops; j++) {
+            if(j == i) {
+                continue;
+            }
+            float distance = plannedLeg(location, plannedStopAt(route, numberOfStops, j));
+            if(distance < shortest) {
+                secondShortest = shortest;
+                shortest = distance;
+            } else if(distance < secondShortest) {
+                secondShortest = distance;
+            }
+        }
+        lowerBound += (shortest + secondShortest) / 2;
+    }
+    return lowerBound;
+}
+
+/**
+* Function checkPlannedRoute - Measures the quality of a planned route, its distance over the lower bound of its stops
+* The distance is summed again, dropping the rounding the updates' changes have built up, and the lower bound found
+*
+* Copyright Daniel Marcovecchio
+*
+* @author https://github.com/BlackHat0001
+* @param plannedRoute (PlannedRoute*) - The planned route, its distance and lower bound updated and its check reset
+* @return ratio (float) - The distance over the lower bound, 1 if the bound is 0
+*/
+float checkPlannedRoute(PlannedRoute* plannedRoute) {
+    plannedRoute->distance = plannedRouteDistance(plannedRoute->stops, plannedRoute->numberOfStops);
+    plannedRoute->lowerBound = plannedRouteLowerBound(plannedRoute->stops, plannedRoute->numberOfStops);
+    plannedRoute->updatesSinceCheck = 0;
+    plannedRoute->changeSinceCheck = 0;
+    return plannedRoute->lowerBound > 0 ? plannedRoute->distance / plannedRoute->lowerBound : 1;
+}
+
+/**
+* Function improveRouteWindow - Improves a route with 2-opt and Or-opt moves that only touch positions first to last
+* Moves are taken as soon as they are found to shorten the route, until none in the window does
+*
+* Copyright Daniel Marcovecchio
+*
+* @author https://github.com/BlackHat0001
+* @param route[] (int) - The route to improve, without the depot
+* @param numberOfStops (int) - The number of stops on the route
+* @param first, last (int) - The first and last positions moves may change
+* @return change (float) - The change in distance of the moves taken, zero or less
+*/
+float improveRouteWindow(int route[], int numberOfStops, int first, int last) {
+    float totalChange = 0;
+    int improved = 1;
+    while(improved) {
+        improved = 0;
+
+        // 2-opt, reversing route[i] to route[j] if joining its ends the other way round is shorter
+        for (int i = first; i < last; i++) {
+            for (int j = i+1; j <= last; j++) {
+                int before = plannedStopAt(route, numberOfStops, i-1);
+                int after = plannedStopAt(route, numberOfStops, j+1);
+                float change = plannedLeg(before, route[j]) + plannedLeg(route[i], after)
+                               - plannedLeg(before, route[i]) - plannedLeg(route[j], after);
+                if(change < -1E-4f) {
+                    for (int a = i, b = j; a < b; a++, b--) {
+                        swap(route, a, b);
+                    }
+                    totalChange += change;
+                    improved = 1;
+                }
+            }
+        }
+
+        // Or-opt, moving a run of up to INCREMENTAL_MAX_SEGMENT stops between two others, either way round
+        for (int segmentLength = 1; segmentLength <= INCREMENTAL_MAX_SEGMENT; segmentLength++) {
+            for (int i = first; i + segmentLength - 1 <= last; i++) {
+                int segmentEnd = i + segmentLength - 1;
+                int before = plannedStopAt(route, numberOfStops, i-1);
+                int after = plannedStopAt(route, numberOfStops, segmentEnd+1);
+                float removalGain = plannedLeg(before, route[i]) + plannedLeg(route[segmentEnd], after)
+                                    - plannedLeg(before, after);
+
+                // Insert in front of position j, away from where the run already is
+                for (int j = first; j <= last+1; j++) {
+                    if(j >= i && j <= segmentEnd+1) {
+                        continue;
+                    }
+                    int previous = plannedStopAt(route, numberOfStops, j-1);
+                    int next = plannedStopAt(route, numberOfStops, j);
+                    float forwardCost = plannedLeg(previous, route[i]) + plannedLeg(route[segmentEnd], next);
+                    float reversedCost = plannedLeg(previous, route[segmentEnd]) + plannedLeg(route[i], next);
+                    int reversed = reversedCost < forwardCost;
+                    float change = (reversed ? reversedCost : forwardCost) - plannedLeg(previous, next) - removalGain;
+                    if(change >= -1E-4f) {
+                        continue;
+                    }
+
+                    int segment[INCREMENTAL_MAX_SEGMENT];
+                    for (int k = 0; k < segmentLength; k++) {
+                        segment[k] = route[reversed ? segmentEnd - k : i + k];
+                    }
+                    // Shift the stops between the run and its new place over the gap it leaves
+                    int destination;
+                    if(j < i) {
+                        memmove(&route[j + segmentLength], &route[j], (i - j) * sizeof(int));
+                        destination = j;
+                    } else {
+                        memmove(&route[i], &route[segmentEnd + 1], (j - segmentEnd - 1) * sizeof(int));
+                        destination = j - segmentLength;
+                    }
+                    for (int k = 0; k < segmentLength; k++) {
+                        route[destination + k] = segment[k];
+                    }
+                    totalChange += change;
+                    improved = 1;
+                    break;
+                }
+            }
+        }
+    }
+    return totalChange;
+}
+
+/**
+* Function solvePlannedRoute - Solves a planned route again in full and makes it the new reference quality
+* Routes of up to INCREMENTAL_MAX_EXACT_STOPS are solved exactly by permutateRoutes. Longer ones are not solved
+* again, they only get a 2-opt and Or-opt local search over the whole route, so they keep whatever local optimum
+* that reaches as the reference
+*
+* Copyright Daniel Marcovecchio
+*
+* Dependencies: stdlib.h
+*
+* @author https://github.com/BlackHat0001
+* @param plannedRoute (PlannedRoute*) - The planned route to solve
+*/
+void solvePlannedRoute(PlannedRoute* plannedRoute) {
+    int numberOfStops = plannedRoute->numberOfStops;
+    if(numberOfStops > INCREMENTAL_MAX_EXACT_STOPS) {
+        improveRouteWindow(plannedRoute->stops, numberOfStops, 0, numberOfStops-1);
+    } else if(numberOfStops > 0) {
+        // permutateRoutes searches routeLength stops, so search this route's and then put it back
+        int savedRouteLength = routeLength;
+        int* shortestRoute = (int*) plannerMalloc(numberOfStops * sizeof(int));
+        routeLength = numberOfStops;
+        permutateRoutes(plannedRoute->stops, 0, 1E14f, shortestRoute);
+        routeLength = savedRouteLength;
+        memcpy(plannedRoute->stops, shortestRoute, numberOfStops * sizeof(int));
+        plannerFree(shortestRoute);
+    }
+    plannedRoute->referenceRatio = checkPlannedRoute(plannedRoute);
+}
+
+/**
+* Function repairPlannedRoute - Improves a planned route around a change, then solves it in full if its quality has
+* fallen more than maxDegradation below the reference. The quality is only checked every INCREMENTAL_CHECK_INTERVAL
+* updates, or once the changes since the last check add up to more than maxDegradation of the lower bound
+*
+* Copyright Daniel Marcovecchio
+*
+* @author https://github.com/BlackHat0001
+* @param plannedRoute (PlannedRoute*) - The planned route that has changed
+* @param position (int) - The position of the change
+* @param change (float) - The change in distance the change made, before the repair
+* @param maxDegradation (float) - The relative loss in quality allowed before a full solve
+* @return distance (float) - The total distance of the updated route
+*/
+float repairPlannedRoute(PlannedRoute* plannedRoute, int position, float change, float maxDegradation) {
+    int numberOfStops = plannedRoute->numberOfStops;
+    int first = position - INCREMENTAL_WINDOW < 0 ? 0 : position - INCREMENTAL_WINDOW;
+    int last = position + INCREMENTAL_WINDOW >= numberOfStops ? numberOfStops-1 : position + INCREMENTAL_WINDOW;
+    float improvement = improveRouteWindow(plannedRoute->stops, numberOfStops, first, last);
+    plannedRoute->distance += change + improvement;
+    plannedRoute->updatesSinceCheck++;
+    plannedRoute->changeSinceCheck += fabsf(change) + fabsf(improvement);
+
+    if(plannedRoute->updatesSinceCheck < INCREMENTAL_CHECK_INTERVAL
+       && plannedRoute->changeSinceCheck <= maxDegradation * plannedRoute->lowerBound) {
+        return plannedRoute->distance;
+    }
+    float ratio = checkPlannedRoute(plannedRoute);
+    if(ratio > plannedRoute->referenceRatio * (1 + maxDegradation)) {
+        if(ROUTE_TRACE_ENABLED(ROUTE_TRACE_IMPROVEMENTS)) {
+            fprintf(routeTraceFile != NULL ? routeTraceFile : stdout,
+                    "Planned route is %f over its lower bound, against %f when solved. Solving in full\n",
+                    ratio, plannedRoute->referenceRatio);
+        }
+        solvePlannedRoute(plannedRoute);
+        plannedRoute->fullSolves++;
+    }
+    return plannedRoute->distance;
+}
+
+void initialisePlannedRoute(PlannedRoute* plannedRoute, int route[], int numberOfStops) {
+    // Function to start a planned route from an optimised route
+
+    plannedRoute->capacity = numberOfStops > 4 ? numberOfStops : 4;
+    plannedRoute->stops = (int*) plannerMalloc(plannedRoute->capacity * sizeof(int));
+    memcpy(plannedRoute->stops, route, numberOfStops * sizeof(int));
+    plannedRoute->numberOfStops = numberOfStops;
+    plannedRoute->referenceRatio = checkPlannedRoute(plannedRoute);
+    plannedRoute->fullSolves = 0;
+}
+
+void freePlannedRoute(PlannedRoute* plannedRoute) {
+    plannerFree(plannedRoute->stops);
+    plannedRoute->stops = NULL;
+    plannedRoute->numberOfStops = 0;
+    plannedRoute->capacity = 0;
+}
+
+float addStopToPlannedRoute(PlannedRoute* plannedRoute, int stop, float maxDegradation) {
+    // Function to add a delivery to a planned route
+
+    int numberOfStops = plannedRoute->numberOfStops;
+    for (int i = 0; i < numberOfStops; i++) {
+        if(plannedRoute->stops[i] == stop) {
+            return -1;
+        }
+    }
+
+    // Find the cheapest place to insert the stop, in front of position i
+    int cheapestPosition = 0;
+    float cheapestCost = 1E14f;
+    for (int i = 0; i <= numberOfStops; i++) {
+        int previous = plannedStopAt(plannedRoute->stops, numberOfStops, i-1);
+        int next = plannedStopAt(plannedRoute->stops, numberOfStops, i);
+        float cost = plannedLeg(previous, stop) + plannedLeg(stop, next) - plannedLeg(previous, next);
+        if(cost < cheapestCost) {
+            cheapestCost = cost;
+            cheapestPosition = i;
+        }
+    }
+
+    if(numberOfStops == plannedRoute->capacity) {
+        plannedRoute->capacity *= 2;
+        plannedRoute->stops = (int*) plannerRealloc(plannedRoute->stops, plannedRoute->capacity * sizeof(int));
+    }
+    memmove(&plannedRoute->stops[cheapestPosition + 1], &plannedRoute->stops[cheapestPosition],
+            (numberOfStops - cheapestPosition) * sizeof(int));
+    plannedRoute->stops[cheapestPosition] = stop;
+    plannedRoute->numberOfStops++;
+
+    return repairPlannedRoute(plannedRoute, cheapestPosition, cheapestCost, maxDegradation);
+}
+
+float removeStopFromPlannedRoute(PlannedRoute* plannedRoute, int stop, float maxDegradation) {
+    // Function to cancel a delivery of a planned route
+
+    int numberOfStops = plannedRoute->numberOfStops;
+    int position = -1;
+    for (int i = 0; i < numberOfStops; i++) {
+        if(plannedRoute->stops[i] == stop) {
+            position = i;
+            break;
+        }
+    }
+    if(position < 0) {
+        return -1;
+    }
+
+    int previous = plannedStopAt(plannedRoute->stops, numberOfStops, position-1);
+    int next = plannedStopAt(plannedRoute->stops, numberOfStops, position+1);
+    float change = plannedLeg(previous, next) - plannedLeg(previous, stop) - plannedLeg(stop, next);
+    memmove(&plannedRoute->stops[position], &plannedRoute->stops[position + 1],
+            (numberOfStops - position - 1) * sizeof(int));
+    plannedRoute->numberOfStops--;
+
+    return repairPlannedRoute(plannedRoute, position, change, maxDegradation);
+}
+
+int runRouteChanges(const char* changes, int route[], int numberOfStops, int numberOfLocations) {
+    // Function to apply added and cancelled deliveries to the shortest route found
+
+    PlannedRoute plannedRoute;
+    initialisePlannedRoute(&plannedRoute, route, numberOfStops);
+    int exitCode = 0;
+
+    const char* change = changes;
+    while(*change != '\0') {
+        char* end;
+        char sign = *change;
+        long stop = strtol(change + 1, &end, 10);
+        if((sign != '+' && sign != '-') || end == change + 1 || (*end != ',' && *end != '\0')) {
+            printf("Error: Change \"%s\" is not +ID or -ID\n", change);
+            exitCode = -1;
+            break;
+        }
+        if(stop < 1 || stop >= numberOfLocations) {
+            printf("Error: Change %c%ld is not a location ID between 1 and %d\n", sign, stop, numberOfLocations-1);
+            exitCode = -1;
+            break;
+        }
+
+        double beginTime = wallClockSeconds();
+        float distance = sign == '+' ? addStopToPlannedRoute(&plannedRoute, (int) stop, INCREMENTAL_DEFAULT_DEGRADATION)
+                                     : removeStopFromPlannedRoute(&plannedRoute, (int) stop, INCREMENTAL_DEFAULT_DEGRADATION);
+        double updateTime = wallClockSeconds() - beginTime;
+        if(distance < 0) {
+            printf("Error: Location %ld is %s the route\n", stop, sign == '+' ? "already on" : "not on");
+            exitCode = -1;
+            break;
+        }
+
+        // Solve the same stops from scratch, to compare
+        int savedRouteLength = routeLength;
+        int scratchRoute[plannedRoute.numberOfStops + 1];
+        int scratchShortest[plannedRoute.numberOfStops + 1];
+        memcpy(scratchRoute, plannedRoute.stops, plannedRoute.numberOfStops * sizeof(int));
+        routeLength = plannedRoute.numberOfStops;
+        beginTime = wallClockSeconds();
+        float scratchDistance = routeLength > 0 ? permutateRoutes(scratchRoute, 0, 1E14f, scratchShortest) : 0;
+        double scratchTime = wallClockSeconds() - beginTime;
+        routeLength = savedRouteLength;
+
+        printf("\n%s location %ld\nRoute: ", sign == '+' ? "Added" : "Cancelled", stop);
+        for (int i = 0; i < plannedRoute.numberOfStops; i++) {
+            printf("%d%s", plannedRoute.stops[i], i < plannedRoute.numberOfStops-1 ? " -> " : "");
+        }
+        printf("\nDistance: %f in %.1f microseconds | From scratch: %f in %.1f microseconds\n",
+               distance, updateTime * 1E6, scratchDistance, scratchTime * 1E6);
+
+        change = *end == ',' ? end + 1 : end;
+    }
+
+    printf("\nChanges that fell back to a full solve: %d\n", plannedRoute.fullSolves);
+    freePlannedRoute(&plannedRoute);
+    return exitCode;
+}
+
+//------------- Annealing
+
+/** Struct AnnealingIsland
+* The search state of one island. Tours are cycles through every location, the depot anywhere in them, so a 2-opt
+* move can reverse whichever side of the cycle is shorter
+*
+* @property tour (int*) - The current tour
+* @property positionOf (int*) - The position of every location in the current tour
+* @property bestTour (int*) - The shortest tour the island has found or taken up
+* @property distance, bestDistance (double) - The distances of the current and best tours
+* @property randomState (unsigned long long) - The state of the island's random number generator
+*/
+typedef struct {
+    int* tour;
+    int* positionOf;
+    int* bestTour;
+    double distance;
+    double bestDistance;
+    unsigned long long randomState;
+} AnnealingIsland;
+
+/**
+* Function annealingRandom - Returns the next number of an island's splitmix64 generator, as benchmarkRandomUniform
+* but with the state passed in, so every thread draws from its own generator
+*
+* Copyright Daniel Marcovecchio
+*
+* @author https://github.com/BlackHat0001
+* @param state (unsigned long long*) - The state of the generator
+* @return random (unsigned long long) - The next 64 random bits
+*/
+unsigned long long annealingRandom(unsigned long long* state) {
+    unsigned long long z = (*state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+/**
+* Function annealingTourDistance - Returns the distance of a whole tour, summed in double
+*
+* Copyright Daniel Marcovecchio
+*
+* @author https://github.com/BlackHat0001
+* @param instance (const DeliveryInstance*) - The instance the tour is through
+* @param tour[] (const int) - The cycle through every location
+* @return distance (double) - The distance of the tour
+*/
+double annealingTourDistance(const DeliveryInstance* instance, const int tour[]) {
+    int n = instance->numberOfStops;
+    double distance = 0;
+    for(int i = 0; i < n; i++) {
+        distance += stopDistance(instance, tour[i], tour[(i+1) % n]);
+    }
+    return distance;
+}
+
+/**
+* Function buildAnnealingStart - Builds the starting tour of an island by nearest neighbour from a random location
+*
+* Copyright Daniel Marcovecchio
+*
+* @author https://github.com/BlackHat0001
+* @param instance (const DeliveryInstance*) - The instance to build a tour through
+* @param island (AnnealingIsland*) - The island to start, its tour, positions and distances are set
+* @param visited[] (char) - A working array of numberOfStops chars
+*/
+void buildAnnealingStart(const DeliveryInstance* instance, AnnealingIsland* island, char visited[]) {
+    int n = instance->numberOfStops;
+    memset(visited, 0, n);
+
+    int current = (int)(annealingRandom(&island->randomState) % n);
+    for(int i = 0; i < n; i++) {
+        island->tour[i] = current;
+        island->positionOf[current] = i;
+        visited[current] = 1;
+
+        int nearest = -1;
+        float nearestDistance = 1E30f;
+        for(int s = 0; s < n; s++) {
+            if(visited[s]) {
+                continue;
+            }
+            float distance = stopDistance(instance, current, s);
+            if(distance < nearestDistance) {
+                nearestDistance = distance;
+                nearest = s;
+            }
+        }
+        current = nearest;
+    }
+
+    island->distance = annealingTourDistance(instance, island->tour);
+    island->bestDistance = island->distance;
+    memcpy(island->bestTour, island->tour, n * sizeof(int));
+}
+
+/**
+* Function reverseAnnealingSegment - Reverses the tour from position first to position last, wrapping round the cycle
+*
+* Copyright Daniel Marcovecchio
+*
+* @author https://github.com/BlackHat0001
+* @param island (AnnealingIsland*) - The island whose tour to change
+* @param n (int) - The number of locations in the tour
+* @param first, last (int) - The first and last positions of the segment
+*/
+void reverseAnnealingSegment(AnnealingIsland* island, int n, int first, int last) {
+    int length = (last - first + n) % n + 1;
+    for(int k = 0; k < length / 2; k++) {
+        int a = (first + k) % n;
+        int b = (last - k + n) % n;
+        int location = island->tour[a];
+        island->tour[a] = island->tour[b];
+        island->tour[b] = location;
+        island->positionOf[island->tour[a]] = a;
+        island->positionOf[island->tour[b]] = b;
+    }
+}
 
 /**
-* Function totalDistanceOfRoute - Returns the total distance of a given route
+* Function annealingMove - Tries one random move on an island, keeping it if the annealing rule accepts it
 *
-* Method - Iterates for each journey in the route, from location to location, and sums each distance
+* A 2-opt move joins stop a to c, one of its nearest neighbours (or, one time in eight, any location, so legs to the
+* depot can change too), by reversing the tour between them. A relocation moves stop a to beside c.
+* Moves shortening the tour are always kept, and those lengthening it by delta with probability exp(-delta/T)
 *
 * Copyright Daniel Marcovecchio
 *
-* Dependencies: stdio.h, stdlib.h
-*
 * @author https://github.com/BlackHat0001
-*
-* @param xCoordLocations[] (float) - The x coordinate array of all possible delivery locations
-* @param yCoordLocations[] (float) - The y coordinate array of all possible delivery locations
-* @param routeLocations[] (int) - The route in which to find the distance for, starting and ending at the depot (0,0)
-*
-* @return totalDistance (float) - The total distance for this route
+* @param instance (const DeliveryInstance*) - The instance the tour is through
+* @param island (AnnealingIsland*) - The island to move
+* @param neighbours (const int*) - The nearest neighbours of every stop, from buildNeighbourLists
+* @param neighbourCount (int) - The number of neighbours per stop
+* @param temperature (double) - The current temperature T
 */
-float totalDistanceOfRoute(float xCoordLocations[], float yCoordLocations[], int routeLocations[]);
+void annealingMove(const DeliveryInstance* instance, AnnealingIsland* island, const int* neighbours, int neighbourCount,
+                   double temperature) {
+    int n = instance->numberOfStops;
+    int* tour = island->tour;
+    unsigned long long random = annealingRandom(&island->randomState);
+
+    // One draw picks the stops and the kind of move, each from its own bits so no choice depends on another. Bit 0
+    // picks the kind of move, bit 1 the side of a relocation, bits 2 to 4 the long move, bits 8 to 31 the neighbour
+    // or the location of a long move, and the top 32 bits stop a. A second draw is only made for the acceptance test
+    int a = 1 + (int)(((random >> 32) * (unsigned long long)(n - 1)) >> 32);
+    int i = island->positionOf[a];
+    unsigned long long target = (random >> 8) & 0xFFFFFF;
+    int c = neighbours[(size_t) a * neighbourCount + target % neighbourCount];
+    if(((random >> 2) & 7) == 0) {
+        c = (int)((target * (unsigned long long) n) >> 24);
+    }
+    int j = island->positionOf[c];
+    int relocate = random & 1;
+
+    float delta;
+    int relocateAfter = 0;
+    if(relocate) {
+        // Move a to between c and the location after it, or the one before it
+        relocateAfter = (random >> 1) & 1 ? j : (j - 1 + n) % n;
+        if(c == a || relocateAfter == i || relocateAfter == (i - 1 + n) % n) {
+            return;
+        }
+        int before = tour[(i - 1 + n) % n], after = tour[(i + 1) % n];
+        int u = tour[relocateAfter], v = tour[(relocateAfter + 1) % n];
+        delta = stopDistance(instance, before, after) - stopDistance(instance, before, a) - stopDistance(instance, a, after)
+                + stopDistance(instance, u, a) + stopDistance(instance, a, v) - stopDistance(instance, u, v);
+    } else {
+        // Join a to c and their successors to each other, by reversing from a's successor to c
+        int gap = (j - i + n) % n;
+        if(gap < 2 || gap == n - 1) {
+            return;
+        }
+        int aNext = tour[(i + 1) % n], cNext = tour[(j + 1) % n];
+        delta = stopDistance(instance, a, c) + stopDistance(instance, aNext, cNext)
+                - stopDistance(instance, a, aNext) - stopDistance(instance, c, cNext);
+    }
+
+    if(delta > 0 && (double)(annealingRandom(&island->randomState) >> 11) / 9007199254740992.0
+                    >= exp(-delta / temperature)) {
+        return;
+    }
+
+    if(relocate) {
+        // Shift the locations between a and its new place one step over the gap, whichever way round is shorter
+        int forward = (relocateAfter - i + n) % n;
+        if(forward <= n / 2) {
+            for(int k = 0; k < forward; k++) {
+                int from = (i + k + 1) % n, to = (i + k) % n;
+                tour[to] = tour[from];
+                island->positionOf[tour[to]] = to;
+            }
+            tour[relocateAfter] = a;
+            island->positionOf[a] = relocateAfter;
+        } else {
+            int destination = (relocateAfter + 1) % n;
+            for(int k = 0; k < n - forward - 1; k++) {
+                int from = (i - k - 1 + n) % n, to = (i - k + n) % n;
+                tour[to] = tour[from];
+                island->positionOf[tour[to]] = to;
+            }
+            tour[destination] = a;
+            island->positionOf[a] = destination;
+        }
+    } else {
+        // Reversing either side of the cycle gives the same tour, so reverse the shorter
+        int gap = (j - i + n) % n;
+        if(gap <= n / 2) {
+            reverseAnnealingSegment(island, n, (i + 1) % n, j);
+        } else {
+            reverseAnnealingSegment(island, n, (j + 1) % n, i);
+        }
+    }
+
+    island->distance += delta;
+    if(island->distance < island->bestDistance - FLEET_IMPROVEMENT_EPSILON) {
+        island->bestDistance = island->distance;
+        memcpy(island->bestTour, tour, n * sizeof(int));
+    }
+}
+
+float solveAnnealingTour(DeliveryInstance* instance, double seconds, unsigned long long seed, int bestTour[]) {
+    // Function to find a short tour by simulated annealing on parallel islands
+
+    int n = instance->numberOfStops;
+    // With two deliveries or fewer every tour is the same length
+    if(n <= 3) {
+        for(int s = 1; s < n; s++) {
+            bestTour[s-1] = s;
+        }
+        int tour[3] = {0, 1, 2};
+        return n > 1 ? (float) annealingTourDistance(instance, tour) : 0;
+    }
+
+    buildDistanceMatrix(instance);
+    int neighbourCount = n - 2 < ANNEALING_NEIGHBOUR_COUNT ? n - 2 : ANNEALING_NEIGHBOUR_COUNT;
+    int* neighbours = buildNeighbourLists(instance, neighbourCount);
+
+    int numberOfIslands = 1;
+#ifdef _OPENMP
+    numberOfIslands = omp_get_max_threads();
+#endif
+
+    // Everything is allocated up front, as the planner allocator is not thread safe
+    AnnealingIsland* islands = (AnnealingIsland*) plannerCalloc(numberOfIslands, sizeof(AnnealingIsland));
+    int* tours = (int*) plannerMalloc((size_t) numberOfIslands * 4 * n * sizeof(int));
+    char* visited = (char*) plannerMalloc((size_t) numberOfIslands * n);
+    double* migrantDistances = (double*) plannerMalloc(numberOfIslands * sizeof(double));
+    if(neighbours == NULL || islands == NULL || tours == NULL || visited == NULL || migrantDistances == NULL) {
+        printf("Error: Out of memory planning the tour\n");
+        plannerFree(neighbours);
+        plannerFree(islands);
+        plannerFree(tours);
+        plannerFree(visited);
+        plannerFree(migrantDistances);
+        return -1;
+    }
+    for(int k = 0; k < numberOfIslands; k++) {
+        islands[k].tour = &tours[(size_t) (4*k) * n];
+        islands[k].positionOf = &tours[(size_t) (4*k + 1) * n];
+        islands[k].bestTour = &tours[(size_t) (4*k + 2) * n];
+        islands[k].bestDistance = 1E30;
+        islands[k].randomState = seed + 0x632BE59BD9B4E019ULL * (k + 1);
+    }
+
+    double beginTime = wallClockSeconds();
+
+    #pragma omp parallel num_threads(numberOfIslands)
+    {
+        int k = 0, islandsRunning = 1;
+#ifdef _OPENMP
+        k = omp_get_thread_num();
+        islandsRunning = omp_get_num_threads();
+#endif
+        AnnealingIsland* island = &islands[k];
+        int* migrantTour = &tours[(size_t) (4*k + 3) * n];
+        buildAnnealingStart(instance, island, &visited[(size_t) k * n]);
+
+        double startTemperature = ANNEALING_START_TEMPERATURE * island->distance / n;
+        double endTemperature = ANNEALING_END_TEMPERATURE * island->distance / n;
+        double temperature = startTemperature;
+
+        for(int migration = 1; migration <= ANNEALING_MIGRATIONS; migration++) {
+            double migrationTime = beginTime + seconds * migration / ANNEALING_MIGRATIONS;
+            for(long moves = 0; ; moves++) {
+                // Only look at the clock every so often, as a move costs far less than reading it
+                if((moves & 255) == 0) {
+                    double now = wallClockSeconds();
+                    if(now >= migrationTime) {
+                        break;
+                    }
+                    temperature = startTemperature * pow(endTemperature / startTemperature, (now - beginTime) / seconds);
+                }
+                annealingMove(instance, island, neighbours, neighbourCount, temperature);
+            }
+
+            // Correct the rounding the move deltas have added up
+            island->distance = annealingTourDistance(instance, island->tour);
+
+            // Pass the best tour to the next island round the ring, which takes it up if it beats its own best
+            memcpy(migrantTour, island->bestTour, n * sizeof(int));
+            migrantDistances[k] = island->bestDistance;
+            #pragma omp barrier
+            int from = (k - 1 + islandsRunning) % islandsRunning;
+            if(migrantDistances[from] < island->bestDistance - FLEET_IMPROVEMENT_EPSILON) {
+                const int* incoming = &tours[(size_t) (4*from + 3) * n];
+                memcpy(island->tour, incoming, n * sizeof(int));
+                memcpy(island->bestTour, incoming, n * sizeof(int));
+                for(int p = 0; p < n; p++) {
+                    island->positionOf[island->tour[p]] = p;
+                }
+                island->distance = island->bestDistance = migrantDistances[from];
+            }
+            #pragma omp barrier
+        }
+    }
+
+    // Take the best island, and turn its cycle into a tour starting after the depot
+    int best = 0;
+    for(int k = 1; k < numberOfIslands; k++) {
+        if(islands[k].bestDistance < islands[best].bestDistance) {
+            best = k;
+        }
+    }
+    int depotPosition = 0;
+    while(islands[best].bestTour[depotPosition] != 0) {
+        depotPosition++;
+    }
+    for(int s = 1; s < n; s++) {
+        bestTour[s-1] = islands[best].bestTour[(depotPosition + s) % n];
+    }
+    float distance = (float) annealingTourDistance(instance, islands[best].bestTour);
+
+    if(ROUTE_TRACE_ENABLED(ROUTE_TRACE_SUMMARY)) {
+        fprintf(routeTraceFile != NULL ? routeTraceFile : stdout,
+                "Annealing | Islands: %d | Best island: %d | Distance: %f\n", numberOfIslands, best, distance);
+    }
+
+    plannerFree(neighbours);
+    plannerFree(islands);
+    plannerFree(tours);
+    plannerFree(visited);
+    plannerFree(migrantDistances);
+    return distance;
+}
 
+//------------- Benchmark
 
+// The state of the benchmark random number generator
+unsigned long long benchmarkRandomState = 0;
 
 /**
-* Function permutateRoutes - A recursive function that finds all permutations of an array of locations, and returns the shortest distance and route
-*
-* Based on the Permutation method - https://www.geeksforgeeks.org/print-all-possible-permutations-of-an-array-vector-without-duplicates-using-backtracking
+* Function benchmarkRandomUniform - Returns a uniform random number in [0, 1) using the splitmix64 generator
 *
 * Copyright Daniel Marcovecchio
 *
-* Dependencies: stdio.h, stdlib.h
-*
 * @author https://github.com/BlackHat0001
-*
-* @param route[] (int) - The current route array, indicative of the branch in the tree
-* @param index (int) - The current index through the route array, indicative of the level in the tree
-* @param shortestDistance (float) - The shortest distance found at this branch in the tree
-* @param shortestRoute[] (float) - A pointer to store the shortest route found
-*
-* @return shortestDistance (float) - The shortest distance found in the whole tree. This is the shortest possible distance
-*
-* @warning If a value quite small is passed for shortestDistance, then the comparison may fail to produce the shortest distance. Recommend 1E14f
+* @return random (double) - The next random number
 */
-float permutateRoutes(int route[], int index, float shortestDistance, int* shortestRoute[]);
+double benchmarkRandomUniform() {
+    unsigned long long z = (benchmarkRandomState += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    z = z ^ (z >> 31);
+    // Keep the top 53 bits, which fill the mantissa of a double exactly
+    return (double)(z >> 11) / 9007199254740992.0;
+}
 
+void generateDeliveryInstance(DeliveryInstance* instance, int numberOfDeliveries, int clustered, unsigned long long seed) {
+    // Function to generate a reproducible instance
 
+    benchmarkRandomState = seed;
 
-//------------- Helper Functions
+    int n = numberOfDeliveries + 1;
+    instance->numberOfStops = n;
+    instance->xCoords = (float*) plannerMalloc(n * sizeof(float));
+    instance->yCoords = (float*) plannerMalloc(n * sizeof(float));
+    instance->demands = (int*) plannerMalloc(n * sizeof(int));
+    instance->distanceMatrix = NULL;
+
+    // The depot is in the centre of the area with nothing to deliver
+    instance->xCoords[0] = BENCHMARK_AREA_SIZE / 2;
+    instance->yCoords[0] = BENCHMARK_AREA_SIZE / 2;
+    instance->demands[0] = 0;
+
+    // Clustered instances have a centre for roughly every 50 locations
+    int numberOfClusters = numberOfDeliveries / 50 + 1;
+    float clusterSpread = BENCHMARK_AREA_SIZE / 30;
+    float clusterX[numberOfClusters];
+    float clusterY[numberOfClusters];
+    for(int c = 0; c < numberOfClusters; c++) {
+        clusterX[c] = (float)(benchmarkRandomUniform() * BENCHMARK_AREA_SIZE);
+        clusterY[c] = (float)(benchmarkRandomUniform() * BENCHMARK_AREA_SIZE);
+    }
+
+    int totalDemand = 0;
+    for(int s = 1; s < n; s++) {
+        if(clustered) {
+            // Pick a cluster, and offset from its centre by a normal distribution using the Box-Muller transform
+            int c = (int)(benchmarkRandomUniform() * numberOfClusters);
+            double radius = sqrt(-2.0 * log(1.0 - benchmarkRandomUniform())) * clusterSpread;
+            double angle = 2.0 * 3.14159265358979323846 * benchmarkRandomUniform();
+            instance->xCoords[s] = clusterX[c] + (float)(radius * cos(angle));
+            instance->yCoords[s] = clusterY[c] + (float)(radius * sin(angle));
+        } else {
+            instance->xCoords[s] = (float)(benchmarkRandomUniform() * BENCHMARK_AREA_SIZE);
+            instance->yCoords[s] = (float)(benchmarkRandomUniform() * BENCHMARK_AREA_SIZE);
+        }
+        instance->demands[s] = 1 + (int)(benchmarkRandomUniform() * BENCHMARK_MAX_DEMAND);
+        totalDemand += instance->demands[s];
+    }
+
+    // Give the fleet a quarter more vehicles than the demand strictly needs, so most instances are feasible
+    instance->vehicleCapacity = BENCHMARK_VEHICLE_CAPACITY;
+    instance->fleetSize = (totalDemand * 5 / 4) / BENCHMARK_VEHICLE_CAPACITY + 1;
+}
 
 /**
-* Function addOrigin - Adds the depot origin to the beginning and end of an array
-* E.g. [1, 2, 3] -> [0, 1, 2, 3, 0]
+* Function solveExactRoute - Runs the exact permutation search over every delivery location of an instance
 *
 * Copyright Daniel Marcovecchio
 *
 * @author https://github.com/BlackHat0001
-* @param route[] (int) - The input array
-* @param routeSize (int) - The size of the input array
-* @return routeWithOrigin (int*) - Pointer to the new array
+* @param instance (const DeliveryInstance*) - The instance to solve, as a single tour from the depot
+* @return shortestDistance (float) - The distance of the optimal tour
 */
-int* addOrigin(int route[],
-               int routeSize) {
-    // Dynamically allocate memory for a new array, 2 bigger than the input array
-    // Stores this in the routeWithOrigin pointer
-    int* routeWithOrigin = (int*) malloc((routeSize+2) * sizeof(int));
-    // Set the first element of this new array to zero (the origin for the depot)
-    routeWithOrigin[0] = 0;
-    // Now we loop for over the input array and append the contents to the new array
-    for (int i = 0; i < routeSize; i++) {
-        routeWithOrigin[i+1] = route[i];
+float solveExactRoute(const DeliveryInstance* instance) {
+    // Point the search at this instance's locations, then restore the defaults once done
+    xCoordOfPossibleLocations = instance->xCoords;
+    yCoordOfPossibleLocations = instance->yCoords;
+    routeLength = instance->numberOfStops - 1;
+
+    int route[routeLength];
+    int shortestRoute[routeLength];
+    for(int i = 0; i < routeLength; i++) {
+        route[i] = i+1;
     }
-    // Finally set the last element to zero. This being the destination of the depot
-    routeWithOrigin[routeSize+1] = 0;
 
-    // Return the pointer to the routeWithOrigin array
-    return routeWithOrigin;
+    resetRouteSearchCounters();
+    float shortestDistance = permutateRoutes(route, 0, 1E14f, shortestRoute);
+
+    xCoordOfPossibleLocations = defaultXCoordOfLocations;
+    yCoordOfPossibleLocations = defaultYCoordOfLocations;
+    return shortestDistance;
 }
 
 /**
-* Function swap - Swaps the ith and jth elements of an array
-* E.g. [1, 2, 3] -> [1, 3, 2] where i=1, j=2
+* Function writeBenchmarkRow - Writes one CSV row of the benchmark, and a short progress line to stdout
 *
 * Copyright Daniel Marcovecchio
 *
 * @author https://github.com/BlackHat0001
-* @param array[] (int) - The input array
-* @param i (int) - The ith element to swap
-* @param j (int) - The jth element to swap
-* @return routeWithOrigin (int*) - The swapped array
 */
-void swap(int array[], int i, int j) {
-    // Store the element at the ith position, swap, and replace at the new jth position
-    int temp = array[i];
-    array[i] = array[j];
-    array[j] = temp;
-}
+void writeBenchmarkRow(FILE* csv, const char* distribution, int deliveries, unsigned long long seed, const char* solver,
+                       float distance, int vehicles, double seconds, size_t peakBytes, float exactDistance) {
+    int threads = 1;
+#ifdef _OPENMP
+    threads = omp_get_max_threads();
+#endif
+    fprintf(csv, "%s,%d,%llu,%s,%d,%f,%d,%f,%zu,", distribution, deliveries, seed, solver, threads,
+            distance, vehicles, seconds, peakBytes);
+    // The gap is left empty when there is no exact distance to compare with
+    if(exactDistance > 0) {
+        fprintf(csv, "%f\n", (distance - exactDistance) / exactDistance * 100);
+    } else {
+        fprintf(csv, "\n");
+    }
+    fflush(csv);
 
-//-------------
+    if(csv != stdout) {
+        printf("%-9s | %5d deliveries | %-13s | Distance: %12.3f | Vehicles: %4d | Time: %9.4f s | Peak memory: %10zu bytes\n",
+               distribution, deliveries, solver, distance, vehicles, seconds, peakBytes);
+    }
+}
 
+int runPlannerBenchmark(const char* csvPath, int maxDeliveries, double annealingSeconds) {
+    // Function to time every solver on generated instances
 
+    FILE* csv = strcmp(csvPath, "-") == 0 ? stdout : fopen(csvPath, "w");
+    if(csv == NULL) {
+        printf("Error: Could not open benchmark file %s\n", csvPath);
+        return -1;
+    }
+    fprintf(csv, "distribution,deliveries,seed,solver,threads,distance,vehicles,seconds,peakBytes,gapToExactPercent\n");
 
-float distanceAToB(float pointAXCoord, float pointAYCoord, float pointBXCoord, float pointBYCoord) {
-    // Function to compute and return the distance between 2D points A and B
+    // Keep the trace quiet, the solvers would otherwise report their counters between rows
+    int savedTraceLevel = routeTraceLevel;
+    routeTraceLevel = ROUTE_TRACE_SILENT;
 
-    // Computes the difference of the X coordinates, and Y coordinates, squares and sum them, then square roots them
-    // Follows this formula D = sqrt((bX-aX)^2 + (bY-aY)^2)
-    return sqrt(pow((pointBXCoord - pointAXCoord), 2) + pow((pointBYCoord - pointAYCoord), 2));
-}
+    for(int size = 0; size < BENCHMARK_NUMBER_OF_SIZES && benchmarkSizes[size] <= maxDeliveries; size++) {
+        for(int clustered = 0; clustered <= 1; clustered++) {
+            int deliveries = benchmarkSizes[size];
+            const char* distribution = clustered ? "clustered" : "uniform";
+            // Each instance has its own fixed seed, so any one row can be reproduced on its own
+            unsigned long long seed = 1000003ULL * deliveries + clustered;
 
+            DeliveryInstance instance;
+            generateDeliveryInstance(&instance, deliveries, clustered, seed);
 
+            // The exact search, only where it finishes in reasonable time. It allocates nothing on the heap
+            float exactDistance = -1;
+            if(deliveries <= BENCHMARK_MAX_EXACT_STOPS) {
+                double beginTime = wallClockSeconds();
+                exactDistance = solveExactRoute(&instance);
+                writeBenchmarkRow(csv, distribution, deliveries, seed, "exact", exactDistance, 1,
+                                  wallClockSeconds() - beginTime, 0, exactDistance);
+            }
 
-float totalDistanceOfRoute(float xCoordLocations[], float yCoordLocations[], int routeLocations[]) {
-    // Function to compute the total distance of a route
+            // The savings planner twice, first as one vehicle carrying everything (a single tour comparable with the
+            // exact search), then with the real capacity limits. Each builds its own distance matrix, counted in its time
+            for(int capacityLimited = 0; capacityLimited <= 1; capacityLimited++) {
+                DeliveryInstance solverInstance = instance;
+                if(!capacityLimited) {
+                    solverInstance.vehicleCapacity = deliveries * BENCHMARK_MAX_DEMAND;
+                    solverInstance.fleetSize = 1;
+                }
 
-    // First we check to see the route does start and end at the origin (0, 0) ID: 0
-    if(routeLocations[0] != 0 || routeLocations[routeLength+1] != 0) {
-        // If it does not, terminate the program as we do not want to continue computation
-        printf("Error: Route does not start or finish at depot. Program terminating...\n");
-        exit(-1);
-    }
+                // Measure the peak from what is already held, so only this solve's memory is counted
+                size_t baselineBytes = plannerBytesInUse;
+                plannerPeakBytes = baselineBytes;
 
-    // Define the total distance var to be used in summing all distances in the loop
-    float totalDistance = 0;
+                double beginTime = wallClockSeconds();
+                FleetPlan plan;
+                float distance = solveFleetRoutes(&solverInstance, &plan);
+                double solveTime = wallClockSeconds() - beginTime;
 
-    // Define the route length including the start and end point
-    int routeLengthIncOrigin = routeLength + 2;
+                writeBenchmarkRow(csv, distribution, deliveries, seed, capacityLimited ? "savings-cvrp" : "savings-tour",
+                                  distance, countUsedRoutes(&plan), solveTime, plannerPeakBytes - baselineBytes,
+                                  capacityLimited ? -1 : exactDistance);
 
-    // Loop for locations in this route
-    for (int i = 0; i < routeLengthIncOrigin-1; i++) {
+                freeFleetPlan(&plan);
+                plannerFree(solverInstance.distanceMatrix);
+            }
 
-        // Retrieve the current location and the next location, by indexing the now at i, and one aheaad at i+1
-        // This becomes the pointA and pointB for this location
-        int pointA = routeLocations[i];
-        int pointB = routeLocations[i+1];
+            // The annealing search, for the whole of its time budget on every thread
+            if(deliveries <= BENCHMARK_MAX_ANNEALING_STOPS) {
+                DeliveryInstance solverInstance = instance;
+                size_t baselineBytes = plannerBytesInUse;
+                plannerPeakBytes = baselineBytes;
+                int* tour = (int*) plannerMalloc(deliveries * sizeof(int));
 
-        // Compute the distance between points A and B, and sum this to the total distance of the route
-        totalDistance += distanceAToB(
-                xCoordLocations[pointA], yCoordLocations[pointA],
-                xCoordLocations[pointB], yCoordLocations[pointB]
-        );
-    }
+                double beginTime = wallClockSeconds();
+                float distance = solveAnnealingTour(&solverInstance, annealingSeconds, seed, tour);
+                double solveTime = wallClockSeconds() - beginTime;
 
-    // There is no requirement to check if the route has returned to the depot as we have already confirmed that the route contains this
+                writeBenchmarkRow(csv, distribution, deliveries, seed, "annealing-tour", distance, 1, solveTime,
+                                  plannerPeakBytes - baselineBytes, exactDistance);
 
-    return totalDistance;
-}
+                plannerFree(tour);
+                plannerFree(solverInstance.distanceMatrix);
+            }
 
+            freeDeliveryInstance(&instance);
+        }
+    }
 
+    routeTraceLevel = savedTraceLevel;
+    if(csv != stdout) {
+        fclose(csv);
+    }
+    return 0;
+}
 
-float permutateRoutes(int route[], int index, float shortestDistance, int* shortestRoute[]) {
-    // Function to recursivley generate all permutations of the selected locations
-    // and finds the shortest possible route of these permutations
 
-    // If the current index of the search for this permutation has reached the end of the array,
-    // then this permutation is complete. This is then where the distance for this route is calculated
-    if (index == routeLength - 1) {
+/**
+* Function loadRoadCosts - Loads a road network file and computes the road costs between a set of locations
+*
+* Copyright Daniel Marcovecchio
+*
+* Dependencies: stdio.h
+*
+* @author https://github.com/BlackHat0001
+*
+* @param roadGraphPath (const char*) - The road network edge list, see loadRoadGraph for the format
+* @param xCoords, yCoords (const float*) - The coordinates of the locations
+* @param numberOfLocations (int) - The number of locations
+*
+* @return matrix (float*) - The cost matrix from buildRoadCostMatrix, or NULL if it could not be built
+*/
+float* loadRoadCosts(const char* roadGraphPath, const float* xCoords, const float* yCoords, int numberOfLocations) {
+    RoadGraph graph;
+    if(!loadRoadGraph(roadGraphPath, &graph)) {
+        return NULL;
+    }
 
-        printf("Tested Route: ");
+    double beginTime = wallClockSeconds();
+    float* matrix = buildRoadCostMatrix(&graph, xCoords, yCoords, numberOfLocations);
+    printf("-> Road costs between %d locations over %d junctions and %d roads computed in %3.4f seconds\n",
+           numberOfLocations, graph.numberOfNodes, graph.numberOfArcs / 2, wallClockSeconds() - beginTime);
 
-        // Add the depot origin and destination to this permutation
-        // E.g. [1, 2, 3] -> [0, 1, 2, 3, 0]
-        int* routeWithOrigin = addOrigin(route, routeLength);
+    freeRoadGraph(&graph);
+    return matrix;
+}
 
-        // Loop over the current permutation for logging perposes
-        for(int i=0; i<routeLength+2; i++) {
-            printf("%d ", routeWithOrigin[i]);
-        }
 
-        // Calculate the distance of this permutation (route) using totalDistanceOfRoute
-        // Passing in the predefined list of possible locations
-        float distance = totalDistanceOfRoute(xCoordOfPossibleLocations, yCoordOfPossibleLocations, routeWithOrigin);
-        printf("| Calculated Distance: %f\n", distance);
+/**
+* Function runFleetPlanner - Plans and logs the routes of a whole fleet for an instance file
+*
+* Copyright Daniel Marcovecchio
+*
+* Dependencies: stdio.h, stdlib.h
+*
+* @author https://github.com/BlackHat0001
+*
+* @param instancePath (const char*) - The fleet instance file, see loadDeliveryInstance for the format
+* @param traceFilePath (const char*) - The file to write the trace to, or NULL for stdout
+* @param roadGraphPath (const char*) - The road network to plan over, or NULL to use straight-line distances
+*
+* @return exitCode (int) - 0 if a plan was found within the fleet size, else -1
+*/
+int runFleetPlanner(const char* instancePath, const char* traceFilePath, const char* roadGraphPath) {
+    DeliveryInstance instance;
+    if(!loadDeliveryInstance(instancePath, &instance)) {
+        return -1;
+    }
 
-        // If this distance is less than the shortest found elsewhere in the tree,
-        // known via the shortestDistance parameter, then a new shortest route has been found
-        if(distance < shortestDistance) {
-            // Copy this permutation (route) to the shortestRoute pointer
-            for (int i = 0; i < routeLength; i++) {
-                shortestRoute[i] = route[i];
-            }
-            // Return this distance up the tree to be used as the new shortestDistance
-            return distance;
+    // Road costs take the place of the straight-line distance matrix the planner would otherwise build
+    if(roadGraphPath != NULL) {
+        instance.distanceMatrix = loadRoadCosts(roadGraphPath, instance.xCoords, instance.yCoords, instance.numberOfStops);
+        if(instance.distanceMatrix == NULL) {
+            freeDeliveryInstance(&instance);
+            return -1;
         }
+    }
 
-    // Else, this permutation is not at the end yet, so continue searching
-    } else {
+    printf("-> Planning %d delivery locations for %d vehicles of capacity %d\n",
+           instance.numberOfStops - 1, instance.fleetSize, instance.vehicleCapacity);
 
-        // Loop over the rest of this permutation from the current index
-        for (int k = index; k < routeLength; k++) {
+    if(!openRouteTrace(traceFilePath, 1 << 16)) {
+        freeDeliveryInstance(&instance);
+        return -1;
+    }
 
-            // Swap the current index and the next element
-            // [1, 2, 3] -> [1, 3, 2] where index=1, k=2
-            swap(route, index, k);
+    // Time the whole solve, including building the distance matrix and neighbour lists
+    double beginTime = wallClockSeconds();
+    FleetPlan plan;
+    float totalDistance = solveFleetRoutes(&instance, &plan);
+    double solveTime = wallClockSeconds() - beginTime;
+    closeRouteTrace();
 
-            // The function calls itself to permutate the rest of this permutation
-            // Searches the next "branch of the tree"
-            // The shortestDistance is updated to what this function returns
-            // It will be the same if no new shortest is found, else will update if the next shortest is found
-            shortestDistance = permutateRoutes(route, index+1, shortestDistance, shortestRoute);
+    if(totalDistance < 0) {
+        freeDeliveryInstance(&instance);
+        return -1;
+    }
 
-            // Un-swap the current index and the next element
-            swap(route, index, k);
+    printFleetPlan(&instance, &plan);
+    int vehiclesUsed = countUsedRoutes(&plan);
+    printf("\nFleet plan found!\nTotal distance: %f\nVehicles used: %d/%d\nComputation time=%3.4f seconds\n",
+           totalDistance, vehiclesUsed, instance.fleetSize, solveTime);
 
-        }
+    // Warn if even after eliminating routes the fleet is not big enough for the plan
+    int exitCode = 0;
+    if(vehiclesUsed > instance.fleetSize) {
+        printf("Warning: The plan needs %d vehicles but the fleet only has %d\n", vehiclesUsed, instance.fleetSize);
+        exitCode = -1;
     }
 
-    // Return the current shortestDistance up the tree, if no new shortest was found
-    return shortestDistance;
+    freeFleetPlan(&plan);
+    freeDeliveryInstance(&instance);
+    return exitCode;
 }
 
 
 /**
 * Function main - The main body for the program. Handles user input
 *
+* Options:
+*   --trace <level>      Trace verbosity. 0 silent, 1 summary counters (default), 2 improvements, 3 every tested route
+*   --trace-file <path>  Write the trace to a buffered file instead of stdout
+*   --cvrp <path>        Plan a capacitated fleet for the instance file, instead of the single route user input
+*   --roads <path>       Plan using shortest road costs over a road network edge list instead of straight lines
+*   --leg-intervals <path> Find the min-max and min-max regret routes over the leg cost intervals in the file
+*   --changes <list>     Add (+ID) and cancel (-ID) deliveries of the shortest route found, e.g. "+6,-2"
+*   --benchmark <csv>    Time every solver on generated instances and write the results to a CSV file ("-" for stdout)
+*   --benchmark-max <n>  The largest instance the benchmark generates, default 10000 delivery locations
+*   --anneal-seconds <s> The time budget of each annealing search in the benchmark, default 1 second
+*
 * Copyright Daniel Marcovecchio
 *
 * Dependencies: stdio.h, stdlib.h for user input
 *
 * @author https://github.com/BlackHat0001
 */
-int main()
+int main(int argc, char* argv[])
 {
+    // Path of the trace file, if one has been selected
+    const char* traceFilePath = NULL;
+    // Path of the fleet instance, if the fleet planner has been selected
+    const char* fleetInstancePath = NULL;
+    // Path of the benchmark CSV, if the benchmark has been selected, and the largest instance it runs
+    const char* benchmarkPath = NULL;
+    int benchmarkMaxDeliveries = 10000;
+    double annealingSeconds = 1.0;
+    // Path of the road network, if road costs have been selected
+    const char* roadGraphPath = NULL;
+    // Path of the leg cost intervals, if the robust route searches have been selected
+    const char* legIntervalsPath = NULL;
+    // Deliveries added to and cancelled from the shortest route after it is found, if any
+    const char* routeChanges = NULL;
+
+    // Read the trace options from the command line
+    for(int i = 1; i < argc; i++) {
+        if(strcmp(argv[i], "--trace") == 0 && i+1 < argc) {
+            routeTraceLevel = atoi(argv[++i]);
+        } else if(strcmp(argv[i], "--trace-file") == 0 && i+1 < argc) {
+            traceFilePath = argv[++i];
+        } else if(strcmp(argv[i], "--cvrp") == 0 && i+1 < argc) {
+            fleetInstancePath = argv[++i];
+        } else if(strcmp(argv[i], "--roads") == 0 && i+1 < argc) {
+            roadGraphPath = argv[++i];
+        } else if(strcmp(argv[i], "--leg-intervals") == 0 && i+1 < argc) {
+            legIntervalsPath = argv[++i];
+        } else if(strcmp(argv[i], "--changes") == 0 && i+1 < argc) {
+            routeChanges = argv[++i];
+        } else if(strcmp(argv[i], "--benchmark") == 0 && i+1 < argc) {
+            benchmarkPath = argv[++i];
+        } else if(strcmp(argv[i], "--benchmark-max") == 0 && i+1 < argc) {
+            benchmarkMaxDeliveries = atoi(argv[++i]);
+        } else if(strcmp(argv[i], "--anneal-seconds") == 0 && i+1 < argc) {
+            annealingSeconds = atof(argv[++i]);
+        } else {
+            printf("Unknown option %s\n", argv[i]);
+            printf("Usage: %s [--trace <0-3>] [--trace-file <path>] [--cvrp <instance>] [--roads <network>]"
+                   " [--leg-intervals <intervals>] [--changes <list>] [--benchmark <csv> [--benchmark-max <n>] [--anneal-seconds <s>]]\n", argv[0]);
+            return -1;
+        }
+    }
+
+    // The benchmark and fleet planner need none of the user input below
+    if(benchmarkPath != NULL) {
+        return runPlannerBenchmark(benchmarkPath, benchmarkMaxDeliveries, annealingSeconds);
+    }
+    if(fleetInstancePath != NULL) {
+        return runFleetPlanner(fleetInstancePath, traceFilePath, roadGraphPath);
+    }
+
+
     // Print the header of the log
     printf("--------- Route Planning Project ---------\n");
     printf("--- \n");
@@ -327,8 +3998,32 @@ int main()
     }
     printf("and will terminate at depot (0, 0)\n");
 
+    // Compute the road costs between all of the possible locations, if a road network was given
+    if(roadGraphPath != NULL) {
+        numberOfRoadCostLocations = sizeof(defaultXCoordOfLocations) / sizeof(defaultXCoordOfLocations[0]);
+        roadCostOfPossibleLocations = loadRoadCosts(roadGraphPath, xCoordOfPossibleLocations, yCoordOfPossibleLocations,
+                                                    numberOfRoadCostLocations);
+        if(roadCostOfPossibleLocations == NULL) {
+            return -1;
+        }
+    }
+
+    // Read the leg cost intervals, if given. Legs the file does not list cost exactly their distance
+    if(legIntervalsPath != NULL) {
+        numberOfLegIntervalLocations = sizeof(defaultXCoordOfLocations) / sizeof(defaultXCoordOfLocations[0]);
+        legCostIntervalsOfPossibleLocations = loadLegCostIntervals(legIntervalsPath, numberOfLegIntervalLocations);
+        if(legCostIntervalsOfPossibleLocations == NULL) {
+            return -1;
+        }
+    }
+
     printf("-> Beginning permutation algorithm\n");
 
+    // Open the trace stream with a 64KB buffer, so a full route trace is written in blocks
+    if(!openRouteTrace(traceFilePath, 1 << 16)) {
+        return -1;
+    }
+
     // Initialize the shorest permutation array, which will be passed as a pointer into the permutation algorithm
     // to store the shortest possible route
     int shortestPermArray[routeLength];
@@ -336,7 +4031,12 @@ int main()
     // Compute the shortest possible route out of the given input locations
     // Note we are passing a large number for the shortestDistance parameter like 1E14f,
     // in order to ensure the comparison does not fail
-    float shortestPerm = permutateRoutes(locationArray, 0, 1E14f, &shortestPermArray);
+    resetRouteSearchCounters();
+    float shortestPerm = permutateRoutes(locationArray, 0, 1E14f, shortestPermArray);
+
+    // Report the search counters once at the end, then flush and close the trace
+    reportRouteSearchCounters();
+    closeRouteTrace();
 
     printf("\nShortest Route found!\nDistance: %f\nRoute: ", shortestPerm);
 
@@ -349,6 +4049,53 @@ int main()
     }
     printf("\nBeginning and terminating at depot (0, 0), location ID: 0\n");
 
+    // With uncertain leg costs, give the range the shortest route may cost, then find the routes that are best in the
+    // worst case and that can fall least short of the best route for the traffic on the day
+    if(legCostIntervalsOfPossibleLocations != NULL) {
+        int routeWithOrigin[routeLength+2];
+        copyRouteWithOrigin(shortestPermArray, routeLength, routeWithOrigin);
+        CostInterval shortestCost = totalCostIntervalOfRoute(routeWithOrigin);
+        printf("Cost of the shortest route with uncertain legs: %f to %f\n", shortestCost.min, shortestCost.max);
+
+        int worstCaseArray[routeLength];
+        int regretArray[routeLength];
+        printf("-> Beginning worst case search\n");
+        resetRouteSearchCounters();
+        float worstCase = findWorstCaseRoute(locationArray, worstCaseArray);
+        reportRouteSearchCounters();
+        printf("-> Beginning maximum regret search\n");
+        resetRouteSearchCounters();
+        float maximumRegret = findMinMaxRegretRoute(locationArray, worstCase, regretArray);
+        reportRouteSearchCounters();
+
+        printf("\nLowest worst case route: ");
+        for(int i=0; i < routeLength; i++) {
+            printf("%d%s", worstCaseArray[i], i < routeLength-1 ? " -> " : "");
+        }
+        copyRouteWithOrigin(worstCaseArray, routeLength, routeWithOrigin);
+        CostInterval worstCaseCost = totalCostIntervalOfRoute(routeWithOrigin);
+        printf("\nCost: %f to %f\n", worstCaseCost.min, worstCaseCost.max);
+
+        printf("\nMost robust (min-max regret) route: ");
+        for(int i=0; i < routeLength; i++) {
+            printf("%d%s", regretArray[i], i < routeLength-1 ? " -> " : "");
+        }
+        copyRouteWithOrigin(regretArray, routeLength, routeWithOrigin);
+        CostInterval regretCost = totalCostIntervalOfRoute(routeWithOrigin);
+        printf("\nCost: %f to %f | Costs at most %f more than the best route for any traffic\n",
+               regretCost.min, regretCost.max, maximumRegret);
+    }
+
+    // Update the shortest route for deliveries added and cancelled during the day, without searching from scratch
+    int exitCode = 0;
+    if(routeChanges != NULL) {
+        exitCode = runRouteChanges(routeChanges, shortestPermArray, routeLength,
+                                   sizeof(defaultXCoordOfLocations) / sizeof(defaultXCoordOfLocations[0]));
+    }
+
+    plannerFree(roadCostOfPossibleLocations);
+    plannerFree(legCostIntervalsOfPossibleLocations);
+
     // We're done! :D
-    return 0;
+    return exitCode;
 }
@@ -3,7 +3,8 @@
 //
 // Copyright Daniel Marcovecchio
 //
-// Dependencies: iostream - For logging/printing purposes using std::cout, interval.h for declaration of interfaces
+// Dependencies: iostream - For logging/printing purposes using std::cout, interval.h for declaration of interfaces,
+// intervalProfile.h when built with INTERVAL_PROFILE
 //----------
 
 #include "interval.h"
@@ -33,7 +34,7 @@ interval::interval(float _min, float _max) : min(_min), max(_max) {}
  *
  * @param x The interval to copy values from.
  */
-interval::interval(interval &x) : min(x.min), max(x.max) {}
+interval::interval(const interval &x) : min(x.min), max(x.max) {}
 
 /** Destructor
  * Destructs the interval object.
@@ -47,8 +48,9 @@ interval::~interval() {}
  * @return The interval after assignment.
  */
 interval interval::operator=(const interval &_b) {
-    this->max = _b.min;
+    this->max = _b.max;
     this->min = _b.min;
+    return *this;
 }
 
 /** Addition Operator Overload
@@ -59,7 +61,9 @@ interval interval::operator=(const interval &_b) {
  */
 interval &interval::operator+(interval &_b) const {
     //{cmin, cmax}={amin+ bmin, amax+ bmax}
-    return *(new interval(min + _b.min, max + _b.max));
+    interval *result = new interval(min + _b.min, max + _b.max);
+    INTERVAL_PROFILE_RECORD(intervalOperationAdd, max - min, _b.max - _b.min, result->max - result->min);
+    return *result;
 }
 
 /** Addition Assignment Operator Overload
@@ -69,6 +73,7 @@ interval &interval::operator+(interval &_b) const {
  * @return A reference to this interval after addition.
  */
 interval &interval::operator+=(interval &_b) {
+    INTERVAL_PROFILE_RECORD(intervalOperationAddAssign, max - min, _b.max - _b.min, (max + _b.max) - (min + _b.min));
     min += _b.min;
     max += _b.max;
     return *this;
@@ -81,7 +86,9 @@ interval &interval::operator+=(interval &_b) {
  * @return The resulting interval.
  */
 interval &interval::operator+(float &_b) const {
-    return *(new interval(min + _b, max + _b));
+    interval *result = new interval(min + _b, max + _b);
+    INTERVAL_PROFILE_RECORD(intervalOperationAddFloat, max - min, 0.f, result->max - result->min);
+    return *result;
 }
 
 /** Addition Operator Overload
@@ -103,7 +110,9 @@ interval &operator+(float &_a, interval &_b) {
  */
 interval &interval::operator-(interval &_b) const {
     //{cmin, cmax}={amin- bmax, amax+ bmin}
-    return *(new interval(min - _b.max, max + _b.min));
+    interval *result = new interval(min - _b.max, max + _b.min);
+    INTERVAL_PROFILE_RECORD(intervalOperationSubtract, max - min, _b.max - _b.min, result->max - result->min);
+    return *result;
 }
 
 /** Subtraction Assignment Operator Overload
@@ -113,6 +122,7 @@ interval &interval::operator-(interval &_b) const {
  * @return A reference to this interval after subtraction.
  */
 interval &interval::operator-=(interval &_b) {
+    INTERVAL_PROFILE_RECORD(intervalOperationSubtractAssign, max - min, _b.max - _b.min, (max + _b.min) - (min - _b.max));
     min -= _b.max;
     max += _b.min;
     return *this;
@@ -125,7 +135,9 @@ interval &interval::operator-=(interval &_b) {
  * @return The resulting interval.
  */
 interval &interval::operator-(float &_b) const {
-    return *(new interval(min - _b, max + _b));
+    interval *result = new interval(min - _b, max + _b);
+    INTERVAL_PROFILE_RECORD(intervalOperationSubtractFloat, max - min, 0.f, result->max - result->min);
+    return *result;
 }
 
 /** Subtraction Operator Overload
@@ -170,6 +182,8 @@ interval &interval::operator*(interval &_b) const {
         }
     }
 
+    INTERVAL_PROFILE_RECORD(intervalOperationMultiply, max - min, _b.max - _b.min, highestFound - lowestFound);
+
     // Return a reference to this new interval
     return *(new interval(lowestFound, highestFound));
 }
@@ -215,6 +229,8 @@ interval &interval::operator/(interval &_b) const {
         }
     }
 
+    INTERVAL_PROFILE_RECORD(intervalOperationDivide, max - min, _b.max - _b.min, highestFound - lowestFound);
+
     // Return a reference to this new interval
     return *(new interval(lowestFound, highestFound));
 }
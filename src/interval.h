@@ -0,0 +1,83 @@
+//---------- FILE interval.h
+// Contains the declaration of the interval class, a closed range of floats {min, max}, and its operators
+//
+// Copyright Daniel Marcovecchio
+//
+// Dependencies: iostream - For the stream insertion and extraction operators, intervalProfile.h when built with
+// INTERVAL_PROFILE
+//----------
+
+#ifndef INTERVAL_H
+#define INTERVAL_H
+
+#include <iostream>
+
+// Build with INTERVAL_PROFILE defined to count the operations on intervals and the growth of their widths per call site,
+// reported when the program exits. Mark call sites with INTERVAL_PROFILE_SITE(). Without it both macros compile to nothing
+#ifdef INTERVAL_PROFILE
+#include "intervalProfile.h"
+#define INTERVAL_PROFILE_RECORD(operation, aWidth, bWidth, resultWidth) \
+    intervalProfileRecord(operation, aWidth, bWidth, resultWidth)
+#define INTERVAL_PROFILE_SITE() intervalProfileSite intervalProfileSiteHere(__FILE__, __LINE__)
+#else
+#define INTERVAL_PROFILE_RECORD(operation, aWidth, bWidth, resultWidth)
+#define INTERVAL_PROFILE_SITE()
+#endif
+
+/** Class interval
+ * An interval of floats from min to max, with the arithmetic operators overloaded so intervals can be used like numbers.
+ * The endpoints are private, the stream operators and intervalEndpoints are friends
+ */
+class interval {
+    float min, max;
+
+public:
+    interval();
+    interval(float _minMax);
+    interval(float _min, float _max);
+    interval(const interval &x);
+    ~interval();
+
+    interval operator=(const interval &_b);
+
+    interval &operator+(interval &_b) const;
+    interval &operator+=(interval &_b);
+    interval &operator+(float &_b) const;
+
+    interval &operator-(interval &_b) const;
+    interval &operator-=(interval &_b);
+    interval &operator-(float &_b) const;
+
+    interval &operator*(interval &_b) const;
+    interval &operator*=(interval &_b) const;
+
+    interval &operator/(interval &_b) const;
+    interval &operator/=(interval &_b) const;
+
+    float getMin() const;
+    float getMax() const;
+
+    friend std::ostream &operator<<(std::ostream &out, const interval &c);
+    friend std::istream &operator>>(std::istream &in, interval &c);
+
+    // Gives the array kernels direct access to the endpoints, so their loops can be inlined and vectorised
+    friend struct intervalEndpoints;
+};
+
+interval &operator+(float &_a, interval &_b);
+interval &operator-(float &_a, interval &_b);
+
+/** Struct intervalEndpoints
+ * Reads and writes the endpoints of intervals inside the array kernels. Defined inline so that loops over arrays of
+ * intervals see plain float loads and stores
+ */
+struct intervalEndpoints {
+    static float low(const interval &x) { return x.min; }
+    static float high(const interval &x) { return x.max; }
+    static void set(interval &x, float _min, float _max) {
+        x.min = _min;
+        x.max = _max;
+    }
+};
+
+#endif
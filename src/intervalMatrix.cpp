@@ -0,0 +1,530 @@
+//---------- FILE intervalMatrix.cpp
+// Contains the implementation of the intervalMatrix class and the interval linear system solver defined in
+// intervalMatrix.h
+//
+// Copyright Daniel Marcovecchio
+//
+// Dependencies: algorithm, cmath - For fabs and nextafter, limits, vector, omp.h when built with OpenMP,
+// intervalMatrix.h for declaration of interfaces
+//----------
+
+#include "intervalMatrix.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace {
+
+// The block of the product each thread works on at a time, rows of A by columns of B, and the depth of the shared
+// dimension taken at once. A block of B, its magnitudes and its upper bounds (4 * 64 * 128 floats) stays in L2 cache
+const size_t BLOCK_ROWS = 32;
+const size_t BLOCK_COLUMNS = 128;
+const size_t BLOCK_DEPTH = 64;
+
+// Products with fewer multiply-adds than this run on one thread, as starting the threads costs more than it saves
+const size_t PARALLEL_PRODUCT_MINIMUM = 1 << 16;
+
+// The most iterations the Krawczyk method takes to find an enclosure, and then to tighten it
+const int KRAWCZYK_INFLATION_ITERATIONS = 10;
+const int KRAWCZYK_REFINEMENT_ITERATIONS = 3;
+
+// The unit roundoff of float, 2^-24
+const double FLOAT_UNIT_ROUNDOFF = 5.9604644775390625e-08;
+
+/** Gamma Bound
+ * The bound on the relative error of a float sum of n products, n u / (1 - n u), from Higham.
+ *
+ * @param n The number of roundings.
+ * @return The bound.
+ */
+double gammaBound(size_t n) {
+    double nu = n * FLOAT_UNIT_ROUNDOFF;
+    return nu / (1 - nu);
+}
+
+/** Round Up To Float
+ * Converts a double to the smallest float no smaller than it.
+ *
+ * @param value The double to convert.
+ * @return The rounded float.
+ */
+float roundUpToFloat(double value) {
+    float rounded = (float) value;
+    if((double) rounded < value) {
+        rounded = std::nextafter(rounded, std::numeric_limits<float>::infinity());
+    }
+    return rounded;
+}
+
+/** Round Down To Float
+ * Converts a double to the largest float no bigger than it.
+ *
+ * @param value The double to convert.
+ * @return The rounded float.
+ */
+float roundDownToFloat(double value) {
+    float rounded = (float) value;
+    if((double) rounded > value) {
+        rounded = std::nextafter(rounded, -std::numeric_limits<float>::infinity());
+    }
+    return rounded;
+}
+
+/** To Midpoint Radius
+ * Converts an interval to a float midpoint and a radius big enough that the midpoint-radius form encloses it.
+ * Differences of floats are exact in double, so only the final rounding of the radius is needed.
+ *
+ * @param x The interval.
+ * @param midpoint Set to the midpoint.
+ * @param radius Set to the radius.
+ */
+void toMidpointRadius(const interval &x, float &midpoint, float &radius) {
+    double low = intervalEndpoints::low(x), high = intervalEndpoints::high(x);
+    midpoint = (float) (0.5 * (low + high));
+    double lowRadius = midpoint - low, highRadius = high - midpoint;
+    radius = roundUpToFloat(lowRadius > highRadius ? lowRadius : highRadius);
+}
+
+/** From Midpoint Radius
+ * Converts a midpoint and radius back to an interval, rounding the endpoints outwards.
+ *
+ * @param midpoint The midpoint.
+ * @param radius The radius.
+ * @return The interval from midpoint - radius to midpoint + radius.
+ */
+interval fromMidpointRadius(float midpoint, float radius) {
+    return interval(roundDownToFloat((double) midpoint - radius), roundUpToFloat((double) midpoint + radius));
+}
+
+/** Add Midpoint Radius
+ * Adds two intervals in midpoint-radius form. The radius grows by the rounding of the midpoint sum.
+ *
+ * @param aMidpoint, aRadius The first interval.
+ * @param bMidpoint, bRadius The second interval.
+ * @param midpoint, radius Set to the sum.
+ */
+void addMidpointRadius(float aMidpoint, float aRadius, float bMidpoint, float bRadius, float &midpoint, float &radius) {
+    double exact = (double) aMidpoint + bMidpoint;
+    midpoint = (float) exact;
+    radius = roundUpToFloat((double) aRadius + bRadius + std::fabs(exact - midpoint));
+}
+
+/** Multiply Midpoint Radius
+ * The product C = AB of an m by k and a k by n matrix, all in midpoint-radius form and stored row by row.
+ *
+ * Method - After Rump, mid C = mid A mid B and rad C = |mid A| rad B + rad A (|mid B| + rad B), all float products.
+ * The rounding of the midpoint product is at most gamma(k) |mid A| |mid B|, which is added to the radius, and the
+ * radius itself is rounded up by gamma(2k + 2). The three products share one pass over the blocks of A and B.
+ * Products with one column take the rows as dot products instead, which vectorise along the rows of A
+ *
+ * @param aMidpoints, aRadii The m by k matrix A.
+ * @param bMidpoints, bRadii The k by n matrix B.
+ * @param m, k, n The sizes of the matrices.
+ * @param cMidpoints, cRadii Filled with the m by n product.
+ */
+void multiplyMidpointRadius(const float *aMidpoints, const float *aRadii, const float *bMidpoints, const float *bRadii,
+                            size_t m, size_t k, size_t n, float *cMidpoints, float *cRadii) {
+#ifdef _OPENMP
+    // Only read by the parallel for pragmas, so serial builds leave it out
+    bool parallel = m * n * k >= PARALLEL_PRODUCT_MINIMUM;
+#endif
+
+    // |mid B| and |mid B| + rad B, so the inner loop is only multiply-adds
+    std::vector<float> bMagnitudes(k * n), bUpper(k * n);
+    std::vector<float> cMagnitudes(m * n, 0.f);
+    for(size_t i = 0; i < k * n; i++) {
+        bMagnitudes[i] = std::fabs(bMidpoints[i]);
+        bUpper[i] = bMagnitudes[i] + bRadii[i];
+    }
+
+    if(n == 1) {
+        #pragma omp parallel for schedule(static) if(parallel)
+        for(long i = 0; i < (long) m; i++) {
+            const float *aMidpointRow = aMidpoints + i * k, *aRadiusRow = aRadii + i * k;
+            float midpoint = 0, radius = 0, magnitude = 0;
+            #pragma omp simd reduction(+:midpoint, radius, magnitude)
+            for(size_t j = 0; j < k; j++) {
+                float aMagnitude = std::fabs(aMidpointRow[j]);
+                midpoint += aMidpointRow[j] * bMidpoints[j];
+                radius += aMagnitude * bRadii[j] + aRadiusRow[j] * bUpper[j];
+                magnitude += aMagnitude * bMagnitudes[j];
+            }
+            cMidpoints[i] = midpoint;
+            cRadii[i] = radius;
+            cMagnitudes[i] = magnitude;
+        }
+    } else {
+        std::fill(cMidpoints, cMidpoints + m * n, 0.f);
+        std::fill(cRadii, cRadii + m * n, 0.f);
+        long rowBlocks = (long) ((m + BLOCK_ROWS - 1) / BLOCK_ROWS);
+        long columnBlocks = (long) ((n + BLOCK_COLUMNS - 1) / BLOCK_COLUMNS);
+
+        #pragma omp parallel for collapse(2) schedule(dynamic) if(parallel)
+        for(long rowBlock = 0; rowBlock < rowBlocks; rowBlock++) {
+            for(long columnBlock = 0; columnBlock < columnBlocks; columnBlock++) {
+                size_t rowBegin = rowBlock * BLOCK_ROWS, rowEnd = std::min(rowBegin + BLOCK_ROWS, m);
+                size_t columnBegin = columnBlock * BLOCK_COLUMNS, columnEnd = std::min(columnBegin + BLOCK_COLUMNS, n);
+
+                for(size_t depthBegin = 0; depthBegin < k; depthBegin += BLOCK_DEPTH) {
+                    size_t depthEnd = std::min(depthBegin + BLOCK_DEPTH, k);
+                    for(size_t i = rowBegin; i < rowEnd; i++) {
+                        float *cMidpointRow = cMidpoints + i * n, *cRadiusRow = cRadii + i * n;
+                        float *cMagnitudeRow = cMagnitudes.data() + i * n;
+                        for(size_t d = depthBegin; d < depthEnd; d++) {
+                            float aMidpoint = aMidpoints[i * k + d], aRadius = aRadii[i * k + d];
+                            float aMagnitude = std::fabs(aMidpoint);
+                            const float *bMidpointRow = bMidpoints + d * n, *bRadiusRow = bRadii + d * n;
+                            const float *bMagnitudeRow = bMagnitudes.data() + d * n, *bUpperRow = bUpper.data() + d * n;
+                            #pragma omp simd
+                            for(size_t j = columnBegin; j < columnEnd; j++) {
+                                cMidpointRow[j] += aMidpoint * bMidpointRow[j];
+                                cRadiusRow[j] += aMagnitude * bRadiusRow[j] + aRadius * bUpperRow[j];
+                                cMagnitudeRow[j] += aMagnitude * bMagnitudeRow[j];
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    // Bound the rounding: the midpoint sum by gamma(k) of its magnitude, which itself may be gamma(k) low,
+    // the radius sum by gamma(2k + 2) as it adds two products per step on upper bounds that were rounded,
+    // and any underflow by the smallest float for each rounding
+    double midpointError = gammaBound(k) * (1 + gammaBound(k));
+    double radiusError = 1 + gammaBound(2 * k + 2);
+    double underflowError = (2 * k + 2) * (double) std::numeric_limits<float>::denorm_min();
+    for(size_t i = 0; i < m * n; i++) {
+        cRadii[i] = roundUpToFloat(cRadii[i] * radiusError + cMagnitudes[i] * midpointError + underflowError);
+    }
+}
+
+/** Invert Matrix
+ * An approximate inverse of a square matrix, by Gauss-Jordan elimination with partial pivoting in double.
+ * The inverse need not be exact, the Krawczyk method only needs it to be close.
+ *
+ * @param matrix The n by n matrix, stored row by row.
+ * @param n The size of the matrix.
+ * @param inverse Filled with the n by n inverse.
+ * @return False if the matrix is singular to working precision.
+ */
+bool invertMatrix(const std::vector<double> &matrix, size_t n, std::vector<double> &inverse) {
+    std::vector<double> work(matrix);
+    inverse.assign(n * n, 0.0);
+    for(size_t i = 0; i < n; i++) {
+        inverse[i * n + i] = 1.0;
+    }
+
+    for(size_t column = 0; column < n; column++) {
+        size_t pivot = column;
+        for(size_t row = column + 1; row < n; row++) {
+            if(std::fabs(work[row * n + column]) > std::fabs(work[pivot * n + column])) {
+                pivot = row;
+            }
+        }
+        if(work[pivot * n + column] == 0.0) {
+            return false;
+        }
+        if(pivot != column) {
+            std::swap_ranges(work.begin() + pivot * n, work.begin() + (pivot + 1) * n, work.begin() + column * n);
+            std::swap_ranges(inverse.begin() + pivot * n, inverse.begin() + (pivot + 1) * n, inverse.begin() + column * n);
+        }
+
+        double scale = 1.0 / work[column * n + column];
+        for(size_t j = 0; j < n; j++) {
+            work[column * n + j] *= scale;
+            inverse[column * n + j] *= scale;
+        }
+
+        // Eliminate the column from every other row, rows in parallel
+        #pragma omp parallel for schedule(static) if(n * n >= PARALLEL_PRODUCT_MINIMUM)
+        for(long row = 0; row < (long) n; row++) {
+            double factor = work[row * n + column];
+            if((size_t) row == column || factor == 0.0) {
+                continue;
+            }
+            #pragma omp simd
+            for(size_t j = 0; j < n; j++) {
+                work[row * n + j] -= factor * work[column * n + j];
+                inverse[row * n + j] -= factor * inverse[column * n + j];
+            }
+        }
+    }
+    return true;
+}
+
+}
+
+/** Default Constructor
+ * Initializes an empty matrix.
+ */
+intervalMatrix::intervalMatrix() : rows(0), columns(0) {}
+
+/** Overloaded Constructor
+ * Initializes a matrix of the given size with every entry zero.
+ *
+ * @param _rows The number of rows.
+ * @param _columns The number of columns.
+ */
+intervalMatrix::intervalMatrix(size_t _rows, size_t _columns)
+    : rows(_rows), columns(_columns), midpoints(_rows * _columns, 0.f), radii(_rows * _columns, 0.f) {}
+
+/** Get Rows
+ * Returns the number of rows of the matrix.
+ *
+ * @return The number of rows.
+ */
+size_t intervalMatrix::getRows() const {
+    return rows;
+}
+
+/** Get Columns
+ * Returns the number of columns of the matrix.
+ *
+ * @return The number of columns.
+ */
+size_t intervalMatrix::getColumns() const {
+    return columns;
+}
+
+/** Get Entry
+ * Returns an entry of the matrix as an interval.
+ *
+ * @param row The row of the entry.
+ * @param column The column of the entry.
+ * @return The entry, rounded outwards from its midpoint-radius form.
+ */
+interval intervalMatrix::get(size_t row, size_t column) const {
+    return fromMidpointRadius(midpoints[row * columns + column], radii[row * columns + column]);
+}
+
+/** Set Entry
+ * Sets an entry of the matrix from an interval.
+ *
+ * @param row The row of the entry.
+ * @param column The column of the entry.
+ * @param x The interval to store.
+ */
+void intervalMatrix::set(size_t row, size_t column, const interval &x) {
+    toMidpointRadius(x, midpoints[row * columns + column], radii[row * columns + column]);
+}
+
+/** Get Midpoint
+ * Returns the midpoint of an entry of the matrix.
+ *
+ * @param row The row of the entry.
+ * @param column The column of the entry.
+ * @return The midpoint.
+ */
+float intervalMatrix::getMidpoint(size_t row, size_t column) const {
+    return midpoints[row * columns + column];
+}
+
+/** Get Radius
+ * Returns the radius of an entry of the matrix.
+ *
+ * @param row The row of the entry.
+ * @param column The column of the entry.
+ * @return The radius.
+ */
+float intervalMatrix::getRadius(size_t row, size_t column) const {
+    return radii[row * columns + column];
+}
+
+/** Set Midpoint Radius
+ * Sets an entry of the matrix directly from a midpoint and radius.
+ *
+ * @param row The row of the entry.
+ * @param column The column of the entry.
+ * @param midpoint The midpoint.
+ * @param radius The radius, which must not be negative.
+ */
+void intervalMatrix::setMidpointRadius(size_t row, size_t column, float midpoint, float radius) {
+    midpoints[row * columns + column] = midpoint;
+    radii[row * columns + column] = radius;
+}
+
+/** Multiplication Operator Overload
+ * Multiplies two interval matrices.
+ *
+ * @param _b The matrix to multiply by, which must have as many rows as this matrix has columns.
+ * @return The product, or an empty matrix if the sizes do not match.
+ */
+intervalMatrix intervalMatrix::operator*(const intervalMatrix &_b) const {
+    if(columns != _b.rows) {
+        std::cout << "Error in operator* in intervalMatrix: cannot multiply a " << rows << "x" << columns
+                  << " matrix by a " << _b.rows << "x" << _b.columns << " matrix\n";
+        return intervalMatrix();
+    }
+
+    intervalMatrix product(rows, _b.columns);
+    multiplyMidpointRadius(midpoints.data(), radii.data(), _b.midpoints.data(), _b.radii.data(),
+                           rows, columns, _b.columns, product.midpoints.data(), product.radii.data());
+    return product;
+}
+
+/** Multiplication Operator Overload
+ * Multiplies an interval matrix by a vector of intervals.
+ *
+ * @param _x The vector to multiply by, which must have as many entries as this matrix has columns.
+ * @return The product, or an empty vector if the sizes do not match.
+ */
+std::vector<interval> intervalMatrix::operator*(const std::vector<interval> &_x) const {
+    if(columns != _x.size()) {
+        std::cout << "Error in operator* in intervalMatrix: cannot multiply a " << rows << "x" << columns
+                  << " matrix by a vector of " << _x.size() << "\n";
+        return std::vector<interval>();
+    }
+
+    std::vector<float> xMidpoints(columns), xRadii(columns), yMidpoints(rows), yRadii(rows);
+    for(size_t i = 0; i < columns; i++) {
+        toMidpointRadius(_x[i], xMidpoints[i], xRadii[i]);
+    }
+    multiplyMidpointRadius(midpoints.data(), radii.data(), xMidpoints.data(), xRadii.data(),
+                           rows, columns, 1, yMidpoints.data(), yRadii.data());
+
+    std::vector<interval> product;
+    product.reserve(rows);
+    for(size_t i = 0; i < rows; i++) {
+        product.push_back(fromMidpointRadius(yMidpoints[i], yRadii[i]));
+    }
+    return product;
+}
+
+/** Stream Insertion Operator Overload
+ * Outputs the matrix one row per line, each entry as its min and max.
+ *
+ * @param out The output stream.
+ * @param c The matrix to output.
+ * @return The output stream.
+ */
+std::ostream &operator<<(std::ostream &out, const intervalMatrix &c) {
+    for(size_t row = 0; row < c.rows; row++) {
+        for(size_t column = 0; column < c.columns; column++) {
+            interval entry = c.get(row, column);
+            out << "[" << entry.getMin() << ", " << entry.getMax() << "] ";
+        }
+        out << "\n";
+    }
+    return out;
+}
+
+bool solveIntervalSystem(const intervalMatrix &a, const std::vector<interval> &b, std::vector<interval> &x) {
+    size_t n = a.rows;
+    if(a.columns != n || b.size() != n) {
+        std::cout << "Error in solveIntervalSystem: the system must be square and match the right hand side\n";
+        return false;
+    }
+
+    // -- Approximate inverse R of mid A, and approximate solution x~ = R mid b with one step of refinement --
+    std::vector<double> midpointA(a.midpoints.begin(), a.midpoints.end()), inverse;
+    if(!invertMatrix(midpointA, n, inverse)) {
+        return false;
+    }
+    std::vector<float> bMidpoints(n), bRadii(n);
+    for(size_t i = 0; i < n; i++) {
+        toMidpointRadius(b[i], bMidpoints[i], bRadii[i]);
+    }
+    std::vector<double> approximate(n, 0.0), residual(n);
+    for(int pass = 0; pass < 2; pass++) {
+        for(size_t i = 0; i < n; i++) {
+            double sum = bMidpoints[i];
+            for(size_t j = 0; j < n; j++) {
+                sum -= midpointA[i * n + j] * approximate[j];
+            }
+            residual[i] = sum;
+        }
+        for(size_t i = 0; i < n; i++) {
+            double sum = 0;
+            for(size_t j = 0; j < n; j++) {
+                sum += inverse[i * n + j] * residual[j];
+            }
+            approximate[i] += sum;
+        }
+    }
+    std::vector<float> xApproximate(approximate.begin(), approximate.end());
+    std::vector<float> zeroRadii(n * n, 0.f);
+    std::vector<float> rMidpoints(inverse.begin(), inverse.end());
+    // --
+
+    // -- z = R (b - A x~), which encloses R times the residual of every system --
+    std::vector<float> axMidpoints(n), axRadii(n), zMidpoints(n), zRadii(n);
+    multiplyMidpointRadius(a.midpoints.data(), a.radii.data(), xApproximate.data(), zeroRadii.data(),
+                           n, n, 1, axMidpoints.data(), axRadii.data());
+    for(size_t i = 0; i < n; i++) {
+        addMidpointRadius(bMidpoints[i], bRadii[i], -axMidpoints[i], axRadii[i], axMidpoints[i], axRadii[i]);
+    }
+    multiplyMidpointRadius(rMidpoints.data(), zeroRadii.data(), axMidpoints.data(), axRadii.data(),
+                           n, n, 1, zMidpoints.data(), zRadii.data());
+    // --
+
+    // -- C = I - R A --
+    std::vector<float> cMidpoints(n * n), cRadii(n * n);
+    multiplyMidpointRadius(rMidpoints.data(), zeroRadii.data(), a.midpoints.data(), a.radii.data(),
+                           n, n, n, cMidpoints.data(), cRadii.data());
+    for(size_t i = 0; i < n * n; i++) {
+        addMidpointRadius(i % (n + 1) == 0 ? 1.f : 0.f, 0.f, -cMidpoints[i], cRadii[i], cMidpoints[i], cRadii[i]);
+    }
+    // --
+
+    // -- Krawczyk iteration X = z + C X, from an inflated guess, until X maps into its own interior --
+    std::vector<float> xMidpoints(zMidpoints), xRadii(zRadii);
+    std::vector<float> yMidpoints(n), yRadii(n), cyMidpoints(n), cyRadii(n);
+    bool verified = false;
+    for(int iteration = 0; iteration < KRAWCZYK_INFLATION_ITERATIONS && !verified; iteration++) {
+        // Y = X [0.9, 1.1] + [-tiny, tiny]
+        for(size_t i = 0; i < n; i++) {
+            yMidpoints[i] = xMidpoints[i];
+            yRadii[i] = roundUpToFloat(1.1 * xRadii[i] + 0.1 * std::fabs(xMidpoints[i]) +
+                                       std::numeric_limits<float>::min());
+        }
+        multiplyMidpointRadius(cMidpoints.data(), cRadii.data(), yMidpoints.data(), yRadii.data(),
+                               n, n, 1, cyMidpoints.data(), cyRadii.data());
+
+        verified = true;
+        for(size_t i = 0; i < n; i++) {
+            addMidpointRadius(zMidpoints[i], zRadii[i], cyMidpoints[i], cyRadii[i], xMidpoints[i], xRadii[i]);
+            // X inside the interior of Y, |mid X - mid Y| + rad X < rad Y
+            if(std::fabs((double) xMidpoints[i] - yMidpoints[i]) + xRadii[i] >= yRadii[i]) {
+                verified = false;
+            }
+        }
+    }
+    if(!verified) {
+        return false;
+    }
+    // --
+
+    // -- Tighten with X = (z + C X) intersected with X, then x = x~ + X --
+    x.clear();
+    std::vector<interval> enclosure;
+    for(size_t i = 0; i < n; i++) {
+        enclosure.push_back(fromMidpointRadius(xMidpoints[i], xRadii[i]));
+    }
+    for(int iteration = 0; iteration < KRAWCZYK_REFINEMENT_ITERATIONS; iteration++) {
+        multiplyMidpointRadius(cMidpoints.data(), cRadii.data(), xMidpoints.data(), xRadii.data(),
+                               n, n, 1, cyMidpoints.data(), cyRadii.data());
+        for(size_t i = 0; i < n; i++) {
+            addMidpointRadius(zMidpoints[i], zRadii[i], cyMidpoints[i], cyRadii[i], yMidpoints[i], yRadii[i]);
+            interval next = fromMidpointRadius(yMidpoints[i], yRadii[i]);
+            float low = std::max(next.getMin(), enclosure[i].getMin());
+            float high = std::min(next.getMax(), enclosure[i].getMax());
+            intervalEndpoints::set(enclosure[i], low, high);
+            toMidpointRadius(enclosure[i], xMidpoints[i], xRadii[i]);
+        }
+    }
+    for(size_t i = 0; i < n; i++) {
+        float midpoint, radius;
+        toMidpointRadius(enclosure[i], midpoint, radius);
+        addMidpointRadius(xApproximate[i], 0.f, midpoint, radius, midpoint, radius);
+        x.push_back(fromMidpointRadius(midpoint, radius));
+    }
+    // --
+
+    return true;
+}
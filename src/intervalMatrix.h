@@ -0,0 +1,65 @@
+//---------- FILE intervalMatrix.h
+// Contains the declaration of the intervalMatrix class, its products, and the interval linear system solver
+//
+// Copyright Daniel Marcovecchio
+//
+// Dependencies: iostream - For the stream insertion operator, vector, interval.h for the interval class
+//----------
+
+#ifndef INTERVAL_MATRIX_H
+#define INTERVAL_MATRIX_H
+
+#include <iostream>
+#include <vector>
+#include "interval.h"
+
+/** Class intervalMatrix
+ * A matrix of intervals, stored row by row in midpoint-radius form: each entry is the interval
+ * {midpoint - radius, midpoint + radius}. This lets a product of interval matrices be worked out with ordinary
+ * float matrix products of the midpoints and radii, instead of four products and a min and max per entry.
+ *
+ * Products are cache blocked and split across threads, and their radii include a bound on the float rounding,
+ * so the result always encloses every product of matrices taken from the operands
+ */
+class intervalMatrix {
+    size_t rows, columns;
+    std::vector<float> midpoints;
+    std::vector<float> radii;
+
+public:
+    intervalMatrix();
+    intervalMatrix(size_t _rows, size_t _columns);
+
+    size_t getRows() const;
+    size_t getColumns() const;
+
+    interval get(size_t row, size_t column) const;
+    void set(size_t row, size_t column, const interval &x);
+    float getMidpoint(size_t row, size_t column) const;
+    float getRadius(size_t row, size_t column) const;
+    void setMidpointRadius(size_t row, size_t column, float midpoint, float radius);
+
+    intervalMatrix operator*(const intervalMatrix &_b) const;
+    std::vector<interval> operator*(const std::vector<interval> &_x) const;
+
+    friend std::ostream &operator<<(std::ostream &out, const intervalMatrix &c);
+    friend bool solveIntervalSystem(const intervalMatrix &a, const std::vector<interval> &b, std::vector<interval> &x);
+};
+
+/** Solve Interval System
+ * Encloses the solutions of every linear system Ax = b with A and b taken from the given intervals, using
+ * the Krawczyk method.
+ *
+ * An approximate inverse R of the midpoint of A and an approximate solution x~ are found in double.
+ * The error of x~ is then enclosed by iterating X = R(b - Ax~) + (I - RA)X from a slightly inflated guess.
+ * Once X maps into its own interior, every solution lies in x~ + X. A few more iterations, each intersected
+ * with the last, then tighten the enclosure
+ *
+ * @param a The square matrix of the system.
+ * @param b The right hand side.
+ * @param x Set to the enclosure of the solutions.
+ * @return True if the enclosure was verified, false if A is singular or too wide for the method.
+ */
+bool solveIntervalSystem(const intervalMatrix &a, const std::vector<interval> &b, std::vector<interval> &x);
+
+#endif
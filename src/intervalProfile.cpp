@@ -0,0 +1,228 @@
+//---------- FILE intervalProfile.cpp
+// Contains the implementation of the interval profiler defined in intervalProfile.h.
+// The whole file is empty unless built with INTERVAL_PROFILE, so normal builds carry none of it
+//
+// Copyright Daniel Marcovecchio
+//
+// Dependencies: iostream - For the report on std::cerr, cmath - For frexp, algorithm, map, memory, mutex, string,
+// utility, vector, intervalProfile.h for declaration of interfaces
+//----------
+
+#ifdef INTERVAL_PROFILE
+
+#include "intervalProfile.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// Result widths are counted in buckets by their power of two, from 2^SMALLEST_WIDTH_EXPONENT (and anything smaller)
+// up. The first bucket counts widths of zero
+const int WIDTH_BUCKETS = 48;
+const int SMALLEST_WIDTH_EXPONENT = -32;
+
+// Width growth is counted the same way from 2^SMALLEST_GROWTH_EXPONENT up. The last bucket counts results that
+// have width although every input was a single point
+const int GROWTH_BUCKETS = 32;
+const int SMALLEST_GROWTH_EXPONENT = -8;
+
+const char *OPERATION_NAMES[intervalOperationCount] = {"+", "+=", "+ float", "-", "-=", "- float", "*", "/"};
+
+/** Struct SiteStatistics
+ * What the profiler has counted at one call site
+ */
+struct SiteStatistics {
+    unsigned long long operations[intervalOperationCount];
+    unsigned long long widths[WIDTH_BUCKETS];
+    unsigned long long growth[GROWTH_BUCKETS];
+    unsigned long long invertedResults;
+    double largestGrowth;
+};
+
+// A call site, by the file and line of its INTERVAL_PROFILE_SITE()
+typedef std::pair<const char *, int> SiteKey;
+
+/** Struct ThreadProfile
+ * The sites counted by one thread, so threads never wait on each other to record.
+ * current is the innermost site open on the thread, or the "(no site)" entry.
+ * The mutex is only ever contended by the report at exit, which may run while pool threads are still alive
+ */
+struct ThreadProfile {
+    std::mutex mutex;
+    std::map<SiteKey, SiteStatistics> sites;
+    SiteStatistics *current;
+
+    ThreadProfile() : current(&sites[SiteKey("(no site)", 0)]) {}
+};
+
+/** Class ProfileRegistry
+ * Owns the profile of every thread that has recorded, and prints the report when it is destroyed at exit.
+ * Thread profiles are kept until then, as the threads of a pool are not joined before the program exits
+ */
+class ProfileRegistry {
+    std::mutex mutex;
+    std::vector<std::unique_ptr<ThreadProfile> > threads;
+
+public:
+    ~ProfileRegistry() {
+        report();
+    }
+
+    ThreadProfile *addThread() {
+        std::lock_guard<std::mutex> lock(mutex);
+        threads.push_back(std::unique_ptr<ThreadProfile>(new ThreadProfile()));
+        return threads.back().get();
+    }
+
+    void report();
+};
+
+ProfileRegistry &registry() {
+    static ProfileRegistry instance;
+    return instance;
+}
+
+thread_local ThreadProfile *threadProfile = nullptr;
+
+ThreadProfile &currentThread() {
+    if(threadProfile == nullptr) {
+        threadProfile = registry().addThread();
+    }
+    return *threadProfile;
+}
+
+/** Bucket
+ * The bucket a positive value falls in by its power of two.
+ *
+ * @param value The value.
+ * @param smallestExponent The power of two of the first bucket.
+ * @param buckets The number of buckets.
+ * @return The bucket, clamped to the first and last.
+ */
+int bucket(double value, int smallestExponent, int buckets) {
+    int exponent;
+    std::frexp(value, &exponent);
+    return std::max(0, std::min(exponent - smallestExponent, buckets - 1));
+}
+
+void ProfileRegistry::report() {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    // Merge the threads, site by site
+    std::map<std::string, SiteStatistics> sites;
+    for(size_t t = 0; t < threads.size(); t++) {
+        std::lock_guard<std::mutex> threadLock(threads[t]->mutex);
+        for(std::map<SiteKey, SiteStatistics>::const_iterator it = threads[t]->sites.begin();
+            it != threads[t]->sites.end(); ++it) {
+            std::string name = it->first.first;
+            if(it->first.second > 0) {
+                name += ":" + std::to_string(it->first.second);
+            }
+            SiteStatistics &total = sites[name];
+            for(int i = 0; i < intervalOperationCount; i++) {
+                total.operations[i] += it->second.operations[i];
+            }
+            for(int i = 0; i < WIDTH_BUCKETS; i++) {
+                total.widths[i] += it->second.widths[i];
+            }
+            for(int i = 0; i < GROWTH_BUCKETS; i++) {
+                total.growth[i] += it->second.growth[i];
+            }
+            total.invertedResults += it->second.invertedResults;
+            total.largestGrowth = std::max(total.largestGrowth, it->second.largestGrowth);
+        }
+    }
+
+    std::cerr << "--- Interval profile ---\n";
+    for(std::map<std::string, SiteStatistics>::const_iterator it = sites.begin(); it != sites.end(); ++it) {
+        const SiteStatistics &site = it->second;
+        unsigned long long total = 0;
+        for(int i = 0; i < intervalOperationCount; i++) {
+            total += site.operations[i];
+        }
+        if(total == 0) {
+            continue;
+        }
+
+        std::cerr << "Site " << it->first << ": " << total << " operations\n  By type:";
+        for(int i = 0; i < intervalOperationCount; i++) {
+            if(site.operations[i] > 0) {
+                std::cerr << " " << OPERATION_NAMES[i] << " " << site.operations[i];
+            }
+        }
+        std::cerr << "\n  Result widths:";
+        for(int i = 0; i < WIDTH_BUCKETS; i++) {
+            if(site.widths[i] > 0) {
+                if(i == 0) {
+                    std::cerr << " 0: " << site.widths[i];
+                } else {
+                    std::cerr << " <2^" << SMALLEST_WIDTH_EXPONENT + i - 1 << ": " << site.widths[i];
+                }
+            }
+        }
+        std::cerr << "\n  Width growth:";
+        for(int i = 0; i < GROWTH_BUCKETS; i++) {
+            if(site.growth[i] > 0) {
+                if(i == GROWTH_BUCKETS - 1) {
+                    std::cerr << " from points: " << site.growth[i];
+                } else {
+                    std::cerr << " <x2^" << SMALLEST_GROWTH_EXPONENT + i << ": " << site.growth[i];
+                }
+            }
+        }
+        std::cerr << "\n  Largest growth: x" << site.largestGrowth;
+        if(site.invertedResults > 0) {
+            std::cerr << ", results with max below min: " << site.invertedResults;
+        }
+        std::cerr << "\n";
+    }
+}
+
+}
+
+void intervalProfileRecord(intervalOperation operation, float aWidth, float bWidth, float resultWidth) {
+    ThreadProfile &thread = currentThread();
+    std::lock_guard<std::mutex> lock(thread.mutex);
+    SiteStatistics &site = *thread.current;
+    site.operations[operation]++;
+
+    if(resultWidth < 0) {
+        site.invertedResults++;
+        return;
+    }
+    site.widths[resultWidth == 0 ? 0 : bucket(resultWidth, SMALLEST_WIDTH_EXPONENT, WIDTH_BUCKETS - 1) + 1]++;
+
+    float inputWidth = std::max(aWidth, bWidth);
+    if(inputWidth > 0) {
+        double growth = (double) resultWidth / inputWidth;
+        site.growth[growth == 0 ? 0 : bucket(growth, SMALLEST_GROWTH_EXPONENT, GROWTH_BUCKETS - 1)]++;
+        site.largestGrowth = std::max(site.largestGrowth, growth);
+    } else if(resultWidth > 0) {
+        site.growth[GROWTH_BUCKETS - 1]++;
+    } else {
+        site.growth[bucket(1.0, SMALLEST_GROWTH_EXPONENT, GROWTH_BUCKETS - 1)]++;
+    }
+}
+
+intervalProfileSite::intervalProfileSite(const char *file, int line) {
+    ThreadProfile &thread = currentThread();
+    std::lock_guard<std::mutex> lock(thread.mutex);
+    previous = thread.current;
+    thread.current = &thread.sites[SiteKey(file, line)];
+}
+
+intervalProfileSite::~intervalProfileSite() {
+    ThreadProfile &thread = currentThread();
+    std::lock_guard<std::mutex> lock(thread.mutex);
+    thread.current = static_cast<SiteStatistics *>(previous);
+}
+
+#endif
@@ -0,0 +1,53 @@
+//---------- FILE intervalProfile.h
+// Contains the declaration of the interval profiler, which counts operations on intervals and the growth of their
+// widths per call site, and reports them when the program exits. Only built when INTERVAL_PROFILE is defined
+//
+// Copyright Daniel Marcovecchio
+//
+// Dependencies: none
+//----------
+
+#ifndef INTERVAL_PROFILE_H
+#define INTERVAL_PROFILE_H
+
+/** Enum intervalOperation
+ * The operations of the interval class that the profiler counts separately.
+ * *= and /= are built on * and /, and are counted as those
+ */
+enum intervalOperation {
+    intervalOperationAdd,
+    intervalOperationAddAssign,
+    intervalOperationAddFloat,
+    intervalOperationSubtract,
+    intervalOperationSubtractAssign,
+    intervalOperationSubtractFloat,
+    intervalOperationMultiply,
+    intervalOperationDivide,
+    intervalOperationCount
+};
+
+/** Interval Profile Record
+ * Records one operation against the innermost profile site of the calling thread.
+ * The growth of an operation is its result width over the widest of its inputs.
+ *
+ * @param operation The operation.
+ * @param aWidth The width of the first input.
+ * @param bWidth The width of the second input, 0 for a float.
+ * @param resultWidth The width of the result.
+ */
+void intervalProfileRecord(intervalOperation operation, float aWidth, float bWidth, float resultWidth);
+
+/** Class intervalProfileSite
+ * Marks a call site for the profiler. Operations on the same thread are counted against the site until it goes out
+ * of scope, when the site it was made inside is restored. Made with the INTERVAL_PROFILE_SITE() macro, which names
+ * the site by its file and line
+ */
+class intervalProfileSite {
+    void *previous;
+
+public:
+    intervalProfileSite(const char *file, int line);
+    ~intervalProfileSite();
+};
+
+#endif
@@ -0,0 +1,282 @@
+//---------- FILE intervalReductions.cpp
+// Contains the implementation of the reductions over arrays of intervals defined in intervalReductions.h
+//
+// Copyright Daniel Marcovecchio
+//
+// Dependencies: algorithm - For max, cmath - For sqrt, fabs and nextafter, limits, vector, omp.h when built with OpenMP,
+// intervalReductions.h for declaration of interfaces
+//----------
+
+#include "intervalReductions.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace {
+
+// The number of independent sums each thread keeps, one per vector lane
+const int REDUCTION_LANES = 8;
+
+// Arrays shorter than this are reduced on one thread, as starting the threads costs more than it saves
+const size_t PARALLEL_REDUCTION_MINIMUM = 1 << 15;
+
+/** Struct CompensatedSum
+ * A sum of doubles kept as the rounded sum and the rounding error dropped on the way,
+ * which together hold the sum to about twice double precision. The magnitude, the sum of the absolute values of
+ * the terms, bounds how far sum + error can still be from the true sum
+ */
+struct CompensatedSum {
+    double sum;
+    double error;
+    double magnitude;
+};
+
+/** Struct EndpointSums
+ * The compensated sums of the low and the high endpoints of a reduction, and how many additions went into each
+ */
+struct EndpointSums {
+    CompensatedSum low;
+    CompensatedSum high;
+    size_t additions;
+};
+
+/** Two Sum
+ * Adds two doubles, also giving the exact rounding error of the addition (Knuth's error-free transformation).
+ * Must not be built with -ffast-math, which would simplify the error away to zero
+ *
+ * @param a, b The doubles to add.
+ * @param sum Set to the rounded sum.
+ * @param error Set to the exact value of a + b - sum.
+ */
+inline void twoSum(double a, double b, double &sum, double &error) {
+    sum = a + b;
+    double bPart = sum - a;
+    error = (a - (sum - bPart)) + (b - bPart);
+}
+
+/** Add Compensated
+ * Adds one compensated sum into another.
+ *
+ * @param total The sum to add to.
+ * @param part The sum to add.
+ */
+inline void addCompensated(CompensatedSum &total, const CompensatedSum &part) {
+    double sum, error;
+    twoSum(total.sum, part.sum, sum, error);
+    total.sum = sum;
+    total.error += part.error + error;
+    total.magnitude += part.magnitude;
+}
+
+/** Error Bound
+ * Bounds the distance between sum + error and the true sum of the terms. After Ogita, Rump and Oishi this is
+ * gamma(n)^2 times the sum of the absolute values of the terms, where gamma(n) = n u / (1 - n u) and u is the unit
+ * roundoff of double. The bound is doubled to also cover the rounding of the magnitude and of the widening itself
+ *
+ * @param total The compensated sum.
+ * @param additions The number of additions made into the sum.
+ * @return The bound on the error left in the compensated sum.
+ */
+double errorBound(const CompensatedSum &total, size_t additions) {
+    double roundoff = std::numeric_limits<double>::epsilon() / 2;
+    double gamma = (double) additions * roundoff / (1 - (double) additions * roundoff);
+    return 2 * gamma * gamma * total.magnitude;
+}
+
+/** Lower Bound
+ * Gives a double no bigger than the true sum, the compensated sum less its error bound.
+ * The step down covers the rounding of the last addition
+ *
+ * @param total The compensated sum.
+ * @param additions The number of additions made into the sum.
+ * @return A lower bound on the true sum.
+ */
+double lowerBound(const CompensatedSum &total, size_t additions) {
+    double sum, error;
+    twoSum(total.sum, total.error, sum, error);
+    return std::nextafter(sum + (error - errorBound(total, additions)), -std::numeric_limits<double>::infinity());
+}
+
+/** Upper Bound
+ * Gives a double no smaller than the true sum, the compensated sum plus its error bound.
+ *
+ * @param total The compensated sum.
+ * @param additions The number of additions made into the sum.
+ * @return An upper bound on the true sum.
+ */
+double upperBound(const CompensatedSum &total, size_t additions) {
+    double sum, error;
+    twoSum(total.sum, total.error, sum, error);
+    return std::nextafter(sum + (error + errorBound(total, additions)), std::numeric_limits<double>::infinity());
+}
+
+/** Round Down
+ * Rounds a double to the largest float no bigger than it.
+ *
+ * @param value The double to round.
+ * @return The value rounded towards minus infinity.
+ */
+float roundDown(double value) {
+    float rounded = (float) value;
+    if((double) rounded > value) {
+        rounded = std::nextafter(rounded, -std::numeric_limits<float>::infinity());
+    }
+    return rounded;
+}
+
+/** Round Up
+ * Rounds a double to the smallest float no smaller than it.
+ *
+ * @param value The double to round.
+ * @return The value rounded towards plus infinity.
+ */
+float roundUp(double value) {
+    float rounded = (float) value;
+    if((double) rounded < value) {
+        rounded = std::nextafter(rounded, std::numeric_limits<float>::infinity());
+    }
+    return rounded;
+}
+
+/** Reduce Range
+ * Sums the terms from begin to end on the calling thread. Each of the REDUCTION_LANES lanes keeps its own
+ * compensated sum of every REDUCTION_LANES-th term, so the lanes have no dependency on each other and vectorise.
+ *
+ * @param term Called as term(i, low, high) to give the endpoints of the i-th term as doubles.
+ * @param begin The first term.
+ * @param end One past the last term.
+ * @return The compensated sums of the low and high endpoints.
+ */
+template <class Term>
+EndpointSums reduceRange(const Term &term, size_t begin, size_t end) {
+    double lowSum[REDUCTION_LANES] = {}, lowError[REDUCTION_LANES] = {}, lowMagnitude[REDUCTION_LANES] = {};
+    double highSum[REDUCTION_LANES] = {}, highError[REDUCTION_LANES] = {}, highMagnitude[REDUCTION_LANES] = {};
+
+    size_t i = begin;
+    for(; i + REDUCTION_LANES <= end; i += REDUCTION_LANES) {
+        #pragma omp simd
+        for(int lane = 0; lane < REDUCTION_LANES; lane++) {
+            double low, high;
+            term(i + lane, low, high);
+
+            // twoSum written out, so the compiler sees the lanes side by side
+            double sum = lowSum[lane] + low;
+            double part = sum - lowSum[lane];
+            lowError[lane] += (lowSum[lane] - (sum - part)) + (low - part);
+            lowSum[lane] = sum;
+            lowMagnitude[lane] += std::fabs(low);
+
+            sum = highSum[lane] + high;
+            part = sum - highSum[lane];
+            highError[lane] += (highSum[lane] - (sum - part)) + (high - part);
+            highSum[lane] = sum;
+            highMagnitude[lane] += std::fabs(high);
+        }
+    }
+
+    EndpointSums result = {{0, 0, 0}, {0, 0, 0}, 0};
+    for(int lane = 0; lane < REDUCTION_LANES; lane++) {
+        CompensatedSum low = {lowSum[lane], lowError[lane], lowMagnitude[lane]};
+        CompensatedSum high = {highSum[lane], highError[lane], highMagnitude[lane]};
+        addCompensated(result.low, low);
+        addCompensated(result.high, high);
+    }
+
+    // The terms left over after the last full set of lanes
+    for(; i < end; i++) {
+        CompensatedSum low = {0, 0, 0}, high = {0, 0, 0};
+        term(i, low.sum, high.sum);
+        low.magnitude = std::fabs(low.sum);
+        high.magnitude = std::fabs(high.sum);
+        addCompensated(result.low, low);
+        addCompensated(result.high, high);
+    }
+    return result;
+}
+
+/** Reduce
+ * Sums count terms across the threads. Each thread takes one contiguous part of the terms, and the parts are then
+ * added pairwise as a tree, so for a given number of threads the result is the same on every run.
+ *
+ * @param term Called as term(i, low, high) to give the endpoints of the i-th term as doubles.
+ * @param count The number of terms.
+ * @return The compensated sums of the low and high endpoints.
+ */
+template <class Term>
+EndpointSums reduce(const Term &term, size_t count) {
+    int threads = 1;
+#ifdef _OPENMP
+    if(count >= PARALLEL_REDUCTION_MINIMUM) {
+        threads = omp_get_max_threads();
+    }
+#endif
+
+    std::vector<EndpointSums> parts(threads);
+    #pragma omp parallel num_threads(threads) if(threads > 1)
+    {
+        size_t thread = 0, threadCount = 1;
+#ifdef _OPENMP
+        thread = omp_get_thread_num();
+        threadCount = omp_get_num_threads();
+#endif
+        parts[thread] = reduceRange(term, count * thread / threadCount, count * (thread + 1) / threadCount);
+    }
+
+    for(size_t step = 1; step < parts.size(); step *= 2) {
+        for(size_t i = 0; i + step < parts.size(); i += 2 * step) {
+            addCompensated(parts[i].low, parts[i + step].low);
+            addCompensated(parts[i].high, parts[i + step].high);
+        }
+    }
+    // Every term, lane and part is added once into the sum, and the error of each addition is added twice into the error
+    parts[0].additions = 2 * (count + (REDUCTION_LANES + 1) * parts.size());
+    return parts[0];
+}
+
+}
+
+interval intervalSum(const interval *values, size_t count) {
+    EndpointSums sums = reduce([values](size_t i, double &low, double &high) {
+        low = intervalEndpoints::low(values[i]);
+        high = intervalEndpoints::high(values[i]);
+    }, count);
+
+    return interval(roundDown(lowerBound(sums.low, sums.additions)), roundUp(upperBound(sums.high, sums.additions)));
+}
+
+interval intervalDot(const interval *a, const interval *b, size_t count) {
+    EndpointSums sums = reduce([a, b](size_t i, double &low, double &high) {
+        // {cmin, cmax}={ The minimum and maximum of amin*bmin, amin*bmax, amax*bmin, amax*bmax }
+        // Products of two floats are exact in double
+        double aMin = intervalEndpoints::low(a[i]), aMax = intervalEndpoints::high(a[i]);
+        double bMin = intervalEndpoints::low(b[i]), bMax = intervalEndpoints::high(b[i]);
+        double p0 = aMin * bMin, p1 = aMin * bMax, p2 = aMax * bMin, p3 = aMax * bMax;
+        double low01 = p0 < p1 ? p0 : p1, low23 = p2 < p3 ? p2 : p3;
+        double high01 = p0 > p1 ? p0 : p1, high23 = p2 > p3 ? p2 : p3;
+        low = low01 < low23 ? low01 : low23;
+        high = high01 > high23 ? high01 : high23;
+    }, count);
+
+    return interval(roundDown(lowerBound(sums.low, sums.additions)), roundUp(upperBound(sums.high, sums.additions)));
+}
+
+interval intervalNorm(const interval *values, size_t count) {
+    EndpointSums sums = reduce([values](size_t i, double &low, double &high) {
+        double xMin = intervalEndpoints::low(values[i]), xMax = intervalEndpoints::high(values[i]);
+        double minSquared = xMin * xMin, maxSquared = xMax * xMax;
+        high = minSquared > maxSquared ? minSquared : maxSquared;
+        low = xMin <= 0 && xMax >= 0 ? 0 : (minSquared < maxSquared ? minSquared : maxSquared);
+    }, count);
+
+    // The square roots of the bounds, stepped outwards past the rounding of sqrt and then rounded outwards to float
+    double lowSquares = std::max(lowerBound(sums.low, sums.additions), 0.0);
+    double highSquares = upperBound(sums.high, sums.additions);
+    double lowRoot = std::max(std::nextafter(std::sqrt(lowSquares), 0.0), 0.0);
+    double highRoot = std::nextafter(std::sqrt(highSquares), std::numeric_limits<double>::infinity());
+    return interval(roundDown(lowRoot), roundUp(highRoot));
+}
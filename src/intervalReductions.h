@@ -0,0 +1,53 @@
+//---------- FILE intervalReductions.h
+// Contains the declaration of the reductions over contiguous arrays of intervals, sum, dot product and norm
+//
+// Copyright Daniel Marcovecchio
+//
+// Dependencies: cstddef - For size_t, interval.h for the interval class
+//----------
+
+#ifndef INTERVAL_REDUCTIONS_H
+#define INTERVAL_REDUCTIONS_H
+
+#include <cstddef>
+#include "interval.h"
+
+/** Interval Sum
+ * Adds up an array of intervals, the mins and the maxes summed separately.
+ *
+ * Each thread sums its own part of the array, and the parts are then added pairwise as a tree.
+ * Within a thread several independent sums run side by side so the loop is vectorised.
+ * Every sum is compensated, keeping the rounding error of each addition in a second term, which holds it to about
+ * twice double precision. Each endpoint is then widened by a bound on the error the compensated sum has left and
+ * rounded outwards to float, so the result encloses the true sum. This is both faster and tighter than adding the
+ * intervals with operator+=
+ *
+ * @param values The intervals to add.
+ * @param count The number of intervals.
+ * @return An interval holding the sum of every interval.
+ */
+interval intervalSum(const interval *values, size_t count);
+
+/** Interval Dot Product
+ * Multiplies two arrays of intervals element by element and adds up the products.
+ * The products of float endpoints are exact in double, so only the sums round, and those are compensated and
+ * widened as in intervalSum, so the result encloses the true dot product.
+ *
+ * @param a The first array of intervals.
+ * @param b The second array of intervals.
+ * @param count The number of intervals in each array.
+ * @return An interval holding the dot product of a and b.
+ */
+interval intervalDot(const interval *a, const interval *b, size_t count);
+
+/** Interval Norm
+ * Returns the euclidean norm of an array of intervals, the square root of the sum of their squares.
+ * An interval that contains zero has a smallest square of zero.
+ *
+ * @param values The intervals to take the norm of.
+ * @param count The number of intervals.
+ * @return An interval holding the norm.
+ */
+interval intervalNorm(const interval *values, size_t count);
+
+#endif